@@ -0,0 +1,38 @@
+/**
+ * ShitBird Native Benchmarks - shared helpers
+ *
+ * Each benchmark times a batch of items through one firmware code path and
+ * reports wall-clock ns per item and heap allocations per item.
+ */
+
+#ifndef SHITBIRD_BENCH_H
+#define SHITBIRD_BENCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <chrono>
+
+namespace Bench {
+
+// Global operator new calls since process start (alloc_counter.cpp)
+uint64_t allocCount();
+
+void printHeader();
+void report(const char* name, uint64_t items, uint64_t elapsedNs, uint64_t allocs);
+void setCsv(bool csv);
+
+// Times fn() once; fn must process `items` items.
+template <typename Fn>
+void run(const char* name, uint64_t items, Fn fn) {
+    uint64_t allocsBefore = allocCount();
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto end = std::chrono::steady_clock::now();
+    uint64_t allocs = allocCount() - allocsBefore;
+    uint64_t ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    report(name, items, ns, allocs);
+}
+
+} // namespace Bench
+
+#endif // SHITBIRD_BENCH_H
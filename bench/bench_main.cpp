@@ -0,0 +1,780 @@
+/**
+ * ShitBird Native Benchmarks
+ *
+ * Runs the hardware-independent firmware code paths (802.11 frame parsing,
+ * channel hop planning, LoRa packet analysis, BLE identification, PCAP
+ * writes, OUI lookups, wardrive logging) on the host.
+ *
+ * Usage: pio run -e native && .pio/build/native/program [-n frames] [--csv]
+ *            [--oui oui.bin] [capture.pcap]
+ */
+
+#include "bench.h"
+#include "corpus.h"
+#include "../src/core/system.h"
+#include "../src/core/storage.h"
+#include "../src/core/oui_db.h"
+#include "../src/core/wardrive_log.h"
+#include "../src/modules/wifi/wifi_module.h"
+#include "../src/modules/lora/lora_module.h"
+#include "../src/modules/ble/ble_module.h"
+#include <SD.h>
+#include <esp_partition.h>
+#include <ftw.h>
+#include <map>
+#include <random>
+#include <set>
+#include <unistd.h>
+
+// Normally defined in main.cpp
+SystemState g_systemState;
+
+// ============================================================================
+// Reporting
+// ============================================================================
+
+static bool csvOutput = false;
+
+void Bench::setCsv(bool csv) {
+    csvOutput = csv;
+}
+
+void Bench::printHeader() {
+    if (csvOutput) {
+        printf("benchmark,items,ns_per_item,allocs_per_item\n");
+    } else {
+        printf("%-36s %10s %12s %14s\n", "benchmark", "items", "ns/item", "allocs/item");
+    }
+}
+
+void Bench::report(const char* name, uint64_t items, uint64_t elapsedNs, uint64_t allocs) {
+    double nsPerItem = items ? (double)elapsedNs / items : 0;
+    double allocsPerItem = items ? (double)allocs / items : 0;
+    if (csvOutput) {
+        printf("%s,%llu,%.1f,%.2f\n", name, (unsigned long long)items, nsPerItem, allocsPerItem);
+    } else {
+        printf("%-36s %10llu %12.1f %14.2f\n", name, (unsigned long long)items, nsPerItem, allocsPerItem);
+    }
+}
+
+// ============================================================================
+// Benchmarks
+// ============================================================================
+
+static void benchWiFi(const std::vector<CorpusFrame>& frames) {
+    // Cold: tables start empty, so the run includes every first insertion
+    WiFiModule::clearResults();
+    Bench::run("wifi.parse_mgmt.cold", frames.size(), [&] {
+        for (const auto& f : frames) {
+            if (f.type == WIFI_PKT_MGMT) WiFiModule::parseManagementFrame(f.pkt());
+        }
+    });
+
+    // Warm: every transmitter is already known, only updates remain
+    Bench::run("wifi.parse_mgmt.warm", frames.size(), [&] {
+        for (const auto& f : frames) {
+            if (f.type == WIFI_PKT_MGMT) WiFiModule::parseManagementFrame(f.pkt());
+        }
+    });
+
+    // Station <-> AP edges from the data traffic
+    Bench::run("wifi.parse_data", frames.size(), [&] {
+        for (const auto& f : frames) {
+            if (f.type == WIFI_PKT_DATA) WiFiModule::parseDataFrame(f.pkt());
+        }
+    });
+
+    Serial.setMuted(false);
+    printf("  -> %u APs, %u clients tracked, %u associations\n",
+           (unsigned)WiFiModule::getAccessPoints().size(),
+           (unsigned)WiFiModule::getClients().size(),
+           (unsigned)WiFiModule::getAssociations().size());
+    Serial.setMuted(true);
+
+    // Bounded well below the corpus, so most newcomers evict an entry
+    WiFiModule::setTableBudget(64 * MacTable<APInfo>::entryBytes(), 256 * MacTable<ClientInfo>::entryBytes());
+    Bench::run("wifi.parse_mgmt.bounded", frames.size(), [&] {
+        for (const auto& f : frames) {
+            if (f.type == WIFI_PKT_MGMT) WiFiModule::parseManagementFrame(f.pkt());
+        }
+    });
+
+    TableStats apTable = WiFiModule::getAPTableStats();
+    TableStats clientTable = WiFiModule::getClientTableStats();
+    Serial.setMuted(false);
+    printf("  -> %u/%u APs, %u/%u clients; %u and %u evicted\n",
+           (unsigned)apTable.size, (unsigned)apTable.capacity,
+           (unsigned)clientTable.size, (unsigned)clientTable.capacity,
+           (unsigned)apTable.evicted, (unsigned)clientTable.evicted);
+    Serial.setMuted(true);
+    WiFiModule::setTableBudget(0, 0);
+}
+
+// Same copy the promiscuous callback does, then a batched drain as the
+// parser task does it
+static void benchRxRing(const std::vector<CorpusFrame>& frames) {
+    static SpscRing<WiFiRxFrame, WIFI_RX_RING_SLOTS> ring;
+    ring.reset();
+
+    auto drain = [] {
+        const WiFiRxFrame* frame;
+        while ((frame = ring.front()) != nullptr) {
+            if (frame->type == WIFI_PKT_MGMT) {
+                WiFiModule::parseManagementFrame(frame->pkt());
+            } else if (frame->type == WIFI_PKT_DATA) {
+                WiFiModule::parseDataFrame(frame->pkt());
+            }
+            ring.pop();
+        }
+    };
+
+    Bench::run("wifi.rx_ring.enqueue_parse", frames.size(), [&] {
+        for (const auto& f : frames) {
+            WiFiRxFrame* slot = ring.acquire();
+            if (!slot) {
+                drain();
+                slot = ring.acquire();
+            }
+            uint16_t len = std::min<uint16_t>(f.length(), WIFI_RX_SNAPLEN);
+            slot->type = f.type;
+            slot->origLen = f.length();
+            slot->rx_ctrl = f.pkt()->rx_ctrl;
+            slot->rx_ctrl.sig_len = len;
+            memcpy(slot->payload, f.payload(), len);
+            ring.publish();
+        }
+        drain();
+    });
+}
+
+// Spoofed-source deauth flood at one BSSID, the case the WIDS counters must
+// keep up with
+static void benchWids(size_t count) {
+    DeauthDetector& wids = WiFiModule::getDeauthDetector();
+    wids.reset();
+    MacAddr bssid = MacAddr::fromString("02:11:22:33:44:55");
+
+    Bench::run("wifi.wids.record_flood", count, [&] {
+        for (size_t i = 0; i < count; i++) {
+            MacAddr source((uint64_t)i * 0x9E3779B97F4A7C15ULL);
+            wids.record(bssid, source, WIFI_MGMT_DEAUTH, 7, 6, -50, (uint32_t)(i / 500));
+        }
+    });
+    WidsEvent events[WIDS_MAX_EVENTS];
+    size_t n = wids.getEvents(events, WIDS_MAX_EVENTS);
+    Serial.setMuted(false);
+    printf("  -> %u events open, first counted %lu frames\n",
+           (unsigned)n, n ? (unsigned long)events[0].frames : 0UL);
+    Serial.setMuted(true);
+    wids.reset();
+}
+
+// Airtime accounting per frame, with the radio hopping 1/6/11 every 100 ms
+// of simulated time. Channel 1 hears a frame every 1 ms, 6 every 4 ms and
+// 11 every 2 ms, so 6 should come out as the recommendation.
+static void benchAirtime(const std::vector<CorpusFrame>& frames) {
+    AirtimeMonitor& airtime = WiFiModule::getAirtime();
+    airtime.reset();
+    static const uint8_t HOPS[] = {1, 6, 11};
+    static const uint8_t SPACING_MS[] = {1, 4, 2};
+
+    uint32_t now = 0;
+    Bench::run("wifi.airtime.record", frames.size(), [&] {
+        for (size_t i = 0; i < frames.size(); i++) {
+            uint8_t hop = (i / 100) % 3;
+            if (i % 100 == 0) airtime.tune(HOPS[hop], now);
+            wifi_pkt_rx_ctrl_t rx = frames[i].pkt()->rx_ctrl;
+            rx.channel = HOPS[hop];
+            airtime.recordFrame(rx, frames[i].length(), now);
+            now += SPACING_MS[hop];
+        }
+    });
+
+    uint32_t end = now;
+    ChannelUtilization usage[AirtimeMonitor::MAX_CHANNEL + 1];
+    airtime.getUtilization(usage, end);
+    uint8_t best = airtime.recommend(CHANNELS_NON_OVERLAP, end);
+    Serial.setMuted(false);
+    printf("  -> airtime ch1 %.1f%%, ch6 %.1f%%, ch11 %.1f%%; recommended ch %u\n",
+           usage[1].airtimePct, usage[6].airtimePct, usage[11].airtimePct, best);
+    Serial.setMuted(true);
+    airtime.reset();
+}
+
+// Ten minutes of hop plans with traffic on 1/6/11 (400, 150 and 250
+// frames/s) and a trickle of 5 frames/s elsewhere. Revisiting ten quiet
+// channels for WIFI_HOP_MIN_DWELL each every WIFI_HOP_MAX_REVISIT caps the
+// busy three at about two thirds of the time; they should get close to
+// that, and no channel may go unvisited much past the revisit limit.
+static bool benchHop() {
+    static const uint16_t FRAMES_PER_SEC[] = {0, 400, 5, 5, 5, 5, 150, 5, 5, 5, 5, 250, 5, 5};
+    const uint32_t DURATION_MS = 10 * 60000;
+
+    ChannelScheduler scheduler;
+    uint32_t dwellTotal[ChannelScheduler::MAX_CHANNEL + 1] = {};
+    uint32_t lastLeft[ChannelScheduler::MAX_CHANNEL + 1] = {};
+    uint32_t maxGap = 0;
+    uint64_t hops = 0;
+
+    uint32_t now = 0;
+    while (now < DURATION_MS) {
+        uint16_t dwellMs;
+        uint8_t ch = scheduler.next(now, &dwellMs);
+        if (now - lastLeft[ch] > maxGap) maxGap = now - lastLeft[ch];
+
+        uint32_t frames = (uint32_t)FRAMES_PER_SEC[ch] * dwellMs / 1000;
+        for (uint32_t i = 0; i < frames; i++) scheduler.recordFrame(ch);
+
+        now += dwellMs;
+        dwellTotal[ch] += dwellMs;
+        lastLeft[ch] = now;
+        hops++;
+    }
+    for (uint8_t ch = 1; ch <= 13; ch++) {
+        if (now - lastLeft[ch] > maxGap) maxGap = now - lastLeft[ch];
+    }
+
+    float busyPct = 100.0f * (dwellTotal[1] + dwellTotal[6] + dwellTotal[11]) / now;
+    Serial.setMuted(false);
+    printf("  -> hop: %llu hops, 1/6/11 had %.1f%% of dwell, longest unvisited %lu ms\n",
+           (unsigned long long)hops, busyPct, (unsigned long)maxGap);
+    Serial.setMuted(true);
+
+    bool ok = busyPct >= 60.0f && maxGap <= WIFI_HOP_MAX_REVISIT + WIFI_HOP_MAX_DWELL;
+    if (!ok) fprintf(stderr, "Hop check failed: %.1f%% on 1/6/11, %lu ms unvisited\n", busyPct, (unsigned long)maxGap);
+    return ok;
+}
+
+static void benchLoRa(size_t count) {
+    auto raw = Corpus::loraPackets(count, 40);
+    std::vector<LoRaPacket> packets(raw.size());
+    for (size_t i = 0; i < raw.size(); i++) {
+        packets[i].data = raw[i];
+        packets[i].length = raw[i].size();
+    }
+
+    Bench::run("lora.identify_decode", packets.size(), [&] {
+        for (auto& p : packets) {
+            p.type = LoRaModule::identifyPacket(p.data.data(), p.data.size());
+            if (p.type == LoRaPacketType::MESHTASTIC) {
+                p.decoded = LoRaModule::decodeMeshtasticPacket(p);
+            }
+        }
+    });
+}
+
+static bool benchBLE(size_t count) {
+    auto reports = Corpus::bleAdvertisements(count, 400);
+    BLEModule::clearDevices();
+
+    // What the scan worker does per report: table lookup, AD copy, and
+    // identification the first time an address is seen
+    Bench::run("ble.record_adv", reports.size(), [&] {
+        for (const auto& r : reports) {
+            BLEModule::recordAdvertisement(r.addr, r.rssi, r.connectable,
+                                           r.payload.data(), r.payload.size(), millis());
+        }
+    });
+
+    auto& devices = BLEModule::getDevices();
+    Bench::run("ble.identify_device", devices.size(), [&] {
+        for (auto& d : devices) {
+            BLEModule::identifyDevice(d);
+        }
+    });
+
+    size_t trackers = 0;
+    size_t unknown = 0;
+    for (const auto& d : devices) {
+        trackers += d.isTracker;
+        unknown += strcmp(d.deviceType, "Unknown") == 0;
+    }
+    Serial.setMuted(false);
+    printf("  -> %u devices, %u trackers, %u unknown, %u built-in fingerprints\n",
+           (unsigned)devices.size(), (unsigned)trackers, (unsigned)unknown,
+           (unsigned)BLEFingerprintDb::getBuiltinCount());
+    Serial.setMuted(true);
+
+    // Rules from the card: the bad line is skipped, the good one re-identifies
+    // every battery-service device already in the table
+    Storage::writeFile(BLE_FINGERPRINT_FILE,
+                       "# bench\n"
+                       "service,180F,,,,,tracker,Bench Battery\n"
+                       "service,18,,,,,,Bad Id\n");
+    int loaded = BLEModule::loadFingerprints();
+    size_t expected = 0;
+    size_t wrong = 0;
+    const char* sdType = nullptr;
+    for (const auto& d : devices) {
+        if (!d.hasService(0x180F)) continue;
+        expected++;
+        if (!d.isTracker) wrong++;
+        if (strcmp(d.deviceType, "Bench Battery") == 0) sdType = d.deviceType;
+    }
+    // Types named by SD rules outlive the rules
+    BLEFingerprintDb::unload();
+    if (!sdType || strcmp(sdType, "Bench Battery") != 0) wrong++;
+    for (auto& d : devices) BLEModule::identifyDevice(d);
+
+    bool ok = loaded == 1 && expected > 0 && wrong == 0;
+    if (!ok) {
+        fprintf(stderr, "Fingerprint load check failed: %d rules loaded, %u/%u battery devices wrong\n",
+                loaded, (unsigned)wrong, (unsigned)expected);
+    }
+    return ok;
+}
+
+// A walk of 40 minutes, 100 m a minute. One Find My tag rides along,
+// changing its key and address together every 15 minutes, so only the
+// clusterer ties its trail together; a Tile stays at the start; a one-off
+// tag passes every step as at a station. Only the tag riding along should
+// alert.
+static bool benchTrackers() {
+    TrackerMonitor& monitor = BLEModule::getTrackerMonitor();
+    BLEClusterer& clusterer = BLEModule::getClusterer();
+    monitor.reset();
+    clusterer.reset();
+
+    // What processReport() does with a tracker's report
+    auto observe = [&](const BLEAddr& addr, const std::vector<uint8_t>& p, int8_t rssi,
+                       const char* type, uint32_t now) {
+        uint32_t identity = clusterer.observe(addr, p.data(), p.size(), rssi, type, now);
+        monitor.observe(identity, addr, rssi, type, now);
+    };
+
+    auto findMy = [](uint32_t key, std::vector<uint8_t>& p) {
+        p = {30, BLEAd::TYPE_MANUFACTURER, 0x4C, 0x00, 0x12, 0x19, 0x10};
+        for (int b = 0; b < 22; b++) p.push_back((uint8_t)(key >> (b % 4 * 8)) + b);
+        p.push_back(0x00);
+        p.push_back(0x00);
+    };
+    std::vector<uint8_t> follower;
+    std::vector<uint8_t> tile = {3, BLEAd::TYPE_UUID16_COMPLETE, 0xED, 0xFE};
+    std::vector<uint8_t> passer;
+    BLEAddr tileAddr(MacAddr::fromString("E0:11:22:33:44:55"), 1);
+
+    const uint32_t STEP_MS = 2000;
+    const uint32_t STEPS = 40 * 60000 / STEP_MS;
+    WardriveFix fix = {true, 51.5, -0.12, 30.0f, 5.0f, 0};
+    uint32_t now = 0;
+    Bench::run("ble.tracker_observe", STEPS * 3, [&] {
+        for (uint32_t i = 0; i < STEPS; i++) {
+            now += STEP_MS;
+            fix.latitude = 51.5 + now / 60000.0 * 100 / 111195.0;
+            monitor.setPosition(fix);
+
+            uint32_t epoch = now / (15 * 60000);
+            findMy(0xA11CE000 + epoch, follower);
+            BLEAddr followerAddr(MacAddr(0x400000000000ULL + epoch), 1);
+            observe(followerAddr, follower, -60, "Apple AirTag", now);
+
+            if (now < 3 * 60000) {
+                observe(tileAddr, tile, -70, "Tile Tracker", now);
+            }
+
+            findMy(0x5000 + i, passer);
+            BLEAddr passerAddr(MacAddr(0x500000000000ULL + i), 1);
+            observe(passerAddr, passer, -80, "Apple AirTag", now);
+        }
+    });
+    monitor.poll();
+
+    TrackerAlert alerts[TRACKER_MAX_ALERTS];
+    size_t n = monitor.getAlerts(alerts, TRACKER_MAX_ALERTS);
+    TrackerPoint trail[TRACKER_TRAIL_POINTS];
+    size_t points = n ? monitor.getTrail(alerts[0].identity, trail, TRACKER_TRAIL_POINTS) : 0;
+
+    Serial.setMuted(false);
+    printf("  -> %u alerts, first at %u places over %lu min, %u trail points, %u tracked, %lu evicted\n",
+           (unsigned)n, n ? alerts[0].locations : 0, n ? (unsigned long)(alerts[0].followedMs / 60000) : 0UL,
+           (unsigned)points, (unsigned)monitor.getTrackedCount(), (unsigned long)monitor.getEvicted());
+    Serial.setMuted(true);
+
+    // Followed across both rotations, not just since the last
+    bool ok = n == 1 && alerts[0].locations >= TRACKER_ALERT_LOCATIONS && points == TRACKER_TRAIL_POINTS &&
+              alerts[0].followedMs >= 35 * 60000 && monitor.getTrackedCount() <= TRACKER_MAX_DEVICES;
+    if (!ok) fprintf(stderr, "Tracker check failed: %u alerts\n", (unsigned)n);
+    monitor.reset();
+    clusterer.reset();
+    return ok;
+}
+
+// An hour in a busy room: 80 phones and tags on private addresses that
+// rotate every 15 minutes (staggered) and 20 on fixed addresses; 20 of the
+// phones leave at 25 minutes and 20 others arrive at 35. Each reports every two
+// seconds with a few dB of noise. The unique count at the end should be
+// close to the 100 devices there, not the addresses they went through.
+static bool benchClusters() {
+    BLEClusterer& clusterer = BLEModule::getClusterer();
+    clusterer.reset();
+    std::mt19937 rng(0xC105);
+
+    struct Device {
+        int kind;
+        int rssi;
+        uint32_t offsetMs;      // Into its rotation period
+        uint32_t arrive;
+        uint32_t leave;
+        bool fixed;
+        uint64_t mac;
+        uint32_t epoch;
+        std::vector<uint8_t> payload;
+    };
+
+    // Private address with the top bits 01 (resolvable)
+    auto privateMac = [&rng]() {
+        return ((((uint64_t)rng() << 16) ^ rng()) & 0x3FFFFFFFFFFFULL) | 0x400000000000ULL;
+    };
+    auto makePayload = [&rng](int kind, std::vector<uint8_t>& p) {
+        switch (kind) {
+            case 0:  // Apple Nearby Info
+                p = {2, BLEAd::TYPE_FLAGS, 0x1A, 10, BLEAd::TYPE_MANUFACTURER, 0x4C, 0x00, 0x10, 0x05,
+                     (uint8_t)rng(), (uint8_t)rng(), (uint8_t)rng(), (uint8_t)rng(), (uint8_t)rng()};
+                break;
+            case 1:  // Find My
+                p = {30, BLEAd::TYPE_MANUFACTURER, 0x4C, 0x00, 0x12, 0x19, 0x10};
+                for (int b = 0; b < 24; b++) p.push_back((uint8_t)rng());
+                break;
+            case 2:  // Samsung with TX power
+                p = {2, BLEAd::TYPE_FLAGS, 0x06, 2, BLEAd::TYPE_TX_POWER, 0xF4, 7, BLEAd::TYPE_MANUFACTURER,
+                     0x75, 0x00, 0x42, (uint8_t)rng(), (uint8_t)rng(), (uint8_t)rng()};
+                break;
+            default:  // Fast Pair service data
+                p = {3, BLEAd::TYPE_UUID16_COMPLETE, 0x2C, 0xFE, 6, BLEAd::TYPE_SERVICE_DATA16, 0x2C, 0xFE,
+                     (uint8_t)rng(), (uint8_t)rng(), (uint8_t)rng()};
+                break;
+        }
+    };
+
+    const uint32_t HOUR = 60 * 60000;
+    const uint32_t ROTATE_MS = 15 * 60000;
+    // 0-79 private, 60-79 of them leaving; 80-99 fixed; 100-119 arriving
+    std::vector<Device> devices(120);
+    for (size_t i = 0; i < devices.size(); i++) {
+        Device& d = devices[i];
+        d.kind = rng() % 4;
+        d.rssi = -45 - (int)(rng() % 50);
+        d.offsetMs = rng() % ROTATE_MS;
+        d.fixed = i >= 80 && i < 100;
+        d.arrive = i >= 100 ? 35 * 60000 : 0;
+        d.leave = i >= 60 && i < 80 ? 25 * 60000 : HOUR;
+        d.mac = d.fixed ? 0x001122000000ULL + i : privateMac();
+        d.epoch = 0;
+        makePayload(d.kind, d.payload);
+    }
+
+    const uint32_t STEP_MS = 2000;
+    std::set<uint64_t> addresses;
+    uint64_t reports = 0;
+    uint64_t expected = 0;
+    for (const auto& d : devices) expected += (min(d.leave, HOUR + 1) - max(d.arrive, STEP_MS) + STEP_MS - 1) / STEP_MS;
+    Bench::run("ble.cluster_observe", expected, [&] {
+        for (uint32_t now = STEP_MS; now <= HOUR; now += STEP_MS) {
+            for (auto& d : devices) {
+                if (now < d.arrive || now >= d.leave) continue;
+                uint32_t epoch = (now + d.offsetMs) / ROTATE_MS;
+                if (!d.fixed && epoch != d.epoch) {
+                    d.epoch = epoch;
+                    d.mac = privateMac();
+                    makePayload(d.kind, d.payload);
+                }
+                BLEAddr addr(MacAddr(d.mac), d.fixed ? 0 : 1);
+                addresses.insert(addr.value);
+                int rssi = d.rssi + (int)(rng() % 5) - 2;
+                clusterer.observe(addr, d.payload.data(), d.payload.size(), (int8_t)rssi, "Bench", now);
+                reports++;
+            }
+        }
+    });
+
+    size_t present = clusterer.getPresentCount(HOUR);
+    BLEClusterStats stats = clusterer.getStats();
+    Serial.setMuted(false);
+    printf("  -> %u unique of 100 present, %u addresses seen, %lu links, %lu splits, %lu evicted, %llu reports\n",
+           (unsigned)present, (unsigned)addresses.size(), (unsigned long)stats.links,
+           (unsigned long)stats.splits, (unsigned long)stats.evicted, (unsigned long long)reports);
+    Serial.setMuted(true);
+
+    bool ok = present >= 90 && present <= 110 && stats.addresses <= BLE_CLUSTER_ADDRS;
+    if (!ok) fprintf(stderr, "Cluster check failed: %u unique devices, expected ~100\n", (unsigned)present);
+    clusterer.reset();
+    return ok;
+}
+
+static void benchPcap(const std::vector<CorpusFrame>& frames) {
+    const char* path = "/pcap/bench_path.pcap";
+    Storage::createPcapFile(path);
+
+    // Path-based Storage API: open, append and close per frame
+    Bench::run("pcap.write.open_per_frame", frames.size(), [&] {
+        for (const auto& f : frames) {
+            Storage::writePcapPacket(path, f.payload(), f.length());
+        }
+    });
+
+    const char* handlePath = "/pcap/bench_handle.pcap";
+    Storage::createPcapFile(handlePath);
+    File file = SD.open(handlePath, FILE_APPEND);
+
+    Bench::run("pcap.write.persistent_handle", frames.size(), [&] {
+        for (const auto& f : frames) {
+            Storage::writePcapPacket(file, f.payload(), f.length());
+        }
+        file.flush();
+    });
+    file.close();
+}
+
+// Maps the image through the partition API as the firmware does, checks every
+// record and a spread of unregistered OUIs, then times lookups. The image is
+// a synthetic one unless a real one from tools/build_oui.py is given.
+static bool benchOui(const char* imagePath, const char* scratchDir, size_t count) {
+    std::string path;
+    if (imagePath) {
+        path = imagePath;
+    } else {
+        path = std::string(scratchDir) + "/oui.bin";
+        std::vector<uint8_t> image = Corpus::ouiImage(40000);
+        FILE* f = fopen(path.c_str(), "wb");
+        if (!f || fwrite(image.data(), 1, image.size(), f) != image.size()) {
+            fprintf(stderr, "Cannot write %s\n", path.c_str());
+            if (f) fclose(f);
+            return false;
+        }
+        fclose(f);
+    }
+
+    esp_partition_shim_add(ESP_PARTITION_TYPE_DATA, OUI_PARTITION_SUBTYPE, OUI_PARTITION_LABEL, path.c_str());
+    if (!OuiDb::init()) {
+        fprintf(stderr, "Cannot map OUI image: %s\n", path.c_str());
+        return false;
+    }
+
+    // Reference copy read straight from the file
+    std::map<uint32_t, std::string> expected;
+    FILE* f = fopen(path.c_str(), "rb");
+    uint8_t header[OUI_DB_HEADER_SIZE];
+    if (!f || fread(header, 1, sizeof(header), f) != sizeof(header)) {
+        fprintf(stderr, "Cannot read %s\n", path.c_str());
+        if (f) fclose(f);
+        return false;
+    }
+    uint16_t stride = header[8] | (header[9] << 8);
+    std::vector<uint8_t> rec(stride);
+    while (fread(rec.data(), 1, stride, f) == stride) {
+        uint32_t oui = (rec[0] << 16) | (rec[1] << 8) | rec[2];
+        expected[oui] = std::string((const char*)rec.data() + 3, strnlen((const char*)rec.data() + 3, stride - 3));
+    }
+    fclose(f);
+
+    size_t errors = 0;
+    for (const auto& e : expected) {
+        const char* name = OuiDb::lookup(e.first);
+        if (!name || e.second != name) errors++;
+    }
+    for (uint32_t oui = 0; oui <= 0xFFFFFF; oui += 0x1F3) {
+        if (!expected.count(oui) && OuiDb::lookup(oui)) errors++;
+    }
+    if (errors || OuiDb::getCount() != expected.size()) {
+        fprintf(stderr, "OUI lookup check failed: %u errors, %u of %u records mapped\n",
+                (unsigned)errors, (unsigned)OuiDb::getCount(), (unsigned)expected.size());
+        return false;
+    }
+
+    // Half registered vendors, half misses, as a mixed scan would see
+    std::vector<uint32_t> keys;
+    keys.reserve(count);
+    auto it = expected.begin();
+    for (size_t i = 0; i < count; i++) {
+        if (i & 1) {
+            keys.push_back((uint32_t)(i * 2654435761u) & 0xFFFFFF);
+        } else {
+            if (++it == expected.end()) it = expected.begin();
+            keys.push_back(it->first);
+        }
+    }
+
+    size_t hits = 0;
+    Bench::run("oui.lookup", keys.size(), [&] {
+        for (uint32_t oui : keys) {
+            if (OuiDb::lookup(oui)) hits++;
+        }
+    });
+
+    Serial.setMuted(false);
+    printf("  -> %u vendors, %u/%u hits\n",
+           (unsigned)expected.size(), (unsigned)hits, (unsigned)keys.size());
+    Serial.setMuted(true);
+
+    OuiDb::deinit();
+    return true;
+}
+
+// Replays the beacon stream through the parser with a wardrive session
+// running and the position creeping along, then checks the CSV: one row per
+// BSSID carrying its best RSSI, a row only for sightings that improved on
+// it, and nothing new when the same stream is replayed.
+static bool benchWardrive(const std::vector<CorpusFrame>& frames, const char* scratchDir) {
+    const char* path = PATH_WARDRIVE "/bench.csv";
+    WiFiModule::clearResults();
+    if (!WardriveLog::start(path)) {
+        fprintf(stderr, "Cannot start wardrive session\n");
+        return false;
+    }
+
+    // What the log should end up holding; probe responses are parsed as
+    // beacons, so they count too
+    std::map<uint64_t, int8_t> best;
+    size_t beacons = 0;
+    size_t improvements = 0;
+    for (const auto& f : frames) {
+        if (f.type != WIFI_PKT_MGMT) continue;
+        uint8_t subtype = f.payload()[0] & 0xFC;
+        if (subtype != WIFI_MGMT_BEACON && subtype != WIFI_MGMT_PROBE_RESP) continue;
+        beacons++;
+        uint64_t bssid = MacAddr::fromBytes(&f.payload()[16]).value;
+        int8_t rssi = f.pkt()->rx_ctrl.rssi;
+        auto it = best.find(bssid);
+        if (it == best.end()) {
+            best[bssid] = rssi;
+            improvements++;
+        } else if (rssi > it->second) {
+            it->second = rssi;
+            improvements++;
+        }
+    }
+
+    WardriveFix fix = {true, 51.5, -0.12, 30.0f, 5.0f, 1700000000};
+    auto replay = [&] {
+        for (size_t i = 0; i < frames.size(); i++) {
+            if (i % 1000 == 0) {
+                fix.latitude += 0.0001;
+                fix.time++;
+                WardriveLog::setPosition(fix);
+            }
+            if (frames[i].type == WIFI_PKT_MGMT) WiFiModule::parseManagementFrame(frames[i].pkt());
+        }
+    };
+
+    Bench::run("wardrive.parse_mgmt", frames.size(), replay);
+    bool ok = WardriveLog::flush();
+    WardriveStats first = WardriveLog::getStats();
+
+    // Every BSSID is known and at its best now: a replay adds no rows
+    replay();
+    ok &= WardriveLog::flush();
+    WardriveStats second = WardriveLog::getStats();
+    WardriveLog::stop();
+
+    // Read the CSV back: two header lines, then MAC first and RSSI sixth
+    std::string hostPath = std::string(scratchDir) + path;
+    FILE* f = fopen(hostPath.c_str(), "rb");
+    if (!f) {
+        fprintf(stderr, "Cannot read %s\n", hostPath.c_str());
+        return false;
+    }
+    std::map<uint64_t, int> rows;
+    size_t lines = 0;
+    size_t mismatched = 0;
+    char line[512];
+    while (fgets(line, sizeof(line), f)) {
+        if (++lines <= 2) continue;
+        // Only the SSID can hold a comma, so count back from the end
+        const char* field = nullptr;
+        int commas = 0;
+        for (const char* p = line + strlen(line); p > line && !field; p--) {
+            if (p[-1] == ',' && ++commas == 6) field = p;
+        }
+        uint64_t bssid = MacAddr::fromString(std::string(line, 17).c_str()).value;
+        rows[bssid]++;
+        if (!field || !best.count(bssid) || atoi(field) != best[bssid]) mismatched++;
+    }
+    long size = ftell(f);
+    fclose(f);
+
+    size_t dataLines = lines > 2 ? lines - 2 : 0;
+    ok &= dataLines == best.size() && rows.size() == best.size() && mismatched == 0;
+    ok &= first.rowsWritten == best.size() && first.improved == improvements;
+    ok &= second.rowsWritten == first.rowsWritten && second.improved == first.improved;
+    ok &= (uint32_t)size == second.bytesWritten;
+
+    Serial.setMuted(false);
+    printf("  -> %u beacons, %u improved, %u rows, %ld bytes, flush %u us\n",
+           (unsigned)beacons, (unsigned)first.improved, (unsigned)dataLines, size,
+           (unsigned)first.maxFlushUs);
+    Serial.setMuted(true);
+
+    if (!ok) {
+        fprintf(stderr, "Wardrive check failed: %u BSSIDs, %u lines (%u distinct, %u wrong RSSI), "
+                "%u/%u rows, %u/%u improved, %ld/%u bytes\n",
+                (unsigned)best.size(), (unsigned)dataLines, (unsigned)rows.size(), (unsigned)mismatched,
+                (unsigned)first.rowsWritten, (unsigned)second.rowsWritten,
+                (unsigned)first.improved, (unsigned)improvements, size, (unsigned)second.bytesWritten);
+    }
+    return ok;
+}
+
+// ============================================================================
+// Entry point
+// ============================================================================
+
+static int removeEntry(const char* path, const struct stat*, int, struct FTW*) {
+    return ::remove(path);
+}
+
+int main(int argc, char** argv) {
+    size_t frameCount = 200000;
+    const char* pcapPath = nullptr;
+    const char* ouiPath = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            frameCount = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--csv") == 0) {
+            Bench::setCsv(true);
+        } else if (strcmp(argv[i], "--oui") == 0 && i + 1 < argc) {
+            ouiPath = argv[++i];
+        } else {
+            pcapPath = argv[i];
+        }
+    }
+
+    std::vector<CorpusFrame> frames;
+    if (pcapPath) {
+        if (!Corpus::loadPcap(pcapPath, frames)) {
+            fprintf(stderr, "Cannot load 802.11 capture: %s\n", pcapPath);
+            return 1;
+        }
+        fprintf(stderr, "Loaded %u frames from %s\n", (unsigned)frames.size(), pcapPath);
+    } else {
+        frames = Corpus::wifiFrames(frameCount, 300, 2000);
+    }
+
+    // Storage runs against a scratch directory standing in for the SD card
+    char sdRoot[] = "/tmp/shitbird-sd-XXXXXX";
+    if (!mkdtemp(sdRoot)) {
+        perror("mkdtemp");
+        return 1;
+    }
+    SD.setRoot(sdRoot);
+    Serial.setMuted(true);
+    Storage::init();
+
+    Bench::printHeader();
+    benchWiFi(frames);
+    benchRxRing(frames);
+    benchWids(frameCount);
+    benchAirtime(frames);
+    benchLoRa(frameCount / 4);
+    bool hopOk = benchHop();
+    bool bleOk = benchBLE(frameCount / 4);
+    bool trackerOk = benchTrackers();
+    bool clusterOk = benchClusters();
+    benchPcap(frames);
+    bool wardriveOk = benchWardrive(frames, sdRoot);
+    bool ouiOk = benchOui(ouiPath, sdRoot, frameCount);
+
+    Storage::deinit();
+    nftw(sdRoot, removeEntry, 16, FTW_DEPTH | FTW_PHYS);
+    return hopOk && bleOk && trackerOk && clusterOk && wardriveOk && ouiOk ? 0 : 1;
+}
@@ -0,0 +1,392 @@
+/**
+ * ShitBird Native Benchmarks - frame corpus
+ */
+
+#include "corpus.h"
+#include "../src/modules/wifi/wifi_module.h"
+#include "../src/core/oui_db.h"
+#include <random>
+#include <set>
+
+namespace {
+
+// Vendor OUIs commonly seen on APs and phones
+const uint8_t OUIS[][3] = {
+    {0x00, 0x1A, 0x2B}, {0x3C, 0x37, 0x86}, {0xF0, 0x9F, 0xC2}, {0x00, 0x24, 0x6C},
+    {0xAC, 0x84, 0xC6}, {0x70, 0x3A, 0xCB}, {0x00, 0x0C, 0x42}, {0x44, 0xD9, 0xE7},
+    {0x28, 0x6D, 0x97}, {0xB8, 0x27, 0xEB}, {0xDC, 0xA6, 0x32}, {0x9C, 0x3D, 0xCF},
+};
+
+// A handful of SSIDs dominate real venues
+const char* SSIDS[] = {
+    "xfinitywifi", "eduroam", "CorpNet", "CorpNet-Guest", "ATT-WIFI-5521",
+    "NETGEAR42", "linksys", "Starbucks WiFi", "HOME-7F21", "SpectrumSetup-A4",
+    "TP-Link_2.4GHz_19C2", "DIRECT-roku-551", "Free Public WiFi", "Pixel_4417",
+};
+const int SSID_COUNT = sizeof(SSIDS) / sizeof(SSIDS[0]);
+
+const uint8_t CHANNELS[] = {1, 6, 11, 1, 6, 11, 1, 6, 11, 3, 4, 9, 13};
+
+struct Station {
+    uint8_t mac[6];
+    uint8_t channel;
+    int8_t rssi;
+    const char* ssid;
+    bool rsn;
+};
+
+class FrameBuilder {
+public:
+    std::vector<uint8_t> buf;
+
+    explicit FrameBuilder(size_t reserve = 320) { buf.reserve(reserve); }
+
+    void u8(uint8_t v) { buf.push_back(v); }
+    void u16(uint16_t v) { u8(v & 0xFF); u8(v >> 8); }
+    void bytes(const uint8_t* p, size_t n) { buf.insert(buf.end(), p, p + n); }
+    void fill(uint8_t v, size_t n) { buf.insert(buf.end(), n, v); }
+
+    void header(uint8_t fc0, uint8_t fc1, const uint8_t* a1, const uint8_t* a2, const uint8_t* a3, uint16_t seq) {
+        u8(fc0); u8(fc1);
+        u16(0);
+        bytes(a1, 6); bytes(a2, 6); bytes(a3, 6);
+        u16(seq << 4);
+    }
+
+    void tag(uint8_t id, const uint8_t* data, uint8_t len) {
+        u8(id); u8(len);
+        bytes(data, len);
+    }
+
+    void ssidTag(const char* ssid) { tag(0, (const uint8_t*)ssid, (uint8_t)strlen(ssid)); }
+
+    void ratesTags() {
+        static const uint8_t rates[] = {0x82, 0x84, 0x8B, 0x96, 0x0C, 0x12, 0x18, 0x24};
+        static const uint8_t ext[] = {0x30, 0x48, 0x60, 0x6C};
+        tag(1, rates, sizeof(rates));
+        tag(50, ext, sizeof(ext));
+    }
+
+    void apTags(const Station& ap) {
+        ssidTag(ap.ssid);
+        ratesTags();
+        tag(3, &ap.channel, 1);
+        static const uint8_t tim[] = {0x00, 0x01, 0x00, 0x00};
+        tag(5, tim, sizeof(tim));
+        static const uint8_t country[] = {'U', 'S', ' ', 0x01, 0x0B, 0x1E};
+        tag(7, country, sizeof(country));
+        static const uint8_t htCap[26] = {0xEF, 0x19, 0x1B, 0xFF, 0xFF};
+        tag(45, htCap, sizeof(htCap));
+        if (ap.rsn) {
+            static const uint8_t rsn[] = {
+                0x01, 0x00, 0x00, 0x0F, 0xAC, 0x04, 0x01, 0x00, 0x00, 0x0F, 0xAC, 0x04,
+                0x01, 0x00, 0x00, 0x0F, 0xAC, 0x02, 0x0C, 0x00
+            };
+            tag(48, rsn, sizeof(rsn));
+        }
+        uint8_t htInfo[22] = {0};
+        htInfo[0] = ap.channel;
+        tag(61, htInfo, sizeof(htInfo));
+        static const uint8_t extCap[] = {0x04, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x40};
+        tag(127, extCap, sizeof(extCap));
+        static const uint8_t wmm[] = {
+            0x00, 0x50, 0xF2, 0x02, 0x01, 0x01, 0x80, 0x00, 0x03, 0xA4, 0x00, 0x00,
+            0x27, 0xA4, 0x00, 0x00, 0x42, 0x43, 0x5E, 0x00, 0x62, 0x32, 0x2F, 0x00
+        };
+        tag(221, wmm, sizeof(wmm));
+        static const uint8_t wps[] = {0x00, 0x50, 0xF2, 0x04, 0x10, 0x4A, 0x00, 0x01, 0x10, 0x10, 0x44, 0x00, 0x01, 0x02};
+        tag(221, wps, sizeof(wps));
+    }
+
+    CorpusFrame finish(int type, int8_t rssi, uint8_t channel) {
+        fill(0, 4);  // FCS, included in sig_len by the driver
+
+        CorpusFrame frame;
+        frame.type = (wifi_promiscuous_pkt_type_t)type;
+        frame.raw.resize(sizeof(wifi_pkt_rx_ctrl_t) + buf.size());
+        wifi_pkt_rx_ctrl_t ctrl = {};
+        ctrl.rssi = rssi;
+        ctrl.rate = 11;
+        ctrl.channel = channel;
+        ctrl.noise_floor = -95;
+        ctrl.sig_len = buf.size();
+        memcpy(frame.raw.data(), &ctrl, sizeof(ctrl));
+        memcpy(frame.raw.data() + sizeof(ctrl), buf.data(), buf.size());
+        return frame;
+    }
+};
+
+void randomMac(std::mt19937& rng, uint8_t* mac, bool randomized) {
+    if (randomized) {
+        for (int i = 0; i < 6; i++) mac[i] = rng() & 0xFF;
+        mac[0] = (mac[0] & 0xFC) | 0x02;  // Locally administered, unicast
+    } else {
+        const uint8_t* oui = OUIS[rng() % (sizeof(OUIS) / sizeof(OUIS[0]))];
+        memcpy(mac, oui, 3);
+        for (int i = 3; i < 6; i++) mac[i] = rng() & 0xFF;
+    }
+}
+
+} // namespace
+
+std::vector<CorpusFrame> Corpus::wifiFrames(size_t count, unsigned apCount, unsigned clientCount) {
+    std::mt19937 rng(0xB1BD);
+    static const uint8_t BROADCAST[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+    std::vector<Station> aps(apCount);
+    for (auto& ap : aps) {
+        randomMac(rng, ap.mac, false);
+        ap.channel = CHANNELS[rng() % sizeof(CHANNELS)];
+        ap.rssi = -30 - (int8_t)(rng() % 60);
+        ap.ssid = (rng() % 10 == 0) ? "" : SSIDS[rng() % SSID_COUNT];
+        ap.rsn = (rng() % 5) != 0;
+    }
+
+    std::vector<Station> stations(clientCount);
+    for (auto& sta : stations) {
+        randomMac(rng, sta.mac, rng() % 2 == 0);
+        sta.channel = CHANNELS[rng() % sizeof(CHANNELS)];
+        sta.rssi = -40 - (int8_t)(rng() % 50);
+        sta.ssid = (rng() % 3 == 0) ? "" : SSIDS[rng() % SSID_COUNT];
+        sta.rsn = false;
+    }
+
+    std::vector<CorpusFrame> frames;
+    frames.reserve(count);
+    uint16_t seq = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        unsigned roll = rng() % 100;
+        FrameBuilder fb;
+        seq++;
+
+        if (roll < 60) {
+            // Beacon
+            const Station& ap = aps[rng() % aps.size()];
+            fb.header(WIFI_MGMT_BEACON, 0x00, BROADCAST, ap.mac, ap.mac, seq);
+            fb.fill(0, 8);          // Timestamp
+            fb.u16(100);            // Beacon interval
+            fb.u16(ap.rsn ? 0x0431 : 0x0421);
+            fb.apTags(ap);
+            frames.push_back(fb.finish(WIFI_PKT_MGMT, ap.rssi - (int8_t)(rng() % 6), ap.channel));
+        } else if (roll < 78) {
+            // Probe request
+            const Station& sta = stations[rng() % stations.size()];
+            fb.header(WIFI_MGMT_PROBE_REQ, 0x00, BROADCAST, sta.mac, BROADCAST, seq);
+            fb.ssidTag(sta.ssid);
+            fb.ratesTags();
+            static const uint8_t htCap[26] = {0x2D, 0x01, 0x1B, 0xFF};
+            fb.tag(45, htCap, sizeof(htCap));
+            frames.push_back(fb.finish(WIFI_PKT_MGMT, sta.rssi, sta.channel));
+        } else if (roll < 84) {
+            // Probe response
+            const Station& ap = aps[rng() % aps.size()];
+            const Station& sta = stations[rng() % stations.size()];
+            fb.header(WIFI_MGMT_PROBE_RESP, 0x00, sta.mac, ap.mac, ap.mac, seq);
+            fb.fill(0, 8);
+            fb.u16(100);
+            fb.u16(ap.rsn ? 0x0431 : 0x0421);
+            fb.apTags(ap);
+            frames.push_back(fb.finish(WIFI_PKT_MGMT, ap.rssi, ap.channel));
+        } else if (roll < 86) {
+            // Deauth / disassoc
+            const Station& ap = aps[rng() % aps.size()];
+            const Station& sta = stations[rng() % stations.size()];
+            fb.header((rng() & 1) ? WIFI_MGMT_DEAUTH : WIFI_MGMT_DISASSOC, 0x00, sta.mac, ap.mac, ap.mac, seq);
+            fb.u16(DEAUTH_REASON_CLASS3_FROM_NOASSOC);
+            frames.push_back(fb.finish(WIFI_PKT_MGMT, ap.rssi, ap.channel));
+        } else {
+            // QoS data, station -> AP (ToDS)
+            const Station& ap = aps[rng() % aps.size()];
+            const Station& sta = stations[rng() % stations.size()];
+            fb.header(0x88, 0x01, ap.mac, sta.mac, BROADCAST, seq);
+            fb.u16(0);                              // QoS control
+            fb.fill(rng() & 0xFF, 40 + rng() % 1200);  // Encrypted body
+            frames.push_back(fb.finish(WIFI_PKT_DATA, sta.rssi, ap.channel));
+        }
+    }
+
+    return frames;
+}
+
+bool Corpus::loadPcap(const char* path, std::vector<CorpusFrame>& out) {
+    FILE* fp = fopen(path, "rb");
+    if (!fp) return false;
+
+    uint32_t hdr[6];
+    if (fread(hdr, sizeof(hdr), 1, fp) != 1) {
+        fclose(fp);
+        return false;
+    }
+
+    bool swapped = hdr[0] == 0xD4C3B2A1;
+    if (hdr[0] != 0xA1B2C3D4 && !swapped) {
+        fclose(fp);
+        return false;
+    }
+
+    auto fix = [swapped](uint32_t v) { return swapped ? __builtin_bswap32(v) : v; };
+    uint32_t linkType = fix(hdr[5]);
+    if (linkType != 105 && linkType != 127) {
+        fclose(fp);
+        return false;
+    }
+
+    uint32_t rec[4];
+    std::vector<uint8_t> data;
+    while (fread(rec, sizeof(rec), 1, fp) == 1) {
+        uint32_t inclLen = fix(rec[2]);
+        data.resize(inclLen);
+        if (fread(data.data(), 1, inclLen, fp) != inclLen) break;
+
+        size_t offset = 0;
+        if (linkType == 127) {
+            if (inclLen < 4) continue;
+            offset = data[2] | (data[3] << 8);  // Radiotap it_len
+        }
+        if (inclLen < offset + 24) continue;
+
+        FrameBuilder fb(inclLen - offset);
+        fb.bytes(data.data() + offset, inclLen - offset);
+        fb.buf.resize(fb.buf.size() - 4);  // finish() appends the FCS back
+
+        uint8_t frameType = (fb.buf[0] >> 2) & 0x03;
+        int type = frameType == 0 ? WIFI_PKT_MGMT :
+                   frameType == 1 ? WIFI_PKT_CTRL : WIFI_PKT_DATA;
+        out.push_back(fb.finish(type, -60, 6));
+    }
+
+    fclose(fp);
+    return !out.empty();
+}
+
+std::vector<std::vector<uint8_t>> Corpus::loraPackets(size_t count, unsigned nodeCount) {
+    std::mt19937 rng(0x10AA);
+    std::vector<uint32_t> nodes(nodeCount);
+    for (auto& n : nodes) n = rng();
+
+    std::vector<std::vector<uint8_t>> packets;
+    packets.reserve(count);
+
+    for (size_t i = 0; i < count; i++) {
+        std::vector<uint8_t> pkt;
+        uint32_t dest = (rng() % 4 == 0) ? nodes[rng() % nodes.size()] : 0xFFFFFFFF;
+        uint32_t sender = nodes[rng() % nodes.size()];
+        uint32_t id = rng();
+        for (int b = 0; b < 4; b++) pkt.push_back((dest >> (8 * b)) & 0xFF);
+        for (int b = 0; b < 4; b++) pkt.push_back((sender >> (8 * b)) & 0xFF);
+        for (int b = 0; b < 4; b++) pkt.push_back((id >> (8 * b)) & 0xFF);
+        pkt.push_back(0x03 | ((rng() & 1) << 3));   // hop limit 3, want-ack
+        pkt.push_back(0x08);                        // channel hash
+        size_t payloadLen = 16 + rng() % 180;
+        for (size_t b = 0; b < payloadLen; b++) pkt.push_back(rng() & 0xFF);
+        packets.push_back(pkt);
+    }
+
+    return packets;
+}
+
+std::vector<CorpusAdvertisement> Corpus::bleAdvertisements(size_t count, unsigned deviceCount) {
+    std::mt19937 rng(0xB7E0);
+    static const char* NAMES[] = {
+        "", "", "", "AirPods Pro", "Galaxy Watch5 (4F2A)", "Galaxy Buds2", "Tile",
+        "Pixel Buds", "LE-Bose QC35", "Smart Tag", "MX Master 3", "Fitbit Charge 5",
+    };
+
+    auto addAd = [](std::vector<uint8_t>& out, uint8_t type, std::initializer_list<uint8_t> data) {
+        out.push_back((uint8_t)(data.size() + 1));
+        out.push_back(type);
+        out.insert(out.end(), data);
+    };
+
+    std::vector<CorpusAdvertisement> advertisers(deviceCount);
+    for (auto& adv : advertisers) {
+        uint8_t mac[6];
+        randomMac(rng, mac, true);
+        adv.addr = BLEAddr(MacAddr::fromBytes(mac), 1);
+        adv.rssi = -40 - (int)(rng() % 55);
+        adv.connectable = rng() & 1;
+
+        std::vector<uint8_t>& p = adv.payload;
+        switch (rng() % 6) {
+            case 0:  // Apple Nearby Info
+                addAd(p, BLEAd::TYPE_FLAGS, {0x1A});
+                addAd(p, BLEAd::TYPE_MANUFACTURER, {0x4C, 0x00, 0x10, 0x05, 0x01, 0x18,
+                                                    (uint8_t)rng(), (uint8_t)rng(), (uint8_t)rng()});
+                break;
+            case 1: {  // Apple Find My: 25 bytes of key, no flags
+                p.push_back(30);
+                p.push_back(BLEAd::TYPE_MANUFACTURER);
+                p.insert(p.end(), {0x4C, 0x00, 0x12, 0x19, 0x10});
+                for (int b = 0; b < 24; b++) p.push_back((uint8_t)rng());
+                break;
+            }
+            case 2:  // Samsung
+                addAd(p, BLEAd::TYPE_FLAGS, {0x06});
+                addAd(p, BLEAd::TYPE_MANUFACTURER, {0x75, 0x00, 0x42, 0x09, 0x81, 0x02, 0x14, 0x15, 0x03, 0x21});
+                break;
+            case 3:  // Microsoft Swift Pair / CDP
+                addAd(p, BLEAd::TYPE_MANUFACTURER, {0x06, 0x00, 0x01, 0x09, 0x20, 0x02, (uint8_t)rng()});
+                break;
+            case 4:  // Google Fast Pair / Exposure Notification
+                addAd(p, BLEAd::TYPE_FLAGS, {0x06});
+                if (rng() & 1) {
+                    addAd(p, BLEAd::TYPE_UUID16_COMPLETE, {0x2C, 0xFE});
+                    addAd(p, BLEAd::TYPE_SERVICE_DATA16, {0x2C, 0xFE, 0x00, 0x00, 0xF0});
+                } else {
+                    addAd(p, BLEAd::TYPE_UUID16_COMPLETE, {0x6F, 0xFD});
+                }
+                break;
+            default:  // Battery service
+                addAd(p, BLEAd::TYPE_FLAGS, {0x06});
+                addAd(p, BLEAd::TYPE_UUID16_COMPLETE, {0x0F, 0x18});
+                break;
+        }
+
+        // Names come in the scan response
+        const char* name = NAMES[rng() % (sizeof(NAMES) / sizeof(NAMES[0]))];
+        size_t nameLen = strlen(name);
+        if (nameLen) {
+            p.push_back((uint8_t)(nameLen + 1));
+            p.push_back(BLEAd::TYPE_NAME_COMPLETE);
+            p.insert(p.end(), name, name + nameLen);
+        }
+    }
+
+    std::vector<CorpusAdvertisement> reports;
+    reports.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        CorpusAdvertisement report = advertisers[rng() % deviceCount];
+        report.rssi += (int8_t)(rng() % 7) - 3;
+        reports.push_back(report);
+    }
+
+    return reports;
+}
+
+std::vector<uint8_t> Corpus::ouiImage(size_t count) {
+    static const uint16_t STRIDE = 24;
+    std::mt19937 rng(0x0041);
+
+    // Distinct, sorted, and never locally administered
+    std::set<uint32_t> ouis;
+    while (ouis.size() < count) ouis.insert(rng() & 0xFCFFFF);
+
+    std::vector<uint8_t> image(OUI_DB_HEADER_SIZE + count * STRIDE, 0);
+    auto put32 = [&](size_t at, uint32_t v) {
+        for (int i = 0; i < 4; i++) image[at + i] = (uint8_t)(v >> (8 * i));
+    };
+    put32(0, OUI_DB_MAGIC);
+    put32(4, (uint32_t)count);
+    image[8] = STRIDE;
+
+    uint8_t* rec = image.data() + OUI_DB_HEADER_SIZE;
+    for (uint32_t oui : ouis) {
+        rec[0] = oui >> 16;
+        rec[1] = oui >> 8;
+        rec[2] = oui;
+        snprintf((char*)rec + 3, STRIDE - 3, "Vendor %06X", (unsigned)oui);
+        rec += STRIDE;
+    }
+    return image;
+}
@@ -0,0 +1,57 @@
+/**
+ * ShitBird Native Benchmarks - frame corpus
+ *
+ * Frames fed through the firmware parsers. WiFi frames can be loaded from a
+ * recorded 802.11 capture (LINKTYPE_IEEE802_11 or radiotap); otherwise a
+ * deterministic synthetic mix shaped like a busy venue is generated.
+ */
+
+#ifndef SHITBIRD_BENCH_CORPUS_H
+#define SHITBIRD_BENCH_CORPUS_H
+
+#include <Arduino.h>
+#include <esp_wifi.h>
+#include <vector>
+#include "../src/modules/ble/ble_module.h"
+
+// One promiscuous-mode delivery: rx_ctrl followed by the 802.11 frame,
+// exactly as the driver hands it to WiFiModule's callback.
+struct CorpusFrame {
+    wifi_promiscuous_pkt_type_t type;
+    std::vector<uint8_t> raw;
+
+    const wifi_promiscuous_pkt_t* pkt() const {
+        return reinterpret_cast<const wifi_promiscuous_pkt_t*>(raw.data());
+    }
+    const uint8_t* payload() const { return pkt()->payload; }
+    uint16_t length() const { return pkt()->rx_ctrl.sig_len; }
+};
+
+// One advertising report as NimBLE hands it to BLEModule's scan callback
+struct CorpusAdvertisement {
+    BLEAddr addr;
+    int8_t rssi;
+    bool connectable;
+    std::vector<uint8_t> payload;  // AD structures: advertisement, then any scan response
+};
+
+namespace Corpus {
+    // Synthetic 802.11 traffic: beacons, probe requests/responses, deauths
+    // and data frames from `apCount` APs and `clientCount` stations.
+    std::vector<CorpusFrame> wifiFrames(size_t count, unsigned apCount, unsigned clientCount);
+
+    // Load frames from a classic pcap; returns false if unreadable.
+    bool loadPcap(const char* path, std::vector<CorpusFrame>& out);
+
+    // Meshtastic-shaped LoRa packets from `nodeCount` senders
+    std::vector<std::vector<uint8_t>> loraPackets(size_t count, unsigned nodeCount);
+
+    // Reports from `deviceCount` advertisers, each repeating its own payload
+    std::vector<CorpusAdvertisement> bleAdvertisements(size_t count, unsigned deviceCount);
+
+    // Vendor database image as tools/build_oui.py packs it, `count` random
+    // OUIs registered
+    std::vector<uint8_t> ouiImage(size_t count);
+}
+
+#endif // SHITBIRD_BENCH_CORPUS_H
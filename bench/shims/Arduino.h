@@ -0,0 +1,238 @@
+/**
+ * ShitBird Native Shim - Arduino.h
+ *
+ * Just enough of the ESP32 Arduino core for the hardware-independent parts of
+ * the firmware to build on the host. String is backed by std::string so heap
+ * traffic shows up in the benchmark's allocation counter.
+ */
+
+#ifndef SHITBIRD_SHIM_ARDUINO_H
+#define SHITBIRD_SHIM_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <sys/time.h>
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <string>
+
+using std::min;
+using std::max;
+#endif
+
+#define IRAM_ATTR
+#define PROGMEM
+
+#define HIGH    0x1
+#define LOW     0x0
+#define INPUT   0x01
+#define OUTPUT  0x03
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+// FreeRTOS handle types referenced from module headers
+typedef void* TaskHandle_t;
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void yield();
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+uint32_t esp_random();
+int64_t esp_timer_get_time();
+
+// No PSRAM on the host; ps_malloc falls back to the heap
+bool psramFound();
+void* ps_malloc(size_t size);
+
+#ifdef __cplusplus
+
+class String {
+public:
+    String() {}
+    String(const char* cstr) : s(cstr ? cstr : "") {}
+    String(const char* cstr, unsigned int length) : s(cstr, length) {}
+    String(const std::string& str) : s(str) {}
+    String(char c) : s(1, c) {}
+    String(unsigned char value, unsigned char base = 10) { fromUnsigned(value, base); }
+    String(int value, unsigned char base = 10) { fromSigned(value, base); }
+    String(unsigned int value, unsigned char base = 10) { fromUnsigned(value, base); }
+    String(long value, unsigned char base = 10) { fromSigned(value, base); }
+    String(unsigned long value, unsigned char base = 10) { fromUnsigned(value, base); }
+    String(long long value, unsigned char base = 10) { fromSigned(value, base); }
+    String(unsigned long long value, unsigned char base = 10) { fromUnsigned(value, base); }
+    String(float value, unsigned int decimals = 2) { fromDouble(value, decimals); }
+    String(double value, unsigned int decimals = 2) { fromDouble(value, decimals); }
+
+    unsigned int length() const { return (unsigned int)s.length(); }
+    bool isEmpty() const { return s.empty(); }
+    const char* c_str() const { return s.c_str(); }
+    void reserve(unsigned int size) { s.reserve(size); }
+
+    String& operator+=(const String& rhs) { s += rhs.s; return *this; }
+    String& operator+=(const char* rhs) { s += rhs; return *this; }
+    String& operator+=(char c) { s += c; return *this; }
+    bool concat(const String& rhs) { s += rhs.s; return true; }
+    bool concat(const char* rhs) { s += rhs; return true; }
+    bool concat(char c) { s += c; return true; }
+
+    bool operator==(const String& rhs) const { return s == rhs.s; }
+    bool operator==(const char* rhs) const { return s == rhs; }
+    bool operator!=(const String& rhs) const { return s != rhs.s; }
+    bool operator!=(const char* rhs) const { return s != rhs; }
+    bool operator<(const String& rhs) const { return s < rhs.s; }
+    bool equals(const String& rhs) const { return s == rhs.s; }
+    bool equalsIgnoreCase(const String& rhs) const {
+        if (s.size() != rhs.s.size()) return false;
+        for (size_t i = 0; i < s.size(); i++) {
+            if (tolower((unsigned char)s[i]) != tolower((unsigned char)rhs.s[i])) return false;
+        }
+        return true;
+    }
+
+    char charAt(unsigned int index) const { return index < s.size() ? s[index] : 0; }
+    char operator[](unsigned int index) const { return charAt(index); }
+    char& operator[](unsigned int index) { return s[index]; }
+
+    int indexOf(char c, unsigned int from = 0) const { return find(s.find(c, from)); }
+    int indexOf(const String& str, unsigned int from = 0) const { return find(s.find(str.s, from)); }
+    int lastIndexOf(char c) const { return find(s.rfind(c)); }
+    int lastIndexOf(const String& str) const { return find(s.rfind(str.s)); }
+    bool startsWith(const String& prefix) const { return s.compare(0, prefix.s.size(), prefix.s) == 0; }
+    bool endsWith(const String& suffix) const {
+        return s.size() >= suffix.s.size() &&
+               s.compare(s.size() - suffix.s.size(), suffix.s.size(), suffix.s) == 0;
+    }
+
+    String substring(unsigned int from) const { return from < s.size() ? String(s.substr(from)) : String(); }
+    String substring(unsigned int from, unsigned int to) const {
+        if (from > to) std::swap(from, to);
+        if (from >= s.size()) return String();
+        return String(s.substr(from, to - from));
+    }
+
+    void toLowerCase() { for (auto& c : s) c = (char)tolower((unsigned char)c); }
+    void toUpperCase() { for (auto& c : s) c = (char)toupper((unsigned char)c); }
+    void trim() {
+        size_t a = s.find_first_not_of(" \t\r\n");
+        size_t b = s.find_last_not_of(" \t\r\n");
+        s = (a == std::string::npos) ? std::string() : s.substr(a, b - a + 1);
+    }
+    void remove(unsigned int index) { if (index < s.size()) s.erase(index); }
+    void remove(unsigned int index, unsigned int count) { if (index < s.size()) s.erase(index, count); }
+    void replace(const String& find, const String& repl) {
+        if (find.s.empty()) return;
+        size_t pos = 0;
+        while ((pos = s.find(find.s, pos)) != std::string::npos) {
+            s.replace(pos, find.s.size(), repl.s);
+            pos += repl.s.size();
+        }
+    }
+
+    long toInt() const { return strtol(s.c_str(), nullptr, 10); }
+    float toFloat() const { return strtof(s.c_str(), nullptr); }
+
+    friend String operator+(const String& lhs, const String& rhs) { String r(lhs); r += rhs; return r; }
+    friend String operator+(const String& lhs, const char* rhs) { String r(lhs); r += rhs; return r; }
+    friend String operator+(const char* lhs, const String& rhs) { String r(lhs); r += rhs; return r; }
+    friend String operator+(const String& lhs, char rhs) { String r(lhs); r += rhs; return r; }
+
+private:
+    std::string s;
+
+    static int find(size_t pos) { return pos == std::string::npos ? -1 : (int)pos; }
+
+    void fromUnsigned(unsigned long long value, unsigned char base) {
+        char buf[66];
+        int i = sizeof(buf) - 1;
+        buf[i] = '\0';
+        do {
+            unsigned digit = value % base;
+            buf[--i] = (char)(digit < 10 ? '0' + digit : 'a' + digit - 10);
+            value /= base;
+        } while (value);
+        s = &buf[i];
+    }
+    void fromSigned(long long value, unsigned char base) {
+        if (value < 0 && base == 10) {
+            fromUnsigned((unsigned long long)(-(value + 1)) + 1, base);
+            s.insert(s.begin(), '-');
+        } else {
+            fromUnsigned((unsigned long long)value, base);
+        }
+    }
+    void fromDouble(double value, unsigned int decimals) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%.*f", (int)decimals, value);
+        s = buf;
+    }
+};
+
+// Serial / Print
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+        size_t n = 0;
+        while (size--) n += write(*buffer++);
+        return n;
+    }
+
+    size_t print(const char* str) { return write((const uint8_t*)str, strlen(str)); }
+    size_t print(const String& str) { return write((const uint8_t*)str.c_str(), str.length()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int value) { return print(String(value)); }
+    size_t print(unsigned int value) { return print(String(value)); }
+    size_t print(long value) { return print(String(value)); }
+    size_t print(unsigned long value) { return print(String(value)); }
+    size_t print(double value, int decimals = 2) { return print(String(value, decimals)); }
+    size_t println() { return print("\n"); }
+    template <typename T>
+    size_t println(const T& value) { size_t n = print(value); return n + println(); }
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        char buf[512];
+        va_list args;
+        va_start(args, format);
+        int len = vsnprintf(buf, sizeof(buf), format, args);
+        va_end(args);
+        if (len < 0) return 0;
+        return write((const uint8_t*)buf, std::min((size_t)len, sizeof(buf) - 1));
+    }
+};
+
+class HardwareSerial : public Print {
+public:
+    void begin(unsigned long baud) {}
+    void end() {}
+    int available() { return 0; }
+    int read() { return -1; }
+
+    // Host-only: silence console output while a benchmark is timing
+    void setMuted(bool muted) { this->muted = muted; }
+
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t* buffer, size_t size) override {
+        if (muted) return size;
+        return fwrite(buffer, 1, size, stdout);
+    }
+
+private:
+    bool muted = false;
+};
+
+extern HardwareSerial Serial;
+
+#endif // __cplusplus
+
+#endif // SHITBIRD_SHIM_ARDUINO_H
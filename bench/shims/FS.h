@@ -0,0 +1,79 @@
+/**
+ * ShitBird Native Shim - FS.h
+ *
+ * fs::File / fs::FS backed by the host filesystem, rooted at a directory the
+ * benchmark chooses, so Storage runs its real open/write/close sequences.
+ */
+
+#ifndef SHITBIRD_SHIM_FS_H
+#define SHITBIRD_SHIM_FS_H
+
+#include <Arduino.h>
+#include <memory>
+
+#define FILE_READ   "r"
+#define FILE_WRITE  "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+
+class FileImpl;
+
+class File : public Print {
+public:
+    File() {}
+    explicit File(std::shared_ptr<FileImpl> impl) : impl(impl) {}
+
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t* buf, size_t size) override;
+    using Print::print;
+
+    int read();
+    size_t read(uint8_t* buf, size_t size);
+    String readString();
+    bool seek(uint32_t pos);
+    size_t position() const;
+    size_t size() const;
+    void flush();
+    void close();
+    operator bool() const;
+
+    const char* name() const;
+    const char* path() const;
+    bool isDirectory() const;
+    File openNextFile(const char* mode = FILE_READ);
+
+private:
+    std::shared_ptr<FileImpl> impl;
+};
+
+class FS {
+public:
+    File open(const char* path, const char* mode = FILE_READ, bool create = false);
+    File open(const String& path, const char* mode = FILE_READ, bool create = false) {
+        return open(path.c_str(), mode, create);
+    }
+    bool exists(const char* path);
+    bool exists(const String& path) { return exists(path.c_str()); }
+    bool remove(const char* path);
+    bool remove(const String& path) { return remove(path.c_str()); }
+    bool rename(const char* pathFrom, const char* pathTo);
+    bool mkdir(const char* path);
+    bool mkdir(const String& path) { return mkdir(path.c_str()); }
+    bool rmdir(const char* path);
+
+    // Host-only: directory that stands in for the card's root
+    void setRoot(const char* dir);
+    const char* getRoot() const { return root.c_str(); }
+
+protected:
+    std::string root = ".";
+    std::string hostPath(const char* path) const;
+};
+
+} // namespace fs
+
+using fs::FS;
+using fs::File;
+
+#endif // SHITBIRD_SHIM_FS_H
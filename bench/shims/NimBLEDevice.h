@@ -0,0 +1,24 @@
+/**
+ * ShitBird Native Shim - NimBLEDevice.h
+ *
+ * Declarations only; nothing built natively talks to the BLE host stack.
+ */
+
+#ifndef SHITBIRD_SHIM_NIMBLE_DEVICE_H
+#define SHITBIRD_SHIM_NIMBLE_DEVICE_H
+
+#include <Arduino.h>
+
+class NimBLEClient;
+class NimBLEAdvertising;
+class NimBLEScan;
+class NimBLEScanResults;
+class NimBLEAdvertisedDevice;
+
+class NimBLEAdvertisedDeviceCallbacks {
+public:
+    virtual ~NimBLEAdvertisedDeviceCallbacks() {}
+    virtual void onResult(NimBLEAdvertisedDevice* advertisedDevice) {}
+};
+
+#endif // SHITBIRD_SHIM_NIMBLE_DEVICE_H
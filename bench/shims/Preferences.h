@@ -0,0 +1,35 @@
+/**
+ * ShitBird Native Shim - Preferences.h
+ *
+ * NVS is not emulated: every getter returns its default.
+ */
+
+#ifndef SHITBIRD_SHIM_PREFERENCES_H
+#define SHITBIRD_SHIM_PREFERENCES_H
+
+#include <Arduino.h>
+
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false) { return true; }
+    void end() {}
+    bool clear() { return true; }
+
+    bool getBool(const char* key, bool defaultValue = false) { return defaultValue; }
+    int8_t getChar(const char* key, int8_t defaultValue = 0) { return defaultValue; }
+    uint8_t getUChar(const char* key, uint8_t defaultValue = 0) { return defaultValue; }
+    uint16_t getUShort(const char* key, uint16_t defaultValue = 0) { return defaultValue; }
+    uint32_t getUInt(const char* key, uint32_t defaultValue = 0) { return defaultValue; }
+    float getFloat(const char* key, float defaultValue = 0) { return defaultValue; }
+    String getString(const char* key, const String& defaultValue = String()) { return defaultValue; }
+
+    size_t putBool(const char* key, bool value) { return 1; }
+    size_t putChar(const char* key, int8_t value) { return 1; }
+    size_t putUChar(const char* key, uint8_t value) { return 1; }
+    size_t putUShort(const char* key, uint16_t value) { return 2; }
+    size_t putUInt(const char* key, uint32_t value) { return 4; }
+    size_t putFloat(const char* key, float value) { return 4; }
+    size_t putString(const char* key, const char* value) { return strlen(value); }
+};
+
+#endif // SHITBIRD_SHIM_PREFERENCES_H
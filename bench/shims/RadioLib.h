@@ -0,0 +1,15 @@
+/**
+ * ShitBird Native Shim - RadioLib.h
+ *
+ * Declarations only; nothing built natively talks to the SX1262.
+ */
+
+#ifndef SHITBIRD_SHIM_RADIOLIB_H
+#define SHITBIRD_SHIM_RADIOLIB_H
+
+#include <Arduino.h>
+
+class Module;
+class SX1262;
+
+#endif // SHITBIRD_SHIM_RADIOLIB_H
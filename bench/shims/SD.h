@@ -0,0 +1,40 @@
+/**
+ * ShitBird Native Shim - SD.h
+ */
+
+#ifndef SHITBIRD_SHIM_SD_H
+#define SHITBIRD_SHIM_SD_H
+
+#include "FS.h"
+#include "SPI.h"
+
+typedef enum {
+    CARD_NONE,
+    CARD_MMC,
+    CARD_SD,
+    CARD_SDHC,
+    CARD_UNKNOWN
+} sdcard_type_t;
+
+namespace fs {
+
+class SDFS : public FS {
+public:
+    bool begin(uint8_t ssPin = 4, SPIClass& spi = SPI, uint32_t frequency = 4000000,
+               const char* mountpoint = "/sd", uint8_t max_files = 5, bool format_if_empty = false) {
+        return true;
+    }
+    void end() {}
+    sdcard_type_t cardType() { return CARD_SDHC; }
+    uint64_t cardSize() { return 32ULL * 1024 * 1024 * 1024; }
+    uint64_t totalBytes() { return cardSize(); }
+    uint64_t usedBytes() { return 0; }
+};
+
+} // namespace fs
+
+extern fs::SDFS SD;
+
+using namespace fs;
+
+#endif // SHITBIRD_SHIM_SD_H
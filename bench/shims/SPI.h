@@ -0,0 +1,18 @@
+/**
+ * ShitBird Native Shim - SPI.h
+ */
+
+#ifndef SHITBIRD_SHIM_SPI_H
+#define SHITBIRD_SHIM_SPI_H
+
+#include <Arduino.h>
+
+class SPIClass {
+public:
+    void begin(int8_t sck = -1, int8_t miso = -1, int8_t mosi = -1, int8_t ss = -1) {}
+    void end() {}
+};
+
+extern SPIClass SPI;
+
+#endif // SHITBIRD_SHIM_SPI_H
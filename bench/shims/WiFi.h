@@ -0,0 +1,11 @@
+/**
+ * ShitBird Native Shim - WiFi.h
+ */
+
+#ifndef SHITBIRD_SHIM_WIFI_H
+#define SHITBIRD_SHIM_WIFI_H
+
+#include <Arduino.h>
+#include "esp_wifi.h"
+
+#endif // SHITBIRD_SHIM_WIFI_H
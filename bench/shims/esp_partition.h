@@ -0,0 +1,53 @@
+/**
+ * ShitBird Native Shim - esp_partition.h
+ *
+ * Partitions are host files registered with esp_partition_shim_add() and
+ * mapped read-only with mmap().
+ */
+
+#ifndef SHITBIRD_SHIM_ESP_PARTITION_H
+#define SHITBIRD_SHIM_ESP_PARTITION_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef int esp_err_t;
+#define ESP_OK      0
+#define ESP_FAIL    -1
+
+typedef enum {
+    ESP_PARTITION_TYPE_APP = 0x00,
+    ESP_PARTITION_TYPE_DATA = 0x01
+} esp_partition_type_t;
+
+typedef int esp_partition_subtype_t;
+
+typedef enum {
+    SPI_FLASH_MMAP_DATA,
+    SPI_FLASH_MMAP_INST
+} spi_flash_mmap_memory_t;
+
+typedef uint32_t spi_flash_mmap_handle_t;
+
+typedef struct {
+    esp_partition_type_t type;
+    esp_partition_subtype_t subtype;
+    uint32_t address;
+    uint32_t size;
+    char label[17];
+    bool encrypted;
+} esp_partition_t;
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type,
+                                                esp_partition_subtype_t subtype,
+                                                const char* label);
+esp_err_t esp_partition_mmap(const esp_partition_t* partition, size_t offset, size_t size,
+                             spi_flash_mmap_memory_t memory, const void** out_ptr,
+                             spi_flash_mmap_handle_t* out_handle);
+void spi_flash_munmap(spi_flash_mmap_handle_t handle);
+
+// Host only: back a partition with the file at path
+bool esp_partition_shim_add(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                            const char* label, const char* path);
+
+#endif // SHITBIRD_SHIM_ESP_PARTITION_H
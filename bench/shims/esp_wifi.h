@@ -0,0 +1,10 @@
+/**
+ * ShitBird Native Shim - esp_wifi.h
+ */
+
+#ifndef SHITBIRD_SHIM_ESP_WIFI_H
+#define SHITBIRD_SHIM_ESP_WIFI_H
+
+#include "esp_wifi_types.h"
+
+#endif // SHITBIRD_SHIM_ESP_WIFI_H
@@ -0,0 +1,24 @@
+/**
+ * ShitBird Native Shim - freertos/FreeRTOS.h
+ *
+ * Types only, so headers that hold task/queue handles compile on the host.
+ * Nothing built by the native env creates tasks, so critical sections are
+ * no-ops.
+ */
+
+#ifndef SHITBIRD_SHIM_FREERTOS_H
+#define SHITBIRD_SHIM_FREERTOS_H
+
+#include <Arduino.h>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+// Critical sections: the native build is single-threaded
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED    0
+#define portENTER_CRITICAL(mux)         ((void)(mux))
+#define portEXIT_CRITICAL(mux)          ((void)(mux))
+
+#endif // SHITBIRD_SHIM_FREERTOS_H
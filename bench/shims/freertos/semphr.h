@@ -0,0 +1,24 @@
+/**
+ * ShitBird Native Shim - freertos/semphr.h
+ *
+ * Mutexes are no-ops: the native build is single-threaded.
+ */
+
+#ifndef SHITBIRD_SHIM_SEMPHR_H
+#define SHITBIRD_SHIM_SEMPHR_H
+
+#include "FreeRTOS.h"
+
+typedef void* SemaphoreHandle_t;
+
+#define pdTRUE          1
+#define portMAX_DELAY   0xFFFFFFFF
+
+inline SemaphoreHandle_t xSemaphoreCreateMutex() {
+    static int dummy;
+    return &dummy;
+}
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t, TickType_t) { return pdTRUE; }
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t) { return pdTRUE; }
+
+#endif // SHITBIRD_SHIM_SEMPHR_H
@@ -0,0 +1,52 @@
+/**
+ * ShitBird Native Shim - Arduino core runtime
+ */
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <chrono>
+#include <random>
+#include <thread>
+
+HardwareSerial Serial;
+SPIClass SPI;
+
+static const auto bootTime = std::chrono::steady_clock::now();
+
+unsigned long millis() {
+    return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - bootTime).count();
+}
+
+unsigned long micros() {
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - bootTime).count();
+}
+
+int64_t esp_timer_get_time() {
+    return (int64_t)micros();
+}
+
+bool psramFound() {
+    return false;
+}
+
+void* ps_malloc(size_t size) {
+    return malloc(size);
+}
+
+void delay(uint32_t ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void yield() {
+    std::this_thread::yield();
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {}
+void digitalWrite(uint8_t pin, uint8_t val) {}
+
+uint32_t esp_random() {
+    static std::mt19937 rng(0x5B1D);
+    return rng();
+}
@@ -0,0 +1,168 @@
+/**
+ * ShitBird Native Shim - host filesystem backing for FS.h / SD.h
+ */
+
+#include "SD.h"
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+fs::SDFS SD;
+
+namespace fs {
+
+class FileImpl {
+public:
+    FILE* fp = nullptr;
+    DIR* dir = nullptr;
+    std::string hostPath;
+    std::string cardPath;
+    std::string baseName;
+
+    ~FileImpl() { close(); }
+
+    void close() {
+        if (fp) fclose(fp);
+        if (dir) closedir(dir);
+        fp = nullptr;
+        dir = nullptr;
+    }
+};
+
+static std::string baseNameOf(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+size_t File::write(const uint8_t* buf, size_t size) {
+    if (!impl || !impl->fp) return 0;
+    return fwrite(buf, 1, size, impl->fp);
+}
+
+int File::read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+size_t File::read(uint8_t* buf, size_t size) {
+    if (!impl || !impl->fp) return 0;
+    return fread(buf, 1, size, impl->fp);
+}
+
+String File::readString() {
+    std::string out;
+    char buf[256];
+    size_t n;
+    while ((n = read((uint8_t*)buf, sizeof(buf))) > 0) {
+        out.append(buf, n);
+    }
+    return String(out);
+}
+
+bool File::seek(uint32_t pos) {
+    return impl && impl->fp && fseek(impl->fp, pos, SEEK_SET) == 0;
+}
+
+size_t File::position() const {
+    return (impl && impl->fp) ? (size_t)ftell(impl->fp) : 0;
+}
+
+size_t File::size() const {
+    if (!impl) return 0;
+    if (impl->fp) fflush(impl->fp);
+    struct stat st;
+    return stat(impl->hostPath.c_str(), &st) == 0 ? (size_t)st.st_size : 0;
+}
+
+void File::flush() {
+    if (impl && impl->fp) fflush(impl->fp);
+}
+
+void File::close() {
+    if (impl) impl->close();
+    impl.reset();
+}
+
+File::operator bool() const {
+    return impl && (impl->fp || impl->dir);
+}
+
+const char* File::name() const {
+    return impl ? impl->baseName.c_str() : "";
+}
+
+const char* File::path() const {
+    return impl ? impl->cardPath.c_str() : "";
+}
+
+bool File::isDirectory() const {
+    return impl && impl->dir;
+}
+
+File File::openNextFile(const char* mode) {
+    if (!impl || !impl->dir) return File();
+    struct dirent* entry;
+    while ((entry = readdir(impl->dir)) != nullptr) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+        std::string child = impl->cardPath;
+        if (child.empty() || child.back() != '/') child += "/";
+        child += entry->d_name;
+        return SD.open(child.c_str(), mode);
+    }
+    return File();
+}
+
+void FS::setRoot(const char* dir) {
+    root = dir;
+    ::mkdir(root.c_str(), 0755);
+}
+
+std::string FS::hostPath(const char* path) const {
+    std::string p = root;
+    if (path[0] != '/') p += "/";
+    p += path;
+    return p;
+}
+
+File FS::open(const char* path, const char* mode, bool create) {
+    auto impl = std::make_shared<FileImpl>();
+    impl->hostPath = hostPath(path);
+    impl->cardPath = path;
+    impl->baseName = baseNameOf(path);
+
+    struct stat st;
+    if (stat(impl->hostPath.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+        impl->dir = opendir(impl->hostPath.c_str());
+    } else {
+        const char* hostMode = strcmp(mode, FILE_WRITE) == 0 ? "wb" :
+                               strcmp(mode, FILE_APPEND) == 0 ? "ab" : "rb";
+        impl->fp = fopen(impl->hostPath.c_str(), hostMode);
+    }
+
+    if (!impl->fp && !impl->dir) return File();
+    return File(impl);
+}
+
+bool FS::exists(const char* path) {
+    struct stat st;
+    return stat(hostPath(path).c_str(), &st) == 0;
+}
+
+bool FS::remove(const char* path) {
+    return ::unlink(hostPath(path).c_str()) == 0;
+}
+
+bool FS::rename(const char* pathFrom, const char* pathTo) {
+    return ::rename(hostPath(pathFrom).c_str(), hostPath(pathTo).c_str()) == 0;
+}
+
+bool FS::mkdir(const char* path) {
+    return ::mkdir(hostPath(path).c_str(), 0755) == 0;
+}
+
+bool FS::rmdir(const char* path) {
+    return ::rmdir(hostPath(path).c_str()) == 0;
+}
+
+} // namespace fs
@@ -0,0 +1,84 @@
+/**
+ * ShitBird Native Shim - host file backing for esp_partition.h
+ */
+
+#include "esp_partition.h"
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct HostPartition {
+    esp_partition_t info;
+    std::string path;
+};
+
+struct Mapping {
+    void* addr;
+    size_t len;
+};
+
+std::vector<HostPartition> partitions;
+std::vector<Mapping> mappings;  // Handle n is mappings[n - 1]
+
+} // namespace
+
+bool esp_partition_shim_add(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                            const char* label, const char* path) {
+    struct stat st;
+    if (stat(path, &st) != 0) return false;
+
+    HostPartition part = {};
+    part.info.type = type;
+    part.info.subtype = subtype;
+    part.info.size = (uint32_t)st.st_size;
+    strncpy(part.info.label, label, sizeof(part.info.label) - 1);
+    part.path = path;
+    partitions.push_back(part);
+    return true;
+}
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type,
+                                                esp_partition_subtype_t subtype,
+                                                const char* label) {
+    for (const auto& part : partitions) {
+        if (part.info.type == type && part.info.subtype == subtype &&
+            (!label || strcmp(part.info.label, label) == 0)) {
+            return &part.info;
+        }
+    }
+    return nullptr;
+}
+
+esp_err_t esp_partition_mmap(const esp_partition_t* partition, size_t offset, size_t size,
+                             spi_flash_mmap_memory_t memory, const void** out_ptr,
+                             spi_flash_mmap_handle_t* out_handle) {
+    for (const auto& part : partitions) {
+        if (&part.info != partition) continue;
+        if (offset + size > partition->size) return ESP_FAIL;
+
+        int fd = open(part.path.c_str(), O_RDONLY);
+        if (fd < 0) return ESP_FAIL;
+        void* addr = mmap(nullptr, offset + size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (addr == MAP_FAILED) return ESP_FAIL;
+
+        mappings.push_back({addr, offset + size});
+        *out_ptr = static_cast<const uint8_t*>(addr) + offset;
+        *out_handle = (spi_flash_mmap_handle_t)mappings.size();
+        return ESP_OK;
+    }
+    return ESP_FAIL;
+}
+
+void spi_flash_munmap(spi_flash_mmap_handle_t handle) {
+    if (handle == 0 || handle > mappings.size()) return;
+    Mapping& m = mappings[handle - 1];
+    if (m.addr) munmap(m.addr, m.len);
+    m.addr = nullptr;
+}
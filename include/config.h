@@ -121,16 +121,120 @@
 #define WIFI_DEAUTH_REASON      1       // Unspecified reason
 #define WIFI_DEAUTH_INTERVAL    100     // ms between packets
 #define WIFI_BEACON_INTERVAL    100     // ms between beacons
-#define WIFI_MAX_TARGETS        64      // Max APs/clients to track
-#define WIFI_CHANNEL_HOP_TIME   200     // ms per channel
-#define WIFI_PCAP_BUFFER_SIZE   8192    // Bytes for pcap buffer
+#define WIFI_SSID_POOL_SIZE     1024    // Distinct SSIDs held at once (33 bytes each, PSRAM)
+#define WIFI_MAX_PROBED_SSIDS   8       // Probed SSIDs remembered per client
+#define WIFI_MAX_ASSOCIATIONS   256     // Client<->AP edges learned from data frames
+#define WIFI_HOP_MIN_DWELL      110     // ms on a quiet channel (just over one beacon interval)
+#define WIFI_HOP_MAX_DWELL      1000    // ms on the busiest channel
+#define WIFI_HOP_MAX_REVISIT    3000    // ms before a quiet channel must be visited again
+#define WIFI_PCAP_BUFFER_SIZE   32768   // Bytes per PcapWriter block write, all captures (two buffers, PSRAM)
+#define WIFI_RX_RING_SLOTS      64      // Frames queued between driver callback and parser (power of 2)
+#define WIFI_RX_SNAPLEN         512     // Max bytes copied per frame
+#define WIFI_RX_HEADER_SNAPLEN  64      // Data frames when nothing needs their body
+#define WIFI_RX_BATCH           16      // Frames parsed before the parser task yields
+#define WIFI_SCAN_CONTINUOUS    1       // Start the next active scan sweep as each one completes
+
+// Deauth/disassoc flood detection (WIDS)
+#define WIDS_WINDOW_SECS        10      // Sliding window, one bucket per second
+#define WIDS_BSSID_THRESHOLD    30      // Frames per window naming one BSSID
+#define WIDS_SOURCE_THRESHOLD   30      // Frames per window from one transmitter
+#define WIDS_CHANNEL_THRESHOLD  60      // Frames per window on one channel
+#define WIDS_TRACK_SLOTS        64      // Counters per table (power of 2)
+#define WIDS_MAX_EVENTS         16      // Events remembered for the status page
+
+// Rogue AP / evil-twin detection
+#define ROGUE_MAX_SSIDS         128     // SSID profiles indexed (power of 2, <= 128)
+#define ROGUE_MAX_OUIS          4       // Vendor OUIs remembered per SSID
+#define ROGUE_MAX_ALERTS        16      // Alerts remembered for the status page
+#define ROGUE_REPEAT_MS         60000   // Repeats within this fold into one alert
+
+// Channel utilization
+#define AIRTIME_WINDOW_SECS     30      // One-second buckets kept per channel
+
+// ============================================================================
+// TASK LAYOUT (see core/task_registry.h)
+// ============================================================================
+// Core 0 carries the WiFi/BT controllers, whose callbacks only enqueue;
+// core 1 runs the workers that parse and export above loop() and the UI
+#define CORE_RADIO              0       // Radio-facing tasks
+#define CORE_APP                1       // Parsers, exporters, loopTask
+#define TASK_PRIO_PARSER        3       // Drain capture rings before they fill
+#define TASK_PRIO_EXPORT        2       // PCAP writer; blocks on SD most of the time
+#define TASK_PRIO_PERIPHERAL    2       // BadUSB payload typing
+#define TASK_PRIO_LOOP          1       // Arduino loopTask, fixed by the core
+#define TASK_PRIO_RADIO         2       // Channel hop, LoRa scan/sweep
+#define TASK_PRIO_ATTACK        1       // Transmit loops
+#define TASK_REGISTRY_SLOTS     16
+
+// ============================================================================
+// RADIO COEXISTENCE (see core/radio_scheduler.h)
+// ============================================================================
+// WiFi monitor mode and BLE scanning share one 2.4 GHz radio. While both
+// run, each cycle gives WiFi the active profile's share and BLE the rest.
+#define COEX_CYCLE_MS           500     // One WiFi slice plus one BLE slice
+#define COEX_MIN_SLICE_MS       50      // A shorter slice goes to the other radio
+#define COEX_SHARE_RECON        60      // WiFi % of each cycle, Profile::RECON_ONLY
+#define COEX_SHARE_WIFI         85      // Profile::WIFI_ASSESSMENT
+#define COEX_SHARE_BLE_HUNT     20      // Profile::BLE_HUNT
+#define COEX_SHARE_DEFAULT      50      // Every other profile
 
 // ============================================================================
 // BLE ATTACK CONFIGURATION
 // ============================================================================
 #define BLE_SCAN_DURATION       10      // seconds
 #define BLE_SPAM_INTERVAL       20      // ms between spam packets
-#define BLE_MAX_DEVICES         100     // Max tracked devices
+#define BLE_ADV_DATA_MAX        62      // AD bytes kept per device: advertisement + scan response
+#define BLE_REPORT_RING_SLOTS   128     // Reports queued between scan callback and scan worker (power of 2)
+#define BLE_REPORT_BATCH        16      // Reports recorded before the scan worker yields
+#define BLE_PDU_RING_SLOTS      128     // Reports queued between scan worker and capture task (power of 2)
+#define BLE_PDU_BATCH           16      // PDUs written before the capture task yields
+
+// "Following me" tracker detection (modules/ble/tracker_monitor.h)
+#define TRACKER_MAX_DEVICES     32      // Trackers with a trail at once
+#define TRACKER_TRAIL_POINTS    16      // Sightings kept per tracker (ring)
+#define TRACKER_SAMPLE_MS       60000   // ms between trail points while standing still
+#define TRACKER_LOCATION_M      200     // Sightings this far apart are different places
+#define TRACKER_ALERT_LOCATIONS 3       // Places a tracker must be heard at to alert
+#define TRACKER_ALERT_MS        900000  // ...or ms it must keep up across two of them
+#define TRACKER_FORGET_MS       1800000 // Unheard this long and its trail starts over
+#define TRACKER_MAX_ALERTS      16      // Alerts remembered for the status page
+
+// Linking rotated private addresses into devices (modules/ble/ble_cluster.h)
+#define BLE_CLUSTER_ADDRS       512     // Addresses mapped to their device (PSRAM)
+#define BLE_CLUSTER_MAX         128     // Devices held at once, ~136 B each
+#define BLE_CLUSTER_HISTORY     6       // Addresses kept per device (ring)
+#define BLE_CLUSTER_LINK_MS     10000   // A new address may continue a device quiet at most this long
+#define BLE_CLUSTER_RSSI_DB     8       // ...when heard within this many dB of it
+#define BLE_CLUSTER_PRESENT_MS  60000   // Heard this recently counts towards the unique device count
+
+// ============================================================================
+// TRACKING TABLES (see core/table_budget.h)
+// ============================================================================
+// Each table is fixed at what its budget holds; when it is full a new entry
+// replaces the one unheard longest (then the weakest)
+#define WIFI_AP_TABLE_BYTES     49152   // Access points, ~72 B each (PSRAM)
+#define WIFI_CLIENT_TABLE_BYTES 65536   // Stations, ~64 B each (PSRAM)
+#define BLE_DEVICE_TABLE_BYTES  65536   // Devices, ~130 B each with their AD (PSRAM)
+#define LORA_NODE_TABLE_BYTES   8192    // Meshtastic nodes
+
+// ============================================================================
+// TRACKING EXPIRY
+// ============================================================================
+#define EXPIRY_WHEEL_TICK_MS    1000    // Timer wheel resolution
+#define EXPIRY_WHEEL_SLOTS      256     // One lap = 256 s; longer TTLs re-arm per lap
+#define WIFI_AP_TTL             120000  // ms unseen before an AP is dropped
+#define WIFI_CLIENT_TTL         120000  // ms unseen before a client is dropped
+#define WIFI_ASSOC_TTL          120000  // ms without data before a client<->AP edge is dropped
+#define BLE_DEVICE_TTL          60000   // ms unseen before a BLE device is dropped
+#define LORA_NODE_TTL           3600000 // ms unseen before a mesh node is dropped
+
+// ============================================================================
+// WARDRIVING
+// ============================================================================
+#define WARDRIVE_MAX_WIFI       2048    // Distinct BSSIDs per session
+#define WARDRIVE_MAX_BLE        1024    // Distinct BLE addresses per session
+#define WARDRIVE_FLUSH_MS       5000    // Changed records appended this often
+#define WARDRIVE_FLUSH_BATCH    32      // Rows per SD write
 
 // ============================================================================
 // SECURITY CONFIGURATION
@@ -159,6 +263,12 @@
 #define LOG_MAX_FILE_SIZE       10485760    // 10MB per log file
 #define LOG_ROTATE_COUNT        5           // Number of log files to keep
 
+// ============================================================================
+// OUI VENDOR DATABASE
+// ============================================================================
+#define OUI_PARTITION_LABEL     "oui"   // Raw data partition, see partitions.csv
+#define OUI_PARTITION_SUBTYPE   0x40    // Custom data subtype
+
 // ============================================================================
 // UI CONFIGURATION
 // ============================================================================
@@ -0,0 +1,226 @@
+/**
+ * ShitBird Firmware - Multi-Radio Capture Session Implementation
+ */
+
+#include "capture_session.h"
+#include "storage.h"
+#include "../ui/ui_manager.h"
+
+// Radiotap fields (present bits), laid out in bit order below
+#define RADIOTAP_FLAGS          (1 << 1)
+#define RADIOTAP_RATE           (1 << 2)
+#define RADIOTAP_CHANNEL        (1 << 3)
+#define RADIOTAP_DBM_ANTSIGNAL  (1 << 5)
+#define RADIOTAP_DBM_ANTNOISE   (1 << 6)
+#define RADIOTAP_MCS            (1 << 19)
+
+#define RADIOTAP_F_SHORTPRE     0x02
+#define RADIOTAP_F_FCS          0x10
+#define RADIOTAP_CHAN_CCK       0x0020
+#define RADIOTAP_CHAN_OFDM      0x0040
+#define RADIOTAP_CHAN_2GHZ      0x0080
+
+// BLE advertising channel access address and LE LL pseudo-header flags
+#define BLE_ADV_ACCESS_ADDRESS  0x8E89BED6
+#define BLE_PHDR_DEWHITENED     0x0001
+#define BLE_PHDR_SIGNAL_VALID   0x0002
+
+PcapWriter CaptureSession::writer;
+volatile bool CaptureSession::active = false;
+String CaptureSession::filename;
+
+int CaptureSession::wifiInterface = -1;
+int CaptureSession::bleInterface = -1;
+int CaptureSession::loraInterface = -1;
+
+namespace {
+
+// rx_ctrl.rate for non-HT frames (wifi_phy_rate_t) in 500 kbps units;
+// 0x05-0x07 are the short-preamble CCK rates
+const uint8_t LEGACY_RATES[16] = {
+    2, 4, 11, 22, 0, 4, 11, 22, 96, 48, 24, 12, 108, 72, 36, 18
+};
+
+void put16(uint8_t* p, uint16_t v) { p[0] = v; p[1] = v >> 8; }
+void put32(uint8_t* p, uint32_t v) { put16(p, v); put16(p + 2, v >> 16); }
+
+} // namespace
+
+bool CaptureSession::start(const char* name) {
+    if (active) stop();
+
+    String path = String(PATH_PCAP) + "/" + name;
+    if (!writer.openNg(path.c_str())) {
+        Serial.println("[CAPTURE] Failed to create session file");
+        return false;
+    }
+
+    wifiInterface = writer.addInterface(PCAP_LINKTYPE_IEEE802_11_RADIOTAP, WIFI_RX_SNAPLEN, "wifi0");
+    bleInterface = writer.addInterface(PCAP_LINKTYPE_BLUETOOTH_LE_LL_PHDR, 0, "ble0");
+    loraInterface = writer.addInterface(PCAP_LINKTYPE_LORATAP, 0, "lora0");
+
+    filename = path;
+    active = true;
+
+    Serial.printf("[CAPTURE] Session started: %s\n", path.c_str());
+    Storage::logf("capture", "Session started: %s", name);
+    return true;
+}
+
+void CaptureSession::stop() {
+    if (!active) return;
+
+    active = false;
+    PcapWriterStats stats = writer.getStats();
+    writer.close();
+
+    Serial.printf("[CAPTURE] Session stopped, %lu packets\n", (unsigned long)stats.packets);
+    Storage::logf("capture", "Session stopped: %s, %lu packets, %lu dropped",
+                  filename.c_str(), (unsigned long)stats.packets, (unsigned long)stats.dropped);
+    filename = "";
+}
+
+String CaptureSession::getFilename() {
+    return filename;
+}
+
+PcapWriterStats CaptureSession::getStats() {
+    return writer.getStats();
+}
+
+void CaptureSession::writeWiFi(const wifi_pkt_rx_ctrl_t& rx, const uint8_t* frame, uint16_t origLen) {
+    if (!active || wifiInterface < 0) return;
+
+    uint16_t len = rx.sig_len;
+    bool ht = (rx.sig_mode == 1);
+
+    uint32_t present = RADIOTAP_FLAGS | RADIOTAP_CHANNEL | RADIOTAP_DBM_ANTSIGNAL | RADIOTAP_DBM_ANTNOISE;
+    present |= ht ? RADIOTAP_MCS : RADIOTAP_RATE;
+
+    // sig_len counts the FCS; a truncated frame has lost it
+    uint8_t flags = (len == origLen) ? RADIOTAP_F_FCS : 0;
+    uint8_t rate = 0;
+    uint16_t chanFlags = RADIOTAP_CHAN_2GHZ;
+    if (ht) {
+        chanFlags |= RADIOTAP_CHAN_OFDM;
+    } else if (rx.sig_mode == 0) {
+        rate = LEGACY_RATES[rx.rate & 0x0F];
+        chanFlags |= (rx.rate < 8) ? RADIOTAP_CHAN_CCK : RADIOTAP_CHAN_OFDM;
+        if (rx.rate >= 5 && rx.rate <= 7) flags |= RADIOTAP_F_SHORTPRE;
+    }
+    uint16_t freq = (rx.channel == 14) ? 2484 : 2407 + 5 * rx.channel;
+
+    // Fields by present bit with natural alignment: flags @8, rate (or the
+    // pad byte before channel) @9, channel @10, signal @14, noise @15, MCS @16
+    uint8_t hdr[19] = {0};
+    uint16_t hdrLen = ht ? 19 : 16;
+    put16(hdr + 2, hdrLen);
+    put32(hdr + 4, present);
+    hdr[8] = flags;
+    hdr[9] = rate;
+    put16(hdr + 10, freq);
+    put16(hdr + 12, chanFlags);
+    hdr[14] = (uint8_t)(int8_t)rx.rssi;
+    hdr[15] = (uint8_t)(int8_t)rx.noise_floor;
+    if (ht) {
+        hdr[16] = 0x07;  // Known: bandwidth, MCS index, guard interval
+        hdr[17] = (rx.cwb ? 0x01 : 0x00) | (rx.sgi ? 0x04 : 0x00);
+        hdr[18] = rx.mcs;
+    }
+
+    writer.writeEnhancedPacket(wifiInterface, hdr, hdrLen, frame, len, origLen);
+}
+
+void CaptureSession::writeBLE(uint8_t pduType, bool randomAddress, const uint8_t* advA,
+                              const uint8_t* advData, uint8_t advDataLen, int8_t rssi) {
+    if (!active || bleInterface < 0) return;
+    if (advDataLen > 255 - 6) advDataLen = 255 - 6;
+
+    uint8_t hdr[BLE_LL_PHDR_RECORD_HEADER];
+    buildBLEHeader(hdr, pduType, randomAddress, advA, advDataLen, rssi);
+
+    uint8_t body[255 + 3] = {0};
+    memcpy(body, advData, advDataLen);
+
+    writer.writeEnhancedPacket(bleInterface, hdr, sizeof(hdr), body, advDataLen + 3);
+}
+
+void CaptureSession::buildBLEHeader(uint8_t* hdr, uint8_t pduType, bool randomAddress,
+                                    const uint8_t* advA, uint8_t advDataLen, int8_t rssi) {
+    // Pseudo-header: rf_channel, signal, noise, AA offenses, reference AA, flags.
+    // The scan report doesn't say which of 37/38/39 it came in on; leave 0.
+    // The CRC isn't reported either, so it goes out as zeros, unchecked.
+    memset(hdr, 0, BLE_LL_PHDR_RECORD_HEADER);
+    hdr[1] = (uint8_t)rssi;
+    put32(hdr + 4, BLE_ADV_ACCESS_ADDRESS);
+    put16(hdr + 8, BLE_PHDR_DEWHITENED | BLE_PHDR_SIGNAL_VALID);
+
+    // LL packet: access address, PDU header, AdvA, then AdvData and CRC
+    put32(hdr + 10, BLE_ADV_ACCESS_ADDRESS);
+    hdr[14] = (pduType & 0x0F) | (randomAddress ? 0x40 : 0x00);
+    hdr[15] = 6 + advDataLen;
+    memcpy(hdr + 16, advA, 6);
+}
+
+void CaptureSession::writeLoRa(float frequencyMHz, float bandwidthKHz, uint8_t sf, uint8_t syncWord,
+                               float rssi, float snr, const uint8_t* data, size_t len) {
+    if (!active || loraInterface < 0) return;
+
+    // LoRaTap v0, all multi-byte fields big-endian
+    uint32_t freqHz = (uint32_t)(frequencyMHz * 1000000.0f);
+    int packetRssi = constrain((int)(rssi + 139.0f), 0, 255);
+
+    uint8_t hdr[15] = {0};
+    hdr[0] = 0;                                // Version
+    hdr[3] = sizeof(hdr);                      // Header length
+    hdr[4] = freqHz >> 24;
+    hdr[5] = freqHz >> 16;
+    hdr[6] = freqHz >> 8;
+    hdr[7] = freqHz;
+    hdr[8] = (uint8_t)(bandwidthKHz / 125.0f + 0.5f);  // 125 kHz steps
+    hdr[9] = sf;
+    hdr[10] = packetRssi;                      // -139 + value = dBm
+    hdr[13] = (uint8_t)(int8_t)(snr * 4.0f);   // Quarter-dB steps
+    hdr[14] = syncWord;
+
+    writer.writeEnhancedPacket(loraInterface, hdr, sizeof(hdr), data, len);
+}
+
+// ============================================================================
+// Menu Integration
+// ============================================================================
+
+void CaptureSession::buildMenu(void* menuPtr) {
+    MenuScreen* menu = static_cast<MenuScreen*>(menuPtr);
+
+    menu->addItem(MenuItem("Start Session", []() {
+        char name[32];
+        snprintf(name, sizeof(name), "session_%lu.pcapng", millis());
+        if (CaptureSession::start(name)) {
+            UIManager::showMessage("Capture", "Session started");
+        } else {
+            UIManager::showMessage("Capture", "Failed to start");
+        }
+    }));
+
+    menu->addItem(MenuItem("Stop Session", []() {
+        CaptureSession::stop();
+        UIManager::showMessage("Capture", "Session stopped");
+    }));
+
+    menu->addItem(MenuItem("Session Stats", []() {
+        if (!CaptureSession::isActive()) {
+            UIManager::showMessage("Capture", "Not capturing");
+            return;
+        }
+        PcapWriterStats stats = CaptureSession::getStats();
+        char msg[40];
+        snprintf(msg, sizeof(msg), "%lu pkts Drop %lu %luKB/s",
+                 (unsigned long)stats.packets, (unsigned long)stats.dropped,
+                 (unsigned long)(stats.bytesPerSec / 1024));
+        UIManager::showMessage("Capture", msg);
+    }));
+
+    menu->addItem(MenuItem("< Back", nullptr));
+    static_cast<MenuItem&>(menu->items.back()).type = MenuItemType::BACK;
+}
@@ -0,0 +1,60 @@
+/**
+ * ShitBird Firmware - Multi-Radio Capture Session
+ *
+ * One PCAPNG file for everything the radios hear. Each source gets its own
+ * interface: 802.11 behind a radiotap header (RSSI, noise, channel, rate),
+ * BLE advertising PDUs with the LE LL pseudo-header, and LoRa behind
+ * LoRaTap. Packets carry microsecond timestamps, so the three streams line
+ * up in Wireshark without merging files offline.
+ */
+
+#ifndef SHITBIRD_CAPTURE_SESSION_H
+#define SHITBIRD_CAPTURE_SESSION_H
+
+#include <Arduino.h>
+#include <esp_wifi_types.h>
+#include "pcap_writer.h"
+
+// LE LL pseudo-header plus access address, PDU header and AdvA
+#define BLE_LL_PHDR_RECORD_HEADER   22
+
+class CaptureSession {
+public:
+    // Creates PATH_PCAP/filename and registers the WiFi, BLE and LoRa interfaces
+    static bool start(const char* filename);
+    static void stop();
+    static bool isActive() { return active; }
+    static String getFilename();
+    static PcapWriterStats getStats();
+
+    // Safe to call from any task; each drops the packet if not active.
+    // rx.sig_len is the stored length, origLen what came off the air.
+    static void writeWiFi(const wifi_pkt_rx_ctrl_t& rx, const uint8_t* frame, uint16_t origLen);
+
+    // One advertising channel PDU. pduType is the LL PDU type (ADV_IND = 0,
+    // ...), advA the advertiser address in air (little-endian) order.
+    static void writeBLE(uint8_t pduType, bool randomAddress, const uint8_t* advA,
+                         const uint8_t* advData, uint8_t advDataLen, int8_t rssi);
+
+    // Fills the BLE_LL_PHDR_RECORD_HEADER bytes that precede AdvData in a
+    // LINKTYPE_BLUETOOTH_LE_LL_WITH_PHDR record; AdvData and a 3-byte CRC follow
+    static void buildBLEHeader(uint8_t* hdr, uint8_t pduType, bool randomAddress,
+                               const uint8_t* advA, uint8_t advDataLen, int8_t rssi);
+
+    static void writeLoRa(float frequencyMHz, float bandwidthKHz, uint8_t sf, uint8_t syncWord,
+                          float rssi, float snr, const uint8_t* data, size_t len);
+
+    // Menu integration
+    static void buildMenu(void* menuScreen);
+
+private:
+    static PcapWriter writer;
+    static volatile bool active;
+    static String filename;
+
+    static int wifiInterface;
+    static int bleInterface;
+    static int loraInterface;
+};
+
+#endif // SHITBIRD_CAPTURE_SESSION_H
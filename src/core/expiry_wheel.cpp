@@ -0,0 +1,239 @@
+/**
+ * ShitBird Firmware - Timer-Wheel Expiry Implementation
+ */
+
+#include "expiry_wheel.h"
+
+ExpiryWheel::Table ExpiryWheel::tables[(size_t)ExpiryTable::COUNT];
+std::vector<ExpiryWheel::Node> ExpiryWheel::nodes;
+int32_t ExpiryWheel::freeList = -1;
+int32_t ExpiryWheel::slots[EXPIRY_WHEEL_SLOTS];
+uint32_t ExpiryWheel::cursor = 0;
+uint32_t ExpiryWheel::cursorTime = 0;
+ExpiryStats ExpiryWheel::stats = {};
+SemaphoreHandle_t ExpiryWheel::lock = nullptr;
+
+// Tables register from init() on the main task, before anything schedules
+void ExpiryWheel::ensureLock() {
+    if (lock) return;
+    lock = xSemaphoreCreateMutex();
+    for (size_t i = 0; i < EXPIRY_WHEEL_SLOTS; i++) slots[i] = -1;
+    cursorTime = millis();
+}
+
+void ExpiryWheel::registerTable(ExpiryTable table, uint32_t ttlMs, LookupFn lookup, EvictFn evict) {
+    ensureLock();
+    xSemaphoreTake(lock, portMAX_DELAY);
+    Table& t = tables[(size_t)table];
+    t.ttlMs = ttlMs;
+    t.lookup = lookup;
+    t.evict = evict;
+    t.registered = true;
+    xSemaphoreGive(lock);
+}
+
+void ExpiryWheel::setTtl(ExpiryTable table, uint32_t ttlMs) {
+    // Pending timers keep their deadline; re-arms pick up the new TTL
+    tables[(size_t)table].ttlMs = ttlMs;
+}
+
+uint32_t ExpiryWheel::getTtl(ExpiryTable table) {
+    return tables[(size_t)table].ttlMs;
+}
+
+void ExpiryWheel::schedule(ExpiryTable table, uint64_t key, uint32_t lastSeen) {
+    if (!lock || !tables[(size_t)table].registered) return;
+
+    // An invalid handle has no slot to index it by, and nothing to expire
+    size_t keySlot = key & 0xFFFF;
+    if (keySlot == 0xFFFF) return;
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+
+    int32_t index;
+    if (freeList >= 0) {
+        index = freeList;
+        freeList = nodes[index].next;
+    } else {
+        index = nodes.size();
+        nodes.push_back(Node());
+    }
+
+    Table& t = tables[(size_t)table];
+    Node& node = nodes[index];
+    node.key = key;
+    node.table = table;
+    node.deadline = lastSeen + t.ttlMs;
+    insertLocked(index);
+    stats.scheduled++;
+
+    // A slot's previous timer, if still pending, was for an older generation
+    // and stays in the wheel until its lookup finds the handle stale
+    if (keySlot >= t.byKey.size()) t.byKey.resize(keySlot + 1, -1);
+    t.byKey[keySlot] = index;
+
+    xSemaphoreGive(lock);
+}
+
+void ExpiryWheel::cancel(ExpiryTable table, uint64_t key) {
+    if (!lock) return;
+    xSemaphoreTake(lock, portMAX_DELAY);
+
+    const std::vector<int32_t>& byKey = tables[(size_t)table].byKey;
+    size_t keySlot = key & 0xFFFF;
+    int32_t index = keySlot < byKey.size() ? byKey[keySlot] : -1;
+
+    if (index >= 0 && nodes[index].key == key) {
+        if (nodes[index].state == NodeState::ARMED) {
+            unlinkLocked(index);
+            releaseLocked(index);
+        } else if (nodes[index].state == NodeState::FIRING) {
+            // Detached by advance(), which releases it after the callbacks
+            nodes[index].state = NodeState::CANCELLED;
+        }
+    }
+
+    xSemaphoreGive(lock);
+}
+
+void ExpiryWheel::clear(ExpiryTable table) {
+    if (!lock) return;
+    xSemaphoreTake(lock, portMAX_DELAY);
+
+    // Timers being fired are not in a slot; their lookups find nothing
+    for (size_t s = 0; s < EXPIRY_WHEEL_SLOTS; s++) {
+        int32_t index = slots[s];
+        while (index >= 0) {
+            int32_t next = nodes[index].next;
+            if (nodes[index].table == table) {
+                unlinkLocked(index);
+                releaseLocked(index);
+            }
+            index = next;
+        }
+    }
+
+    xSemaphoreGive(lock);
+}
+
+size_t ExpiryWheel::advance(uint32_t now) {
+    if (!lock) return 0;
+
+    // After a long stall one lap covers every slot
+    const uint32_t lap = EXPIRY_WHEEL_SLOTS * EXPIRY_WHEEL_TICK_MS;
+    if ((int32_t)(now - cursorTime) > (int32_t)lap) {
+        cursorTime = now - lap;
+    }
+
+    // Times are compared as differences so millis() wrapping is harmless
+    size_t evicted = 0;
+    while ((int32_t)(now - cursorTime) >= 0) {
+        size_t slot = cursor % EXPIRY_WHEEL_SLOTS;
+
+        // Detach the slot so re-armed nodes that hash back into it wait a lap,
+        // and mark them so cancel() leaves their links alone
+        xSemaphoreTake(lock, portMAX_DELAY);
+        int32_t index = slots[slot];
+        slots[slot] = -1;
+        for (int32_t i = index; i >= 0; i = nodes[i].next) {
+            nodes[i].state = NodeState::FIRING;
+        }
+        xSemaphoreGive(lock);
+
+        while (index >= 0) {
+            // Copy out: another task may grow `nodes` while the callbacks run
+            xSemaphoreTake(lock, portMAX_DELAY);
+            Node node = nodes[index];
+            if (node.state == NodeState::CANCELLED) {
+                releaseLocked(index);
+                xSemaphoreGive(lock);
+                index = node.next;
+                continue;
+            }
+            Table& t = tables[(size_t)node.table];
+            LookupFn lookup = t.lookup;
+            xSemaphoreGive(lock);
+
+            uint32_t lastSeen = 0;
+            bool exists = lookup && lookup(node.key, lastSeen);
+            uint32_t deadline = lastSeen + t.ttlMs;
+            bool expired = exists && (int32_t)(now - deadline) >= 0;
+
+            // Seen again since the lookup: evict declines, and it re-arms
+            if (expired) {
+                if (t.evict && t.evict(node.key, now - t.ttlMs)) {
+                    evicted++;
+                } else {
+                    expired = false;
+                    exists = lookup(node.key, lastSeen);
+                    deadline = lastSeen + t.ttlMs;
+                }
+            }
+
+            // Cancelled meanwhile: the owner removed the entry itself
+            xSemaphoreTake(lock, portMAX_DELAY);
+            if (nodes[index].state == NodeState::CANCELLED) {
+                releaseLocked(index);
+            } else if (!exists) {
+                stats.stale++;
+                releaseLocked(index);
+            } else if (expired) {
+                stats.evicted++;
+                releaseLocked(index);
+            } else {
+                stats.rearmed++;
+                nodes[index].deadline = deadline;
+                insertLocked(index);
+            }
+            xSemaphoreGive(lock);
+
+            index = node.next;
+        }
+
+        cursor++;
+        cursorTime += EXPIRY_WHEEL_TICK_MS;
+    }
+
+    return evicted;
+}
+
+ExpiryStats ExpiryWheel::getStats() {
+    return stats;
+}
+
+// Into the slot of its deadline, at least one tick past the cursor so a
+// slot being fired never takes on new work. Deadlines beyond one lap land
+// early and re-arm.
+void ExpiryWheel::insertLocked(int32_t index) {
+    Node& node = nodes[index];
+    int32_t ahead = (int32_t)(node.deadline - cursorTime) / (int32_t)EXPIRY_WHEEL_TICK_MS + 1;
+    if (ahead < 1) ahead = 1;
+    if (ahead >= EXPIRY_WHEEL_SLOTS) ahead = EXPIRY_WHEEL_SLOTS - 1;
+
+    size_t slot = (cursor + ahead) % EXPIRY_WHEEL_SLOTS;
+    node.slot = slot;
+    node.prev = -1;
+    node.next = slots[slot];
+    if (node.next >= 0) nodes[node.next].prev = index;
+    slots[slot] = index;
+    node.state = NodeState::ARMED;
+}
+
+void ExpiryWheel::unlinkLocked(int32_t index) {
+    Node& node = nodes[index];
+    if (node.prev >= 0) nodes[node.prev].next = node.next;
+    else slots[node.slot] = node.next;
+    if (node.next >= 0) nodes[node.next].prev = node.prev;
+}
+
+void ExpiryWheel::releaseLocked(int32_t index) {
+    Node& node = nodes[index];
+    std::vector<int32_t>& byKey = tables[(size_t)node.table].byKey;
+    size_t keySlot = node.key & 0xFFFF;
+    if (keySlot < byKey.size() && byKey[keySlot] == index) byKey[keySlot] = -1;
+
+    node.state = NodeState::FREE;
+    node.next = freeList;
+    freeList = index;
+    stats.scheduled--;
+}
@@ -0,0 +1,109 @@
+/**
+ * ShitBird Firmware - Timer-Wheel Expiry
+ *
+ * One hashed timing wheel ages out the WiFi, BLE and LoRa tracking tables.
+ * Tables schedule an entry once, when it is created; seeing it again only
+ * updates its lastSeen, never the wheel. When the entry's slot comes round
+ * the wheel asks the table for lastSeen and either evicts it or re-arms it
+ * for lastSeen + TTL, so each tick costs O(entries due) rather than a sweep
+ * over every table. Deadlines past one revolution simply re-arm once per lap.
+ *
+ * The lookup and evict callbacks run on the task calling advance(), the main
+ * loop; a table that another task writes must lock inside them. The wheel's
+ * own lock is released between the two, so an entry seen again in between
+ * is caught by evict's own check of lastSeen.
+ *
+ * Keys are table handles, (generation << 16) | slot. Each table indexes its
+ * pending timers by the handle's slot, which keeps cancel() O(1).
+ */
+
+#ifndef SHITBIRD_EXPIRY_WHEEL_H
+#define SHITBIRD_EXPIRY_WHEEL_H
+
+#include <Arduino.h>
+#include <functional>
+#include <vector>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "config.h"
+
+enum class ExpiryTable : uint8_t {
+    WIFI_AP,
+    WIFI_CLIENT,
+    WIFI_ASSOC,
+    BLE_DEVICE,
+    LORA_NODE,
+    COUNT
+};
+
+struct ExpiryStats {
+    uint32_t scheduled;   // Entries in the wheel
+    uint32_t evicted;     // Since boot
+    uint32_t rearmed;     // Slot fired but the entry had been seen since
+    uint32_t stale;       // Entry already gone from its table
+};
+
+class ExpiryWheel {
+public:
+    // lastSeen (millis) of the entry with this key; false if it no longer exists
+    typedef std::function<bool(uint64_t key, uint32_t& lastSeen)> LookupFn;
+    // Remove the entry from its table if it was last seen at or before
+    // staleBefore; false if it was seen since or is gone
+    typedef std::function<bool(uint64_t key, uint32_t staleBefore)> EvictFn;
+
+    static void registerTable(ExpiryTable table, uint32_t ttlMs, LookupFn lookup, EvictFn evict);
+    static void setTtl(ExpiryTable table, uint32_t ttlMs);
+    static uint32_t getTtl(ExpiryTable table);
+
+    // Track a newly created entry; ignored until the table is registered
+    static void schedule(ExpiryTable table, uint64_t key, uint32_t lastSeen);
+
+    // Drop the timer of an entry the owner removed itself, e.g. to make room.
+    // A timer already firing is dropped by advance() once its callbacks return.
+    static void cancel(ExpiryTable table, uint64_t key);
+
+    // Drop every pending timer for a table the owner has just emptied
+    static void clear(ExpiryTable table);
+
+    // Fires the slots due by now; returns how many entries were evicted
+    static size_t advance(uint32_t now);
+
+    static ExpiryStats getStats();
+
+private:
+    enum class NodeState : uint8_t { FREE, ARMED, FIRING, CANCELLED };
+
+    struct Node {
+        uint64_t key;
+        uint32_t deadline;
+        int32_t next;          // Next node in the slot (or free list), or -1
+        int32_t prev;          // Previous node in the slot, or -1 at its head
+        uint16_t slot;         // Wheel slot while ARMED
+        ExpiryTable table;
+        NodeState state;
+    };
+
+    struct Table {
+        bool registered;
+        uint32_t ttlMs;
+        LookupFn lookup;
+        EvictFn evict;
+        std::vector<int32_t> byKey;   // Node per handle slot, or -1
+    };
+
+    static Table tables[(size_t)ExpiryTable::COUNT];
+    static std::vector<Node> nodes;
+    static int32_t freeList;
+    static int32_t slots[EXPIRY_WHEEL_SLOTS];
+    static uint32_t cursor;       // Next slot to fire (mod EXPIRY_WHEEL_SLOTS)
+    static uint32_t cursorTime;   // millis() at which it is due
+    static ExpiryStats stats;
+    static SemaphoreHandle_t lock;
+
+    static void ensureLock();
+    static void insertLocked(int32_t index);
+    static void unlinkLocked(int32_t index);
+    static void releaseLocked(int32_t index);
+};
+
+#endif // SHITBIRD_EXPIRY_WHEEL_H
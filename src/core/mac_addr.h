@@ -0,0 +1,81 @@
+/**
+ * ShitBird Firmware - MAC Address Type
+ *
+ * 48-bit hardware address held in a uint64_t: compares, copies and hashes as
+ * an integer, no heap. Convert to text only where it is shown or exported.
+ */
+
+#ifndef SHITBIRD_MAC_ADDR_H
+#define SHITBIRD_MAC_ADDR_H
+
+#include <Arduino.h>
+
+struct MacAddr {
+    uint64_t value;  // Byte 0 of the address in bits 40-47
+
+    MacAddr() : value(0) {}
+    explicit MacAddr(uint64_t v) : value(v & 0xFFFFFFFFFFFFULL) {}
+
+    static MacAddr fromBytes(const uint8_t* mac) {
+        return MacAddr(((uint64_t)mac[0] << 40) | ((uint64_t)mac[1] << 32) |
+                       ((uint64_t)mac[2] << 24) | ((uint64_t)mac[3] << 16) |
+                       ((uint64_t)mac[4] << 8) | (uint64_t)mac[5]);
+    }
+
+    // Accepts "AA:BB:CC:DD:EE:FF" or with '-' separators; zero on parse failure
+    static MacAddr fromString(const char* str) {
+        unsigned int b[6];
+        if (!str || sscanf(str, "%2x%*[:-]%2x%*[:-]%2x%*[:-]%2x%*[:-]%2x%*[:-]%2x",
+                           &b[0], &b[1], &b[2], &b[3], &b[4], &b[5]) != 6) {
+            return MacAddr();
+        }
+        uint8_t mac[6];
+        for (int i = 0; i < 6; i++) mac[i] = (uint8_t)b[i];
+        return fromBytes(mac);
+    }
+    static MacAddr fromString(const String& str) { return fromString(str.c_str()); }
+
+    static MacAddr broadcast() { return MacAddr(0xFFFFFFFFFFFFULL); }
+
+    void toBytes(uint8_t* mac) const {
+        for (int i = 0; i < 6; i++) {
+            mac[i] = (uint8_t)(value >> (40 - 8 * i));
+        }
+    }
+
+    // Writes "AA:BB:CC:DD:EE:FF" into buf (at least 18 bytes)
+    void format(char* buf) const {
+        uint8_t mac[6];
+        toBytes(mac);
+        snprintf(buf, 18, "%02X:%02X:%02X:%02X:%02X:%02X",
+                 mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+    }
+
+    String toString() const {
+        char buf[18];
+        format(buf);
+        return String(buf);
+    }
+
+    uint32_t oui() const { return (uint32_t)(value >> 24); }
+    bool isZero() const { return value == 0; }
+    bool isBroadcast() const { return value == 0xFFFFFFFFFFFFULL; }
+    bool isMulticast() const { return (value >> 40) & 0x01; }
+    bool isLocallyAdministered() const { return (value >> 40) & 0x02; }
+
+    // Well mixed in the low bits, so tables can mask instead of mod.
+    // Shared OUIs make the raw value's high bits nearly constant.
+    uint32_t hash() const {
+        uint64_t h = value;
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDULL;
+        h ^= h >> 33;
+        return (uint32_t)h;
+    }
+
+    bool operator==(const MacAddr& other) const { return value == other.value; }
+    bool operator!=(const MacAddr& other) const { return value != other.value; }
+    bool operator<(const MacAddr& other) const { return value < other.value; }
+};
+
+#endif // SHITBIRD_MAC_ADDR_H
@@ -0,0 +1,276 @@
+/**
+ * ShitBird Firmware - MAC-Keyed Hash Table
+ *
+ * Entries live in a slot array and are found through an open-addressing
+ * (linear probing) index of slot numbers, so lookup is O(1) with no heap
+ * traffic once the table has grown to its working size.
+ *
+ * Handles (slot + generation) stay valid until the entry is erased, even as
+ * the table grows; a handle to an erased entry resolves to nullptr instead of
+ * to whatever reused the slot. Raw pointers are only good until the next
+ * insert.
+ *
+ * Slots live in PSRAM when the board has it; the index stays in internal
+ * RAM. A bounded table (bound()) is allocated once and never grows: insert()
+ * returns nullptr when it is full, and leastValuable() picks the entry to
+ * erase to make room.
+ */
+
+#ifndef SHITBIRD_MAC_TABLE_H
+#define SHITBIRD_MAC_TABLE_H
+
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
+#include "mac_addr.h"
+#include "psram_allocator.h"
+
+typedef uint32_t MacHandle;
+static const MacHandle MAC_HANDLE_INVALID = 0xFFFFFFFF;
+
+// Key is any type with hash() and ==, MacAddr unless given
+template <typename T, typename Key = MacAddr>
+class MacTable {
+    static constexpr uint16_t EMPTY = 0xFFFF;
+
+    struct Slot {
+        Key key;
+        uint16_t generation = 0;
+        bool used = false;
+        T value;
+    };
+
+    typedef std::vector<Slot, PsramAllocator<Slot>> SlotArray;
+
+public:
+    class iterator {
+    public:
+        iterator(SlotArray* slots, size_t pos) : slots(slots), pos(pos) { skip(); }
+        T& operator*() const { return (*slots)[pos].value; }
+        T* operator->() const { return &(*slots)[pos].value; }
+        iterator& operator++() { pos++; skip(); return *this; }
+        bool operator!=(const iterator& other) const { return pos != other.pos; }
+        bool operator==(const iterator& other) const { return pos == other.pos; }
+        MacHandle handle() const { return makeHandle(pos, (*slots)[pos].generation); }
+
+    private:
+        SlotArray* slots;
+        size_t pos;
+        void skip() { while (pos < slots->size() && !(*slots)[pos].used) pos++; }
+    };
+
+    explicit MacTable(size_t expected = 16) {
+        reserve(expected);
+    }
+
+    // Preallocates for `count` entries so inserts up to that size don't allocate
+    void reserve(size_t count) {
+        slots.reserve(count);
+        size_t buckets = 16;
+        while (buckets < count * 2) buckets <<= 1;
+        if (buckets > index.size()) rehash(buckets);
+    }
+
+    // Drops every entry and fixes the table at capacity entries, allocated
+    // now; from then on insert() never allocates and fails when full
+    void bound(size_t capacity) {
+        if (capacity >= EMPTY) capacity = EMPTY - 1;
+        clear();
+
+        // Generations carry over so handles from before stay invalid
+        SlotArray fresh;
+        fresh.reserve(capacity);
+        for (size_t i = 0; i < slots.size() && i < capacity; i++) {
+            fresh.emplace_back();
+            fresh.back().generation = slots[i].generation;
+        }
+        slots.swap(fresh);
+
+        freeSlots = std::vector<uint16_t>();
+        freeSlots.reserve(capacity);
+        for (size_t i = slots.size(); i > 0; i--) freeSlots.push_back((uint16_t)(i - 1));
+
+        size_t buckets = 16;
+        while (buckets < capacity * 2) buckets <<= 1;
+        index = std::vector<uint16_t>(buckets, EMPTY);
+        limit = capacity;
+    }
+
+    // Worst-case bytes per entry of a bounded table: slot, free list and
+    // index buckets, for sizing one from a byte budget
+    static constexpr size_t entryBytes() {
+        return sizeof(Slot) + 5 * sizeof(uint16_t);
+    }
+
+    size_t capacity() const { return limit; }  // 0 while unbounded
+    bool full() const { return limit && count >= limit; }
+
+    // Handle of the entry with the highest cost(value), the one to erase
+    // first; entries costing 0 are kept. Invalid if none can go.
+    template <typename Cost>
+    MacHandle leastValuable(Cost cost) {
+        MacHandle victim = MAC_HANDLE_INVALID;
+        uint32_t highest = 0;
+        for (size_t i = 0; i < slots.size(); i++) {
+            if (!slots[i].used) continue;
+            uint32_t c = cost(slots[i].value);
+            if (c > highest) {
+                highest = c;
+                victim = makeHandle(i, slots[i].generation);
+            }
+        }
+        return victim;
+    }
+
+    T* find(const Key& mac) {
+        uint16_t slot = lookup(mac);
+        return slot == EMPTY ? nullptr : &slots[slot].value;
+    }
+
+    MacHandle findHandle(const Key& mac) const {
+        uint16_t slot = lookup(mac);
+        return slot == EMPTY ? MAC_HANDLE_INVALID : makeHandle(slot, slots[slot].generation);
+    }
+
+    // Existing entry for mac, or a new default-constructed one
+    T* insert(const Key& mac, bool* created = nullptr) {
+        uint16_t slot = lookup(mac);
+        if (created) *created = (slot == EMPTY);
+        if (slot != EMPTY) return &slots[slot].value;
+        if (full()) return nullptr;
+
+        if ((count + 1) * 4 > index.size() * 3) {
+            rehash(index.size() * 2);
+        }
+
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            if (slots.size() >= EMPTY) return nullptr;
+            slot = (uint16_t)slots.size();
+            slots.emplace_back();
+        }
+
+        Slot& s = slots[slot];
+        s.key = mac;
+        s.used = true;
+        s.value = T();
+
+        size_t mask = index.size() - 1;
+        size_t pos = mac.hash() & mask;
+        while (index[pos] != EMPTY) pos = (pos + 1) & mask;
+        index[pos] = slot;
+        count++;
+
+        return &s.value;
+    }
+
+    T* get(MacHandle handle) {
+        size_t slot = handle & 0xFFFF;
+        if (handle == MAC_HANDLE_INVALID || slot >= slots.size()) return nullptr;
+        Slot& s = slots[slot];
+        return (s.used && s.generation == (handle >> 16)) ? &s.value : nullptr;
+    }
+
+    bool erase(const Key& mac) {
+        size_t mask = index.size() - 1;
+        size_t pos = mac.hash() & mask;
+        while (index[pos] != EMPTY) {
+            if (slots[index[pos]].key == mac) {
+                releaseSlot(index[pos]);
+                removeAt(pos);
+                return true;
+            }
+            pos = (pos + 1) & mask;
+        }
+        return false;
+    }
+
+    // Erases every entry for which pred(value) is true; returns how many
+    template <typename Pred>
+    size_t eraseIf(Pred pred) {
+        size_t erased = 0;
+        for (size_t i = 0; i < slots.size(); i++) {
+            if (slots[i].used && pred(slots[i].value)) {
+                erase(slots[i].key);
+                erased++;
+            }
+        }
+        return erased;
+    }
+
+    // Keeps the slots (and their generations) so old handles stay invalid
+    void clear() {
+        for (size_t i = 0; i < slots.size(); i++) {
+            if (slots[i].used) releaseSlot((uint16_t)i);
+        }
+        std::fill(index.begin(), index.end(), EMPTY);
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    iterator begin() { return iterator(&slots, 0); }
+    iterator end() { return iterator(&slots, slots.size()); }
+
+private:
+    SlotArray slots;
+    std::vector<uint16_t> freeSlots;
+    std::vector<uint16_t> index;  // Power-of-two bucket array of slot numbers
+    size_t count = 0;
+    size_t limit = 0;             // Entries a bounded table holds; 0 = grows
+
+    static MacHandle makeHandle(size_t slot, uint16_t generation) {
+        return ((MacHandle)generation << 16) | (MacHandle)slot;
+    }
+
+    uint16_t lookup(const Key& mac) const {
+        size_t mask = index.size() - 1;
+        size_t pos = mac.hash() & mask;
+        while (index[pos] != EMPTY) {
+            if (slots[index[pos]].key == mac) return index[pos];
+            pos = (pos + 1) & mask;
+        }
+        return EMPTY;
+    }
+
+    void releaseSlot(uint16_t slot) {
+        Slot& s = slots[slot];
+        s.used = false;
+        s.value = T();  // Drop any heap the entry owns now, not on reuse
+        s.generation++;
+        if (s.generation == 0xFFFF) s.generation = 0;  // Keep handles != INVALID
+        freeSlots.push_back(slot);
+        count--;
+    }
+
+    // Backward-shift deletion keeps probe chains intact without tombstones
+    void removeAt(size_t pos) {
+        size_t mask = index.size() - 1;
+        size_t next = (pos + 1) & mask;
+        while (index[next] != EMPTY) {
+            size_t home = slots[index[next]].key.hash() & mask;
+            // Move next back into the hole unless its home lies in (pos, next]
+            if (((next - home) & mask) >= ((next - pos) & mask)) {
+                index[pos] = index[next];
+                pos = next;
+            }
+            next = (next + 1) & mask;
+        }
+        index[pos] = EMPTY;
+    }
+
+    void rehash(size_t buckets) {
+        index.assign(buckets, EMPTY);
+        size_t mask = buckets - 1;
+        for (size_t i = 0; i < slots.size(); i++) {
+            if (!slots[i].used) continue;
+            size_t pos = slots[i].key.hash() & mask;
+            while (index[pos] != EMPTY) pos = (pos + 1) & mask;
+            index[pos] = (uint16_t)i;
+        }
+    }
+};
+
+#endif // SHITBIRD_MAC_TABLE_H
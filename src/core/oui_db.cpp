@@ -0,0 +1,83 @@
+/**
+ * ShitBird Firmware - OUI Vendor Database Implementation
+ */
+
+#include "oui_db.h"
+
+const uint8_t* OuiDb::records = nullptr;
+uint32_t OuiDb::count = 0;
+uint16_t OuiDb::stride = 0;
+spi_flash_mmap_handle_t OuiDb::mapHandle = 0;
+
+namespace {
+
+uint32_t get16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+uint32_t get32(const uint8_t* p) { return get16(p) | (get16(p + 2) << 16); }
+
+} // namespace
+
+bool OuiDb::init() {
+    if (records) return true;
+
+    const esp_partition_t* part = esp_partition_find_first(
+        ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)OUI_PARTITION_SUBTYPE, OUI_PARTITION_LABEL);
+    if (!part) {
+        Serial.println("[OUI] No vendor partition");
+        return false;
+    }
+
+    const void* map = nullptr;
+    if (esp_partition_mmap(part, 0, part->size, SPI_FLASH_MMAP_DATA, &map, &mapHandle) != ESP_OK) {
+        Serial.println("[OUI] Failed to map vendor partition");
+        return false;
+    }
+
+    // An erased or foreign partition fails one of these
+    const uint8_t* base = static_cast<const uint8_t*>(map);
+    uint32_t n = get32(base + 4);
+    uint16_t s = get16(base + 8);
+    if (get32(base) != OUI_DB_MAGIC || s < 4 ||
+        OUI_DB_HEADER_SIZE + (uint64_t)n * s > part->size) {
+        Serial.println("[OUI] Vendor partition is empty or invalid");
+        spi_flash_munmap(mapHandle);
+        return false;
+    }
+
+    count = n;
+    stride = s;
+    records = base + OUI_DB_HEADER_SIZE;
+
+    Serial.printf("[OUI] %lu vendors mapped\n", (unsigned long)count);
+    return true;
+}
+
+void OuiDb::deinit() {
+    if (!records) return;
+    records = nullptr;
+    count = 0;
+    spi_flash_munmap(mapHandle);
+}
+
+const char* OuiDb::lookup(uint32_t oui) {
+    if (!records) return nullptr;
+
+    uint32_t lo = 0;
+    uint32_t hi = count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        const uint8_t* rec = records + mid * stride;
+        uint32_t key = ((uint32_t)rec[0] << 16) | (rec[1] << 8) | rec[2];
+        if (key == oui) return reinterpret_cast<const char*>(rec + 3);
+        if (key < oui) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return nullptr;
+}
+
+const char* OuiDb::lookup(const MacAddr& mac) {
+    if (mac.isLocallyAdministered()) return nullptr;
+    return lookup(mac.oui());
+}
@@ -0,0 +1,48 @@
+/**
+ * ShitBird Firmware - OUI Vendor Database
+ *
+ * The IEEE MA-L registry, packed by tools/build_oui.py into a sorted array of
+ * fixed-size records and flashed to its own data partition. The partition is
+ * memory-mapped once at boot; lookups binary-search the mapping in place and
+ * return a pointer into flash, so they need no heap, no copy and no SD card.
+ *
+ * Image layout (little-endian):
+ *   header  magic "OUI1", uint32 count, uint16 stride, uint16 reserved,
+ *           uint32 reserved
+ *   records count * stride bytes, ascending by OUI:
+ *           3-byte OUI (big-endian), vendor name NUL-padded to the stride
+ */
+
+#ifndef SHITBIRD_OUI_DB_H
+#define SHITBIRD_OUI_DB_H
+
+#include <Arduino.h>
+#include <esp_partition.h>
+#include "config.h"
+#include "mac_addr.h"
+
+#define OUI_DB_MAGIC        0x3149554F  // "OUI1"
+#define OUI_DB_HEADER_SIZE  16
+
+class OuiDb {
+public:
+    // Maps the partition; false if it is missing or holds no valid image
+    static bool init();
+    static void deinit();
+
+    static bool isReady() { return records != nullptr; }
+    static uint32_t getCount() { return count; }
+
+    // Vendor name for a 24-bit OUI, or nullptr. Points into the mapping.
+    static const char* lookup(uint32_t oui);
+    // Also nullptr for locally administered (randomized) addresses
+    static const char* lookup(const MacAddr& mac);
+
+private:
+    static const uint8_t* records;
+    static uint32_t count;
+    static uint16_t stride;
+    static spi_flash_mmap_handle_t mapHandle;
+};
+
+#endif // SHITBIRD_OUI_DB_H
@@ -0,0 +1,413 @@
+/**
+ * ShitBird Firmware - Buffered PCAP Writer Implementation
+ */
+
+#include "pcap_writer.h"
+#include "storage.h"
+#include "task_registry.h"
+#include <SD.h>
+#include <sys/time.h>
+
+PcapWriter::PcapWriter()
+    : opened(false), ng(false), interfaces(0), stopping(false), active(0), blockSize(0),
+      blockOffset(0), partialOnCard(false), syncRequested(false), syncIntervalMs(PCAP_WRITER_SYNC_INTERVAL),
+      openedAt(0), lock(nullptr), taskHandle(nullptr) {
+    buffers[0] = buffers[1] = nullptr;
+    fill[0] = fill[1] = 0;
+    full[0] = full[1] = false;
+    memset(&stats, 0, sizeof(stats));
+}
+
+PcapWriter::~PcapWriter() {
+    close();
+}
+
+bool PcapWriter::open(const char* path, uint32_t linkType, size_t blockSize, uint32_t syncIntervalMs) {
+    if (!openFile(path, blockSize, syncIntervalMs)) return false;
+
+    // The file header goes through the buffer too, so block N of the buffer
+    // stream is block N of the file and every full write stays aligned
+    PcapFileHeader header = {
+        .magic = PCAP_MAGIC,
+        .versionMajor = PCAP_VERSION_MAJOR,
+        .versionMinor = PCAP_VERSION_MINOR,
+        .thiszone = 0,
+        .sigfigs = 0,
+        .snaplen = 65535,
+        .network = linkType
+    };
+    append((const uint8_t*)&header, sizeof(header));
+    stats.bytes = sizeof(header);
+
+    startTask();
+    return true;
+}
+
+bool PcapWriter::openNg(const char* path, size_t blockSize, uint32_t syncIntervalMs) {
+    if (!openFile(path, blockSize, syncIntervalMs)) return false;
+    ng = true;
+
+    static const char userAppl[] = FIRMWARE_NAME " " FIRMWARE_VERSION;
+    const uint16_t applLen = sizeof(userAppl) - 1;
+    const uint32_t applPadded = (applLen + 3) & ~3u;
+
+    // Section Header Block: magic, version 1.0, section length unknown (-1),
+    // then shb_userappl and opt_endofopt
+    uint32_t blockLen = 28 + 4 + applPadded + 4;
+    uint32_t head[4] = {PCAPNG_BLOCK_SHB, blockLen, PCAPNG_BYTE_ORDER_MAGIC, 0x00000001};
+    int64_t sectionLen = -1;
+    uint16_t opt[2] = {PCAPNG_OPT_SHB_USERAPPL, applLen};
+    uint32_t end = PCAPNG_OPT_ENDOFOPT;
+
+    append((const uint8_t*)head, sizeof(head));
+    append((const uint8_t*)&sectionLen, sizeof(sectionLen));
+    append((const uint8_t*)opt, sizeof(opt));
+    append((const uint8_t*)userAppl, applLen);
+    appendPadding(applPadded - applLen);
+    append((const uint8_t*)&end, sizeof(end));
+    append((const uint8_t*)&blockLen, sizeof(blockLen));
+    stats.bytes = blockLen;
+
+    startTask();
+    return true;
+}
+
+bool PcapWriter::openFile(const char* path, size_t blockSize, uint32_t syncIntervalMs) {
+    if (!close()) return false;
+    if (!Storage::isMounted()) return false;
+
+    if (blockSize == 0 || blockSize % 512 != 0) {
+        Serial.printf("[PCAP] Invalid block size %u\n", (unsigned)blockSize);
+        return false;
+    }
+
+    // Created once and kept: a producer may be blocked on it during close()
+    if (!lock) {
+        lock = xSemaphoreCreateMutex();
+        if (!lock) return false;
+    }
+
+    for (int i = 0; i < 2; i++) {
+        buffers[i] = (uint8_t*)(psramFound() ? ps_malloc(blockSize) : malloc(blockSize));
+        if (!buffers[i]) {
+            Serial.println("[PCAP] Failed to allocate write buffers");
+            free(buffers[0]);
+            buffers[0] = nullptr;
+            return false;
+        }
+    }
+
+    file = SD.open(path, FILE_WRITE);
+    if (!file) {
+        Serial.printf("[PCAP] Failed to open %s\n", path);
+        free(buffers[0]);
+        free(buffers[1]);
+        buffers[0] = buffers[1] = nullptr;
+        return false;
+    }
+
+    this->blockSize = blockSize;
+    this->syncIntervalMs = syncIntervalMs;
+    fill[0] = fill[1] = 0;
+    full[0] = full[1] = false;
+    active = 0;
+    blockOffset = 0;
+    partialOnCard = false;
+    syncRequested = false;
+    stopping = false;
+    ng = false;
+    interfaces = 0;
+    memset(&stats, 0, sizeof(stats));
+    openedAt = millis();
+    return true;
+}
+
+void PcapWriter::startTask() {
+    opened = true;
+
+    TaskRegistry::spawn(writerTask, "PCAP_Writer", 4096, this, TaskRole::EXPORT, &taskHandle);
+}
+
+bool PcapWriter::close() {
+    if (!opened && !taskHandle) return true;
+
+    if (opened) {
+        // Producers check `opened` under the lock, so none is mid-copy after this
+        xSemaphoreTake(lock, portMAX_DELAY);
+        opened = false;
+        xSemaphoreGive(lock);
+
+        stopping = true;
+    }
+
+    if (taskHandle) {
+        xTaskNotifyGive(taskHandle);
+        for (int i = 0; i < 500 && taskHandle; i++) {
+            vTaskDelay(pdMS_TO_TICKS(10));
+        }
+    }
+
+    if (taskHandle) {
+        // Card hung; the task still owns the buffers and the file, so leave
+        // both to it rather than crash or hand them to the next open()
+        Serial.println("[PCAP] Writer task did not stop");
+        Storage::log("pcap", "Writer task did not stop; capture file left open");
+        return false;
+    }
+
+    free(buffers[0]);
+    free(buffers[1]);
+    buffers[0] = buffers[1] = nullptr;
+    return true;
+}
+
+bool PcapWriter::writePacket(const uint8_t* data, uint32_t len, uint32_t origLen) {
+    if (ng) return writeEnhancedPacket(0, nullptr, 0, data, len, origLen);
+
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+
+    PcapPacketHeader pktHeader = {
+        .tsSec = (uint32_t)tv.tv_sec,
+        .tsUsec = (uint32_t)tv.tv_usec,
+        .inclLen = len,
+        .origLen = origLen ? origLen : len
+    };
+
+    size_t recordLen = sizeof(pktHeader) + len;
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+
+    if (!reserve(recordLen)) {
+        xSemaphoreGive(lock);
+        return false;
+    }
+
+    append((const uint8_t*)&pktHeader, sizeof(pktHeader));
+    append(data, len);
+    stats.packets++;
+    stats.bytes += recordLen;
+
+    xSemaphoreGive(lock);
+    return true;
+}
+
+int PcapWriter::addInterface(uint16_t linkType, uint32_t snaplen, const char* name) {
+    uint16_t nameLen = name ? strlen(name) : 0;
+    uint32_t namePadded = (nameLen + 3) & ~3u;
+
+    // linktype, reserved, snaplen; if_name and opt_endofopt when named
+    uint32_t blockLen = 20 + (nameLen ? 4 + namePadded + 4 : 0);
+    uint32_t head[2] = {PCAPNG_BLOCK_IDB, blockLen};
+    uint16_t type[2] = {linkType, 0};
+    uint16_t opt[2] = {PCAPNG_OPT_IF_NAME, nameLen};
+    uint32_t end = PCAPNG_OPT_ENDOFOPT;
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+
+    if (!ng || interfaces >= PCAPNG_MAX_INTERFACES || !reserve(blockLen)) {
+        xSemaphoreGive(lock);
+        return -1;
+    }
+
+    append((const uint8_t*)head, sizeof(head));
+    append((const uint8_t*)type, sizeof(type));
+    append((const uint8_t*)&snaplen, sizeof(snaplen));
+    if (nameLen) {
+        append((const uint8_t*)opt, sizeof(opt));
+        append((const uint8_t*)name, nameLen);
+        appendPadding(namePadded - nameLen);
+        append((const uint8_t*)&end, sizeof(end));
+    }
+    append((const uint8_t*)&blockLen, sizeof(blockLen));
+    stats.bytes += blockLen;
+    int id = interfaces++;
+
+    xSemaphoreGive(lock);
+    return id;
+}
+
+bool PcapWriter::writeEnhancedPacket(uint32_t interfaceId,
+                                     const uint8_t* header, uint32_t headerLen,
+                                     const uint8_t* data, uint32_t len, uint32_t origLen) {
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    uint64_t ts = (uint64_t)tv.tv_sec * 1000000ULL + tv.tv_usec;
+
+    uint32_t capLen = headerLen + len;
+    uint32_t padded = (capLen + 3) & ~3u;
+    uint32_t blockLen = 32 + padded;
+
+    // type, length, interface, timestamp (high, low), captured, original
+    uint32_t epb[7] = {
+        PCAPNG_BLOCK_EPB, blockLen, interfaceId,
+        (uint32_t)(ts >> 32), (uint32_t)ts,
+        capLen, headerLen + (origLen ? origLen : len)
+    };
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+
+    if (!ng || interfaceId >= interfaces) {
+        xSemaphoreGive(lock);
+        return false;
+    }
+
+    if (!reserve(blockLen)) {
+        xSemaphoreGive(lock);
+        return false;
+    }
+
+    append((const uint8_t*)epb, sizeof(epb));
+    if (headerLen) append(header, headerLen);
+    append(data, len);
+    appendPadding(padded - capLen);
+    append((const uint8_t*)&blockLen, sizeof(blockLen));
+    stats.packets++;
+    stats.bytes += blockLen;
+
+    xSemaphoreGive(lock);
+    return true;
+}
+
+void PcapWriter::flush() {
+    if (!opened) return;
+    syncRequested = true;
+    if (taskHandle) xTaskNotifyGive(taskHandle);
+}
+
+PcapWriterStats PcapWriter::getStats() const {
+    PcapWriterStats s = stats;
+    uint32_t elapsed = millis() - openedAt;
+    s.bytesPerSec = elapsed ? (uint32_t)(s.bytes * 1000 / elapsed) : 0;
+    return s;
+}
+
+// Caller holds the lock. False (and counted as a drop) if the record can't be
+// buffered: room left in the active buffer, plus the other one if it's been
+// written. The active buffer may not fill up while the other is still
+// pending, or two full blocks could reach the writer task out of order.
+bool PcapWriter::reserve(size_t recordLen) {
+    if (!opened) return false;
+
+    size_t space = blockSize - fill[active];
+    if (full[active ^ 1]) {
+        space = space > 0 ? space - 1 : 0;
+    } else {
+        space += blockSize;
+    }
+
+    if (recordLen > space) {
+        stats.dropped++;
+        return false;
+    }
+    return true;
+}
+
+// Caller holds the lock and has reserved room
+void PcapWriter::append(const uint8_t* data, size_t len) {
+    while (len > 0) {
+        size_t n = min(len, blockSize - fill[active]);
+        memcpy(buffers[active] + fill[active], data, n);
+        fill[active] += n;
+        data += n;
+        len -= n;
+
+        if (fill[active] == blockSize) {
+            full[active] = true;
+            active ^= 1;
+            if (taskHandle) xTaskNotifyGive(taskHandle);
+        }
+    }
+}
+
+void PcapWriter::appendPadding(size_t len) {
+    static const uint8_t zeros[4] = {0, 0, 0, 0};
+    if (len) append(zeros, len);
+}
+
+// At most one buffer is full at a time, so this preserves file order
+void PcapWriter::writePendingBlocks() {
+    for (int i = 0; i < 2; i++) {
+        xSemaphoreTake(lock, portMAX_DELAY);
+        bool pending = full[i];
+        xSemaphoreGive(lock);
+
+        if (pending) writeBlock(i);
+    }
+}
+
+void PcapWriter::writeBlock(int index) {
+    uint32_t start = micros();
+
+    // A sync already put the head of this block on the card; overwrite it
+    if (partialOnCard) {
+        file.seek(blockOffset);
+        partialOnCard = false;
+    }
+
+    file.write(buffers[index], blockSize);
+    blockOffset += blockSize;
+    recordLatency(start);
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    fill[index] = 0;
+    full[index] = false;
+    stats.blockWrites++;
+    xSemaphoreGive(lock);
+}
+
+void PcapWriter::syncPartial() {
+    xSemaphoreTake(lock, portMAX_DELAY);
+    bool blockPending = full[0] || full[1];
+    int index = active;
+    size_t len = fill[index];
+    xSemaphoreGive(lock);
+
+    // A pending full block must land first or the offsets below are wrong
+    if (blockPending || len == 0) return;
+
+    uint32_t start = micros();
+
+    if (partialOnCard) {
+        file.seek(blockOffset);
+    }
+
+    // Bytes [0, len) of the active buffer are stable: the producer only appends
+    file.write(buffers[index], len);
+    file.flush();
+    partialOnCard = true;
+    recordLatency(start);
+    stats.syncs++;
+}
+
+void PcapWriter::recordLatency(uint32_t startUs) {
+    uint32_t us = micros() - startUs;
+    stats.lastWriteUs = us;
+    if (us > stats.maxWriteUs) stats.maxWriteUs = us;
+}
+
+void PcapWriter::writerTask(void* param) {
+    PcapWriter* writer = static_cast<PcapWriter*>(param);
+    uint32_t lastSync = millis();
+
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(writer->syncIntervalMs));
+
+        writer->writePendingBlocks();
+        if (writer->stopping) break;
+
+        if (writer->syncRequested || millis() - lastSync >= writer->syncIntervalMs) {
+            writer->syncRequested = false;
+            writer->syncPartial();
+            lastSync = millis();
+        }
+    }
+
+    // Final drain: nothing is appending any more
+    writer->writePendingBlocks();
+    writer->syncPartial();
+    writer->file.close();
+
+    writer->taskHandle = nullptr;
+    TaskRegistry::exit();
+}
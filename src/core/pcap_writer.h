@@ -0,0 +1,128 @@
+/**
+ * ShitBird Firmware - Buffered PCAP Writer
+ *
+ * Keeps one File open per capture and packs records into a pair of large
+ * (PSRAM when available) buffers. A background task writes each buffer as a
+ * single block-aligned SD write, and periodically syncs the partial buffer so
+ * a crash or card pull loses at most one sync interval.
+ *
+ * Writes either classic libpcap (one link type per file) or PCAPNG, where
+ * each source registers an Interface Description Block and its packets go
+ * out as Enhanced Packet Blocks. PCAPNG blocks are self-delimiting, so
+ * interfaces can be added mid-capture without rewriting anything.
+ */
+
+#ifndef SHITBIRD_PCAP_WRITER_H
+#define SHITBIRD_PCAP_WRITER_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "config.h"
+
+#define PCAP_WRITER_SYNC_INTERVAL   2000    // ms between flush() of a partial block
+
+// PCAPNG block types and options (draft-ietf-opsawg-pcapng)
+#define PCAPNG_BLOCK_SHB            0x0A0D0D0A
+#define PCAPNG_BLOCK_IDB            0x00000001
+#define PCAPNG_BLOCK_EPB            0x00000006
+#define PCAPNG_BYTE_ORDER_MAGIC     0x1A2B3C4D
+#define PCAPNG_OPT_ENDOFOPT         0
+#define PCAPNG_OPT_SHB_USERAPPL     4
+#define PCAPNG_OPT_IF_NAME          2
+#define PCAPNG_MAX_INTERFACES       8
+
+struct PcapWriterStats {
+    uint32_t packets;        // Records accepted
+    uint32_t dropped;        // Records lost because both buffers were full
+    uint64_t bytes;          // Bytes accepted, file header included
+    uint32_t blockWrites;    // Full blocks written
+    uint32_t syncs;          // Partial-block flushes
+    uint32_t lastWriteUs;    // Latency of the most recent SD write + flush
+    uint32_t maxWriteUs;     // Worst SD write latency this capture
+    uint32_t bytesPerSec;    // Average since open()
+};
+
+class PcapWriter {
+public:
+    PcapWriter();
+    ~PcapWriter();
+
+    // Creates (truncates) path and starts the writer task. blockSize must be
+    // a multiple of 512 so full blocks land on sector boundaries. Fails while
+    // the task of an earlier capture is still flushing.
+    bool open(const char* path, uint32_t linkType,
+              size_t blockSize = WIFI_PCAP_BUFFER_SIZE,
+              uint32_t syncIntervalMs = PCAP_WRITER_SYNC_INTERVAL);
+
+    // Same, but writes a PCAPNG Section Header; add interfaces before use
+    bool openNg(const char* path,
+                size_t blockSize = WIFI_PCAP_BUFFER_SIZE,
+                uint32_t syncIntervalMs = PCAP_WRITER_SYNC_INTERVAL);
+
+    // Drains both buffers to the card and closes the file. False if the
+    // writer task hasn't finished (card hung); the writer stays unusable
+    // until a later close() finds it gone.
+    bool close();
+    bool isOpen() const { return opened; }
+    bool isNg() const { return ng; }
+
+    // PCAPNG only: writes an Interface Description Block and returns its
+    // interface id, or -1. Timestamps use the default microsecond resolution.
+    int addInterface(uint16_t linkType, uint32_t snaplen = 0, const char* name = nullptr);
+
+    // Copies one record into the active buffer; never touches the SD card.
+    // origLen defaults to len (frame not truncated). In PCAPNG mode the
+    // record is an Enhanced Packet Block on interface 0.
+    bool writePacket(const uint8_t* data, uint32_t len, uint32_t origLen = 0);
+
+    // PCAPNG only: one Enhanced Packet Block whose data is a link-layer
+    // pseudo-header (radiotap, LoRaTap, ...) followed by the frame. origLen
+    // is the untruncated frame length, pseudo-header excluded.
+    bool writeEnhancedPacket(uint32_t interfaceId,
+                             const uint8_t* header, uint32_t headerLen,
+                             const uint8_t* data, uint32_t len, uint32_t origLen = 0);
+
+    // Ask the writer task to sync the partial block now
+    void flush();
+
+    PcapWriterStats getStats() const;
+
+private:
+    File file;
+    bool opened;
+    bool ng;
+    uint32_t interfaces;     // IDBs written so far (PCAPNG)
+    volatile bool stopping;
+
+    uint8_t* buffers[2];
+    size_t fill[2];
+    bool full[2];            // Waiting for the writer task
+    int active;              // Buffer the producer appends to
+    size_t blockSize;
+    uint32_t blockOffset;    // File offset of the next full block
+    bool partialOnCard;      // Bytes past blockOffset already written by a sync
+    volatile bool syncRequested;
+
+    uint32_t syncIntervalMs;
+    uint32_t openedAt;
+    PcapWriterStats stats;
+
+    SemaphoreHandle_t lock;
+    TaskHandle_t taskHandle;
+
+    bool openFile(const char* path, size_t blockSize, uint32_t syncIntervalMs);
+    void startTask();
+    bool reserve(size_t recordLen);
+    void append(const uint8_t* data, size_t len);
+    void appendPadding(size_t len);
+    void writePendingBlocks();
+    void writeBlock(int index);
+    void syncPartial();
+    void recordLatency(uint32_t startUs);
+
+    static void writerTask(void* param);
+};
+
+#endif // SHITBIRD_PCAP_WRITER_H
@@ -0,0 +1,43 @@
+/**
+ * ShitBird Firmware - PSRAM Allocator
+ *
+ * Allocator for std containers holding bulk table data: storage comes from
+ * PSRAM when the board has it and from the internal heap otherwise, or when
+ * PSRAM is exhausted. Meant for arrays sized once; psramFound() is only
+ * true once the Arduino core has started, so reserve from init(), not from
+ * a static constructor.
+ */
+
+#ifndef SHITBIRD_PSRAM_ALLOCATOR_H
+#define SHITBIRD_PSRAM_ALLOCATOR_H
+
+#include <Arduino.h>
+#include <stdlib.h>
+
+template <typename T>
+struct PsramAllocator {
+    typedef T value_type;
+
+    PsramAllocator() = default;
+    template <typename U>
+    PsramAllocator(const PsramAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        size_t bytes = n * sizeof(T);
+        void* p = psramFound() ? ps_malloc(bytes) : nullptr;
+        if (!p) p = malloc(bytes);
+        if (!p) abort();  // As std::allocator does without exceptions
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, size_t) {
+        free(p);
+    }
+
+    template <typename U>
+    bool operator==(const PsramAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const PsramAllocator<U>&) const { return false; }
+};
+
+#endif // SHITBIRD_PSRAM_ALLOCATOR_H
@@ -0,0 +1,228 @@
+/**
+ * ShitBird Firmware - WiFi/BLE Radio Scheduler Implementation
+ */
+
+#include "radio_scheduler.h"
+#include "task_registry.h"
+#include "../ui/ui_manager.h"
+#include <esp_coexist.h>
+
+#if ENABLE_WIFI
+#include "../modules/wifi/wifi_module.h"
+#endif
+#if ENABLE_BLE
+#include "../modules/ble/ble_module.h"
+#endif
+
+TaskHandle_t RadioScheduler::taskHandle = nullptr;
+bool RadioScheduler::slicing = false;
+uint32_t RadioScheduler::wifiAirMs = 0;
+uint32_t RadioScheduler::wifiSince = 0;
+bool RadioScheduler::wifiHasRadio = true;
+RadioYield RadioScheduler::wifiYield = {};
+RadioYield RadioScheduler::bleYield = {};
+portMUX_TYPE RadioScheduler::mux = portMUX_INITIALIZER_UNLOCKED;
+
+namespace {
+
+bool wifiRunning() {
+#if ENABLE_WIFI
+    return WiFiModule::isMonitoring();
+#else
+    return false;
+#endif
+}
+
+bool bleRunning() {
+#if ENABLE_BLE
+    return BLEModule::isScanning();
+#else
+    return false;
+#endif
+}
+
+uint32_t wifiPackets() {
+#if ENABLE_WIFI
+    return WiFiModule::getRxStats().received;
+#else
+    return 0;
+#endif
+}
+
+uint32_t blePackets() {
+#if ENABLE_BLE
+    return BLEModule::getScanStats().received;
+#else
+    return 0;
+#endif
+}
+
+// Counters restart with each monitor session or scan
+uint32_t delta(uint32_t before, uint32_t after) {
+    return after >= before ? after - before : after;
+}
+
+void fillRate(RadioYield& y) {
+    y.perSecond = y.airMs ? y.packets * 1000.0f / y.airMs : 0.0f;
+}
+
+} // namespace
+
+void RadioScheduler::init() {
+    if (taskHandle) return;
+    TaskRegistry::spawn(schedulerTask, "Radio_Sched", 3072, nullptr, TaskRole::RADIO, &taskHandle);
+}
+
+void RadioScheduler::setEnabled(bool enabled) {
+    g_systemState.settings.coex.enabled = enabled;
+    g_systemState.saveSettings();
+}
+
+uint8_t RadioScheduler::getWiFiShare(Profile profile) {
+    uint8_t i = (uint8_t)profile;
+    return i < PROFILE_COUNT ? g_systemState.settings.coex.wifiShare[i] : COEX_SHARE_DEFAULT;
+}
+
+void RadioScheduler::setWiFiShare(Profile profile, uint8_t percent) {
+    uint8_t i = (uint8_t)profile;
+    if (i >= PROFILE_COUNT) return;
+    g_systemState.settings.coex.wifiShare[i] = min(percent, (uint8_t)100);
+    g_systemState.saveSettings();
+    resetStats();
+}
+
+uint32_t RadioScheduler::wifiAirtime(uint32_t now) {
+    portENTER_CRITICAL(&mux);
+    uint32_t airtime = wifiAirMs + (wifiHasRadio ? now - wifiSince : 0);
+    portEXIT_CRITICAL(&mux);
+    return airtime;
+}
+
+RadioSchedulerStats RadioScheduler::getStats() {
+    RadioSchedulerStats stats;
+    stats.slicing = slicing;
+    stats.wifiShare = getWiFiShare(g_systemState.settings.activeProfile);
+    stats.cycleMs = g_systemState.settings.coex.cycleMs;
+
+    portENTER_CRITICAL(&mux);
+    stats.wifi = wifiYield;
+    stats.ble = bleYield;
+    portEXIT_CRITICAL(&mux);
+
+    fillRate(stats.wifi);
+    fillRate(stats.ble);
+    return stats;
+}
+
+void RadioScheduler::resetStats() {
+    portENTER_CRITICAL(&mux);
+    wifiYield = {};
+    bleYield = {};
+    portEXIT_CRITICAL(&mux);
+}
+
+void RadioScheduler::giveWiFiRadio(bool wifi, uint32_t now) {
+    portENTER_CRITICAL(&mux);
+    if (wifiHasRadio && !wifi) {
+        wifiAirMs += now - wifiSince;
+    } else if (!wifiHasRadio && wifi) {
+        wifiSince = now;
+    }
+    wifiHasRadio = wifi;
+    portEXIT_CRITICAL(&mux);
+}
+
+void RadioScheduler::schedulerTask(void* param) {
+    for (;;) {
+        const CoexSettings& coex = g_systemState.settings.coex;
+        uint16_t cycleMs = max(coex.cycleMs, (uint16_t)(2 * COEX_MIN_SLICE_MS));
+
+        // One radio (or none) has it to itself; nothing to split
+        if (!coex.enabled || !wifiRunning() || !bleRunning()) {
+            if (slicing) stopSlicing();
+            vTaskDelay(pdMS_TO_TICKS(cycleMs));
+            continue;
+        }
+        slicing = true;
+
+        uint32_t wifiMs = (uint32_t)cycleMs * getWiFiShare(g_systemState.settings.activeProfile) / 100;
+        if (wifiMs < COEX_MIN_SLICE_MS) wifiMs = 0;
+        if (cycleMs - wifiMs < COEX_MIN_SLICE_MS) wifiMs = cycleMs;
+
+        if (wifiMs) runSlice(true, wifiMs);
+        if (cycleMs > wifiMs) runSlice(false, cycleMs - wifiMs);
+    }
+}
+
+// Hands the radio to one side for ms and counts what both delivered
+void RadioScheduler::runSlice(bool wifi, uint32_t ms) {
+    esp_coex_preference_set(wifi ? ESP_COEX_PREFER_WIFI : ESP_COEX_PREFER_BT);
+#if ENABLE_BLE
+    BLEModule::pauseScan(wifi);
+#endif
+
+    uint32_t start = millis();
+    giveWiFiRadio(wifi, start);
+    uint32_t wifiBefore = wifiPackets();
+    uint32_t bleBefore = blePackets();
+
+    vTaskDelay(pdMS_TO_TICKS(ms));
+
+    uint32_t elapsed = millis() - start;
+    uint32_t wifiDelta = delta(wifiBefore, wifiPackets());
+    uint32_t bleDelta = delta(bleBefore, blePackets());
+
+    portENTER_CRITICAL(&mux);
+    RadioYield& own = wifi ? wifiYield : bleYield;
+    own.slices++;
+    own.airMs += elapsed;
+    own.packets += wifi ? wifiDelta : bleDelta;
+    (wifi ? bleYield : wifiYield).leaked += wifi ? bleDelta : wifiDelta;
+    portEXIT_CRITICAL(&mux);
+}
+
+// Back to the arbiter, with the BLE scan (if still on) running again
+void RadioScheduler::stopSlicing() {
+    slicing = false;
+    esp_coex_preference_set(ESP_COEX_PREFER_BALANCE);
+#if ENABLE_BLE
+    BLEModule::pauseScan(false);
+#endif
+    giveWiFiRadio(true, millis());
+}
+
+// ============================================================================
+// Menu Integration
+// ============================================================================
+
+void RadioScheduler::buildMenu(void* menuPtr) {
+    MenuScreen* menu = static_cast<MenuScreen*>(menuPtr);
+
+    menu->addItem(MenuItem("Coex Slicing", []() {
+        RadioScheduler::setEnabled(!RadioScheduler::isEnabled());
+        UIManager::showMessage("Coex", RadioScheduler::isEnabled() ? "WiFi/BLE time slicing on"
+                                                                   : "Left to the arbiter");
+    }));
+
+    // Steps the active profile's WiFi share 10..90%
+    menu->addItem(MenuItem("Coex Split", []() {
+        Profile profile = g_systemState.settings.activeProfile;
+        uint8_t share = RadioScheduler::getWiFiShare(profile);
+        share = share >= 90 ? 10 : (share / 10 + 1) * 10;
+        RadioScheduler::setWiFiShare(profile, share);
+
+        char msg[40];
+        snprintf(msg, sizeof(msg), "WiFi %u%% BLE %u%%", share, 100 - share);
+        UIManager::showMessage("Coex Split", msg);
+    }));
+
+    menu->addItem(MenuItem("Coex Yield", []() {
+        RadioSchedulerStats stats = RadioScheduler::getStats();
+        char msg[96];
+        snprintf(msg, sizeof(msg), "%s %u/%u%% of %ums\nWiFi %.0f/s +%lu off\nBLE %.0f/s +%lu off",
+                 stats.slicing ? "Slicing" : "Idle", stats.wifiShare, 100 - stats.wifiShare,
+                 stats.cycleMs, stats.wifi.perSecond, (unsigned long)stats.wifi.leaked,
+                 stats.ble.perSecond, (unsigned long)stats.ble.leaked);
+        UIManager::showMessage("Coex Yield", msg);
+    }));
+}
@@ -0,0 +1,84 @@
+/**
+ * ShitBird Firmware - WiFi/BLE Radio Scheduler
+ *
+ * WiFi monitor mode and BLE scanning share the ESP32-S3's one 2.4 GHz
+ * radio. Left to the coexistence arbiter both lose packets, so while both
+ * run this owns the coexistence preference and splits time explicitly: each
+ * cycle is a WiFi slice (BLE scan paused, WiFi preferred) followed by a BLE
+ * slice (scan running, BT preferred). The split is a per-profile WiFi share
+ * in g_systemState.settings.coex.
+ *
+ * Packets each radio delivers are counted per slice, so the yield of a
+ * split can be read back and the shares tuned. The channel hop measures
+ * its dwell in WiFi slice time (wifiAirtime()), so a dwell isn't spent with
+ * the radio on BLE.
+ */
+
+#ifndef SHITBIRD_RADIO_SCHEDULER_H
+#define SHITBIRD_RADIO_SCHEDULER_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include "config.h"
+#include "system.h"
+
+// What one radio got out of its slices
+struct RadioYield {
+    uint32_t slices;
+    uint32_t airMs;       // Time its slices have had
+    uint32_t packets;     // Delivered during its own slices
+    uint32_t leaked;      // Delivered during the other radio's slices
+    float perSecond;      // packets per second of airMs
+};
+
+struct RadioSchedulerStats {
+    bool slicing;         // Both radios running and the split in force
+    uint8_t wifiShare;    // Of the active profile, percent
+    uint16_t cycleMs;
+    RadioYield wifi;      // Frames from the promiscuous callback
+    RadioYield ble;       // Advertising reports
+};
+
+class RadioScheduler {
+public:
+    // Spawns the scheduler; it idles until WiFi monitor and BLE scan both run
+    static void init();
+
+    // Off hands the radio back to the arbiter's balanced preference
+    static void setEnabled(bool enabled);
+    static bool isEnabled() { return g_systemState.settings.coex.enabled; }
+
+    // WiFi percent of each cycle under a profile; setting it saves settings
+    static uint8_t getWiFiShare(Profile profile);
+    static void setWiFiShare(Profile profile, uint8_t percent);
+
+    // Milliseconds the radio has been WiFi's; keeps pace with millis() while
+    // not slicing. Safe from any task.
+    static uint32_t wifiAirtime(uint32_t now);
+
+    static RadioSchedulerStats getStats();
+    static void resetStats();
+
+    // Menu integration
+    static void buildMenu(void* menuScreen);
+
+private:
+    static TaskHandle_t taskHandle;
+    static bool slicing;
+
+    // wifiAirtime() = wifiAirMs, plus now - wifiSince while WiFi has the radio
+    static uint32_t wifiAirMs;
+    static uint32_t wifiSince;
+    static bool wifiHasRadio;
+
+    static RadioYield wifiYield;
+    static RadioYield bleYield;
+    static portMUX_TYPE mux;
+
+    static void schedulerTask(void* param);
+    static void runSlice(bool wifi, uint32_t ms);
+    static void stopSlicing();
+    static void giveWiFiRadio(bool wifi, uint32_t now);
+};
+
+#endif // SHITBIRD_RADIO_SCHEDULER_H
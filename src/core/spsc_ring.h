@@ -0,0 +1,73 @@
+/**
+ * ShitBird Firmware - Single-Producer/Single-Consumer Ring Buffer
+ *
+ * Fixed-capacity, lock-free queue of preallocated slots. The producer fills a
+ * slot in place (acquire/publish) and the consumer reads it in place
+ * (front/pop), so nothing is allocated or copied twice. Safe for exactly one
+ * producer context and one consumer context, which may run on different cores.
+ */
+
+#ifndef SHITBIRD_SPSC_RING_H
+#define SHITBIRD_SPSC_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+template <typename T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscRing capacity must be a power of two");
+
+public:
+    // Producer: next free slot, or nullptr if the ring is full
+    T* acquire() {
+        uint32_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) >= Capacity) {
+            return nullptr;
+        }
+        return &slots_[head & (Capacity - 1)];
+    }
+
+    // Producer: make the slot returned by acquire() visible to the consumer
+    void publish() {
+        head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Consumer: oldest published slot, or nullptr if empty
+    const T* front() const {
+        uint32_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &slots_[tail & (Capacity - 1)];
+    }
+
+    // Consumer: release the slot returned by front()
+    void pop() {
+        tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Approximate when called concurrently with either side
+    size_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    bool empty() const { return size() == 0; }
+    static constexpr size_t capacity() { return Capacity; }
+
+    // Only when neither side is running
+    void reset() {
+        head_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    T slots_[Capacity];
+
+    // Separate cache lines so the two cores don't contend on one line
+    alignas(32) std::atomic<uint32_t> head_{0};
+    alignas(32) std::atomic<uint32_t> tail_{0};
+};
+
+#endif // SHITBIRD_SPSC_RING_H
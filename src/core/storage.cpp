@@ -80,7 +80,8 @@ void Storage::createDirectories() {
         PATH_IR_CODES,
         PATH_LORA,
         PATH_SETTINGS,
-        PATH_THEMES
+        PATH_THEMES,
+        PATH_WARDRIVE
     };
 
     for (const char* dir : dirs) {
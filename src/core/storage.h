@@ -20,6 +20,7 @@
 #define PATH_LORA           "/lora"
 #define PATH_SETTINGS       "/settings"
 #define PATH_THEMES         "/themes"
+#define PATH_WARDRIVE       "/wardrive"
 
 // PCAP file header magic
 #define PCAP_MAGIC          0xA1B2C3D4
@@ -27,6 +28,9 @@
 #define PCAP_VERSION_MINOR  4
 #define PCAP_LINKTYPE_IEEE802_11  105
 #define PCAP_LINKTYPE_BLUETOOTH   201
+#define PCAP_LINKTYPE_IEEE802_11_RADIOTAP   127
+#define PCAP_LINKTYPE_BLUETOOTH_LE_LL_PHDR  256
+#define PCAP_LINKTYPE_LORATAP               270
 
 // PCAP file header structure
 struct __attribute__((packed)) PcapFileHeader {
@@ -28,6 +28,14 @@ void SystemState::loadSettings() {
     settings.ble.spamInterval = prefs.getUShort("ble_spam_int", BLE_SPAM_INTERVAL);
     settings.ble.autoEnumerate = prefs.getBool("ble_auto_enum", false);
 
+    // Radio coexistence
+    settings.coex.enabled = prefs.getBool("coex_en", true);
+    settings.coex.cycleMs = prefs.getUShort("coex_cycle", COEX_CYCLE_MS);
+    if (prefs.getBytes("coex_share", settings.coex.wifiShare, sizeof(settings.coex.wifiShare)) !=
+        sizeof(settings.coex.wifiShare)) {
+        memcpy(settings.coex.wifiShare, COEX_DEFAULT_SHARES, sizeof(settings.coex.wifiShare));
+    }
+
     // LoRa settings
     settings.lora.enabled = prefs.getBool("lora_en", true);
     settings.lora.frequency = prefs.getFloat("lora_freq", LORA_FREQUENCY);
@@ -105,6 +113,11 @@ void SystemState::saveSettings() {
     prefs.putUShort("ble_spam_int", settings.ble.spamInterval);
     prefs.putBool("ble_auto_enum", settings.ble.autoEnumerate);
 
+    // Radio coexistence
+    prefs.putBool("coex_en", settings.coex.enabled);
+    prefs.putUShort("coex_cycle", settings.coex.cycleMs);
+    prefs.putBytes("coex_share", settings.coex.wifiShare, sizeof(settings.coex.wifiShare));
+
     // LoRa settings
     prefs.putBool("lora_en", settings.lora.enabled);
     prefs.putFloat("lora_freq", settings.lora.frequency);
@@ -37,6 +37,14 @@ enum class Profile {
     CUSTOM              // User-defined
 };
 
+const uint8_t PROFILE_COUNT = (uint8_t)Profile::CUSTOM + 1;
+
+// WiFi % of each RadioScheduler cycle, by Profile
+const uint8_t COEX_DEFAULT_SHARES[PROFILE_COUNT] = {
+    COEX_SHARE_RECON, COEX_SHARE_WIFI, COEX_SHARE_BLE_HUNT, COEX_SHARE_DEFAULT,
+    COEX_SHARE_DEFAULT, COEX_SHARE_DEFAULT, COEX_SHARE_DEFAULT
+};
+
 enum class Theme {
     HACKER,         // Green on black
     CYBERPUNK,      // Cyan/magenta on dark
@@ -78,6 +86,12 @@ struct BLESettings {
     bool autoEnumerate;
 };
 
+struct CoexSettings {
+    bool enabled;                       // RadioScheduler time-slices the radio
+    uint16_t cycleMs;
+    uint8_t wifiShare[PROFILE_COUNT];   // WiFi % of each cycle, by Profile
+};
+
 struct LoRaSettings {
     bool enabled;
     float frequency;
@@ -124,6 +138,7 @@ struct DisplaySettings {
 struct SystemSettings {
     WiFiSettings wifi;
     BLESettings ble;
+    CoexSettings coex;
     LoRaSettings lora;
     IRSettings ir;
     AudioSettings audio;
@@ -151,6 +166,8 @@ public:
     SystemState() {
         settings.wifi = {true, 1, 100, 100, true, true};
         settings.ble = {true, 10, 20, false};
+        settings.coex = {true, COEX_CYCLE_MS, {}};
+        memcpy(settings.coex.wifiShare, COEX_DEFAULT_SHARES, sizeof(settings.coex.wifiShare));
         settings.lora = {true, 915.0f, 125.0f, 7, 5, 22, true};
         settings.ir = {true, 2, 1, false};
         settings.audio = {true, 50, true, true};
@@ -175,6 +192,7 @@ public:
     // Statistics
     uint32_t packetsCapture = 0;
     uint32_t deauthsSent = 0;
+    uint32_t deauthsDetected = 0;
     uint32_t beaconsSent = 0;
     uint32_t bleDevicesFound = 0;
 
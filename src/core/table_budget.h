@@ -0,0 +1,37 @@
+/**
+ * ShitBird Firmware - Tracking Table Budgets
+ *
+ * The AP, client, BLE device and mesh node tables are each fixed at what
+ * their byte budget in config.h holds, allocated when the module starts.
+ * A newcomer at a full table takes the place of the least valuable entry:
+ * the one unheard longest, then the weakest. Targets the user has selected
+ * are never given up; with nothing else left the newcomer is refused. A
+ * long session in a crowd then runs at a steady footprint instead of
+ * growing until an allocation fails.
+ */
+
+#ifndef SHITBIRD_TABLE_BUDGET_H
+#define SHITBIRD_TABLE_BUDGET_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+struct TableStats {
+    const char* name;
+    uint32_t capacity;    // Entries the budget holds
+    uint32_t size;
+    uint32_t bytes;       // Budget the capacity was sized from
+    uint32_t evicted;     // Entries given up for a newcomer, since boot
+    uint32_t refused;     // Newcomers dropped with nothing to give up
+};
+
+// How readily an entry is given up: seconds unheard plus dB below -30 dBm,
+// so one silent for a minute goes before a faint one heard just now. Never
+// 0, which MacTable::leastValuable() reads as "keep".
+inline uint32_t evictionCost(int32_t rssi, uint32_t lastSeen, uint32_t now) {
+    int32_t weakness = -30 - rssi;
+    if (weakness < 0) weakness = 0;
+    return (now - lastSeen) / 1000 + (uint32_t)weakness + 1;
+}
+
+#endif // SHITBIRD_TABLE_BUDGET_H
@@ -0,0 +1,218 @@
+/**
+ * ShitBird Firmware - Task Registry Implementation
+ */
+
+#include "task_registry.h"
+
+TaskRegistry::Entry TaskRegistry::entries[TASK_REGISTRY_SLOTS] = {};
+uint32_t TaskRegistry::nextSerial = 0;
+portMUX_TYPE TaskRegistry::mux = portMUX_INITIALIZER_UNLOCKED;
+
+uint8_t TaskRegistry::coreFor(TaskRole role) {
+    switch (role) {
+        case TaskRole::RADIO:
+        case TaskRole::ATTACK:
+            return CORE_RADIO;
+        default:
+            return CORE_APP;
+    }
+}
+
+uint8_t TaskRegistry::priorityFor(TaskRole role) {
+    switch (role) {
+        case TaskRole::RADIO: return TASK_PRIO_RADIO;
+        case TaskRole::ATTACK: return TASK_PRIO_ATTACK;
+        case TaskRole::PARSER: return TASK_PRIO_PARSER;
+        case TaskRole::EXPORT: return TASK_PRIO_EXPORT;
+        case TaskRole::PERIPHERAL: return TASK_PRIO_PERIPHERAL;
+        default: return TASK_PRIO_LOOP;
+    }
+}
+
+const char* TaskRegistry::roleName(TaskRole role) {
+    switch (role) {
+        case TaskRole::RADIO: return "radio";
+        case TaskRole::ATTACK: return "attack";
+        case TaskRole::PARSER: return "parser";
+        case TaskRole::EXPORT: return "export";
+        case TaskRole::PERIPHERAL: return "periph";
+        case TaskRole::LOOP: return "loop";
+        default: return "system";
+    }
+}
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+bool TaskRegistry::spawn(TaskFunction_t fn, const char* name, uint32_t stackSize,
+                         void* param, TaskRole role, TaskHandle_t* handle) {
+    TaskHandle_t local = nullptr;
+    TaskHandle_t* target = handle ? handle : &local;
+
+    portENTER_CRITICAL(&mux);
+    Entry* slot = nullptr;
+    for (auto& e : entries) {
+        if (!e.handle && !e.fn) {
+            slot = &e;
+            break;
+        }
+    }
+    uint32_t serial = 0;
+    if (slot) {
+        *slot = Entry();
+        slot->fn = fn;
+        slot->param = param;
+        slot->role = role;
+        slot->stackSize = stackSize;
+        slot->serial = serial = ++nextSerial;
+    }
+    portEXIT_CRITICAL(&mux);
+
+    BaseType_t ok;
+    if (slot) {
+        ok = xTaskCreatePinnedToCore(trampoline, name, stackSize, slot, priorityFor(role), target, coreFor(role));
+    } else {
+        Serial.printf("[TASK] Registry full, %s not tracked\n", name);
+        ok = xTaskCreatePinnedToCore(fn, name, stackSize, param, priorityFor(role), target, coreFor(role));
+    }
+
+    if (slot) {
+        // The task records its own handle when it starts; this covers a
+        // kill() that comes before it gets to. A task that has already run
+        // and exited freed the slot, which the serial shows.
+        portENTER_CRITICAL(&mux);
+        if (slot->serial == serial) {
+            if (ok != pdPASS) *slot = Entry();
+            else if (!slot->handle) slot->handle = *target;
+        }
+        portEXIT_CRITICAL(&mux);
+    }
+
+    if (ok != pdPASS) {
+        Serial.printf("[TASK] Failed to create %s (%lu bytes)\n", name, (unsigned long)stackSize);
+        *target = nullptr;
+        return false;
+    }
+    return true;
+}
+
+// Every spawned task starts here, so it's registered before its own code runs
+void TaskRegistry::trampoline(void* param) {
+    Entry* e = static_cast<Entry*>(param);
+
+    portENTER_CRITICAL(&mux);
+    e->handle = xTaskGetCurrentTaskHandle();
+    TaskFunction_t fn = e->fn;
+    void* arg = e->param;
+    portEXIT_CRITICAL(&mux);
+
+    fn(arg);
+    exit();  // In case fn returns rather than calling exit() itself
+}
+
+void TaskRegistry::adopt(TaskHandle_t handle, TaskRole role, uint32_t stackSize) {
+    if (!handle) return;
+
+    portENTER_CRITICAL(&mux);
+    Entry* slot = nullptr;
+    for (auto& e : entries) {
+        if (e.handle == handle) {
+            slot = &e;
+            break;
+        }
+        if (!slot && !e.handle && !e.fn) slot = &e;
+    }
+    if (slot) {
+        slot->handle = handle;
+        slot->role = role;
+        slot->stackSize = stackSize;
+    }
+    portEXIT_CRITICAL(&mux);
+
+    if (!slot) Serial.println("[TASK] Registry full, task not tracked");
+}
+
+void TaskRegistry::kill(TaskHandle_t& handle) {
+    if (!handle) return;
+    forget(handle);
+    vTaskDelete(handle);
+    handle = nullptr;
+}
+
+void TaskRegistry::exit() {
+    forget(xTaskGetCurrentTaskHandle());
+    vTaskDelete(nullptr);
+}
+
+// Waits out a snapshot() querying the task, so it isn't deleted under it
+void TaskRegistry::forget(TaskHandle_t handle) {
+    if (!handle) return;
+
+    for (;;) {
+        bool busy = false;
+        portENTER_CRITICAL(&mux);
+        for (auto& e : entries) {
+            if (e.handle != handle) continue;
+            if (e.busy) busy = true;
+            else e = Entry();
+        }
+        portEXIT_CRITICAL(&mux);
+
+        if (!busy) return;
+        vTaskDelay(1);
+    }
+}
+
+// ============================================================================
+// Reporting
+// ============================================================================
+
+size_t TaskRegistry::snapshot(TaskInfo* out, size_t max) {
+    uint8_t marked[TASK_REGISTRY_SLOTS];
+    size_t n = 0;
+
+    // Copy the handles out and mark them busy: forget(), which comes before
+    // any delete, waits until they're released, so each stays alive
+    portENTER_CRITICAL(&mux);
+    for (size_t i = 0; i < TASK_REGISTRY_SLOTS; i++) {
+        Entry& e = entries[i];
+        if (!e.handle || n == max) continue;
+        e.busy++;
+        marked[n] = (uint8_t)i;
+        TaskInfo& t = out[n++];
+        t.handle = e.handle;
+        t.role = e.role;
+        t.stackSize = e.stackSize;
+    }
+    portEXIT_CRITICAL(&mux);
+
+    // The high-water mark scans the stack, so interrupts stay on for it
+    for (size_t i = 0; i < n; i++) {
+        TaskInfo& t = out[i];
+        strncpy(t.name, pcTaskGetName(t.handle), sizeof(t.name) - 1);
+        t.name[sizeof(t.name) - 1] = '\0';
+        BaseType_t affinity = xTaskGetAffinity(t.handle);
+        t.core = affinity == tskNO_AFFINITY ? -1 : (int8_t)affinity;
+        t.priority = uxTaskPriorityGet(t.handle);
+        t.stackFree = uxTaskGetStackHighWaterMark(t.handle);  // Bytes on ESP-IDF
+    }
+
+    portENTER_CRITICAL(&mux);
+    for (size_t i = 0; i < n; i++) entries[marked[i]].busy--;
+    portEXIT_CRITICAL(&mux);
+    return n;
+}
+
+void TaskRegistry::logSummary() {
+    static TaskInfo tasks[TASK_REGISTRY_SLOTS];
+    size_t count = snapshot(tasks, TASK_REGISTRY_SLOTS);
+
+    Serial.printf("[TASK] %u tasks tracked\n", (unsigned)count);
+    for (size_t i = 0; i < count; i++) {
+        const TaskInfo& t = tasks[i];
+        Serial.printf("[TASK]   %-16s %-6s core %d prio %u stack %lu free %lu\n",
+                      t.name, roleName(t.role), t.core, t.priority,
+                      (unsigned long)t.stackSize, (unsigned long)t.stackFree);
+    }
+}
@@ -0,0 +1,91 @@
+/**
+ * ShitBird Firmware - Task Registry
+ *
+ * Every long-running task is created through here, so where it runs follows
+ * from what it does rather than from numbers at each call site:
+ *
+ *   Core 0 (CORE_RADIO)  WiFi/BT controllers and the callbacks they deliver,
+ *                        which only copy into rings; tasks that drive a
+ *                        radio (channel hop, LoRa sweeps, transmit loops).
+ *   Core 1 (CORE_APP)    Parse/aggregate workers, then export (PCAP) and
+ *                        local peripherals (USB HID), then loop() with the
+ *                        UI at the bottom.
+ *
+ * The registry also keeps the handles of tasks created elsewhere (loopTask,
+ * the NimBLE host), so one snapshot shows every task's core, priority and
+ * stack high-water mark when WiFi, BLE and LoRa capture run together.
+ */
+
+#ifndef SHITBIRD_TASK_REGISTRY_H
+#define SHITBIRD_TASK_REGISTRY_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "config.h"
+
+enum class TaskRole : uint8_t {
+    RADIO,      // Drives a radio: hopping, sweeping, scanning
+    ATTACK,     // Transmit loops
+    PARSER,     // Drains a capture ring and updates the tables
+    EXPORT,     // Writes captures out (SD)
+    PERIPHERAL, // Drives a local peripheral, not a radio: USB HID
+    LOOP,       // Arduino loopTask: module update(), UI
+    SYSTEM      // Created by a library; core and priority are its own
+};
+
+struct TaskInfo {
+    char name[configMAX_TASK_NAME_LEN];
+    TaskHandle_t handle;
+    TaskRole role;
+    int8_t core;            // -1 if not pinned
+    uint8_t priority;       // Current, which may differ from the role's
+    uint32_t stackSize;     // Bytes; 0 if not known (adopted tasks)
+    uint32_t stackFree;     // High-water mark: least free stack so far, bytes
+};
+
+class TaskRegistry {
+public:
+    // Creates fn on its role's core at its role's priority. handle is set
+    // before the task first runs, as with xTaskCreatePinnedToCore().
+    static bool spawn(TaskFunction_t fn, const char* name, uint32_t stackSize,
+                      void* param, TaskRole role, TaskHandle_t* handle);
+
+    // Records a task created elsewhere; repeat calls update it. forget()
+    // must come before whoever created it deletes it.
+    static void adopt(TaskHandle_t handle, TaskRole role, uint32_t stackSize = 0);
+    static void forget(TaskHandle_t handle);
+
+    // Deletes a spawned task from outside and clears handle
+    static void kill(TaskHandle_t& handle);
+    // For a spawned task to end itself instead of vTaskDelete(nullptr)
+    static void exit();
+
+    // Copies up to max entries with fresh priorities and high-water marks.
+    // The tasks are queried outside the lock; forget() waits for that.
+    static size_t snapshot(TaskInfo* out, size_t max);
+    static void logSummary();
+
+    static uint8_t coreFor(TaskRole role);
+    static uint8_t priorityFor(TaskRole role);
+    static const char* roleName(TaskRole role);
+
+private:
+    struct Entry {
+        TaskHandle_t handle;    // nullptr until the task starts, and when free
+        TaskFunction_t fn;      // Spawned tasks only; reserves the slot
+        void* param;
+        TaskRole role;
+        uint32_t stackSize;
+        uint32_t serial;        // Tells the slot spawn() reserved from a reuse
+        uint8_t busy;           // snapshot() calls querying the task
+    };
+
+    static Entry entries[TASK_REGISTRY_SLOTS];
+    static uint32_t nextSerial;
+    static portMUX_TYPE mux;
+
+    static void trampoline(void* param);
+};
+
+#endif // SHITBIRD_TASK_REGISTRY_H
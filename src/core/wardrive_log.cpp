@@ -0,0 +1,333 @@
+/**
+ * ShitBird Firmware - Wardrive Logger Implementation
+ */
+
+#include "wardrive_log.h"
+#include "storage.h"
+#include "../modules/wifi/wifi_module.h"
+#include "../modules/wifi/wifi_ie.h"
+#include <time.h>
+
+// Longest row formatRow() produces: a fully escaped 32-char name plus every
+// capability flag still leaves room
+#define WARDRIVE_ROW_MAX    256
+
+volatile bool WardriveLog::active = false;
+String WardriveLog::filename;
+File WardriveLog::file;
+MacTable<WardriveLog::Record> WardriveLog::wifiRecords;
+MacTable<WardriveLog::Record> WardriveLog::bleRecords;
+std::vector<WardriveLog::DirtyRef> WardriveLog::dirty;
+WardriveFix WardriveLog::position = {};
+WardriveStats WardriveLog::stats = {};
+uint32_t WardriveLog::startedAt = 0;
+uint32_t WardriveLog::lastFlush = 0;
+portMUX_TYPE WardriveLog::mux = portMUX_INITIALIZER_UNLOCKED;
+
+// ============================================================================
+// Session
+// ============================================================================
+
+bool WardriveLog::start(const char* path) {
+    if (active) stop();
+    if (!Storage::isMounted()) return false;
+
+    File f = SD.open(path, FILE_WRITE);
+    if (!f) {
+        Serial.printf("[WARDRIVE] Failed to create %s\n", path);
+        return false;
+    }
+
+    char header[256];
+    int len = snprintf(header, sizeof(header),
+                       "WigleWifi-1.4,appRelease=%s,model=T-Deck,release=%s,device=ShitBird,"
+                       "display=,board=ESP32-S3,brand=LilyGO\n"
+                       "MAC,SSID,AuthMode,FirstSeen,Channel,RSSI,CurrentLatitude,CurrentLongitude,"
+                       "AltitudeMeters,AccuracyMeters,Type\n",
+                       FIRMWARE_VERSION, FIRMWARE_VERSION);
+    f.write((const uint8_t*)header, len);
+
+    // Sized up front so sightings never allocate in the parser or BLE task
+    wifiRecords.clear();
+    bleRecords.clear();
+    wifiRecords.reserve(WARDRIVE_MAX_WIFI);
+    bleRecords.reserve(WARDRIVE_MAX_BLE);
+    dirty.clear();
+    dirty.reserve(WARDRIVE_MAX_WIFI + WARDRIVE_MAX_BLE);
+
+    portENTER_CRITICAL(&mux);
+    stats = WardriveStats();
+    stats.bytesWritten = len;
+    portEXIT_CRITICAL(&mux);
+
+    file = f;
+    filename = path;
+    startedAt = millis();
+    lastFlush = startedAt;
+    active = true;
+
+    Serial.printf("[WARDRIVE] Logging to %s\n", path);
+    Storage::logf("wardrive", "Session started: %s", path);
+    return true;
+}
+
+void WardriveLog::stop() {
+    if (!active) return;
+    active = false;
+
+    flush();
+    file.close();
+    lastFlush = millis();  // Session end, for the rate in getStats()
+
+    WardriveStats s = getStats();
+    Serial.printf("[WARDRIVE] Stopped: %lu rows, %lu devices\n",
+                  (unsigned long)s.rowsWritten, (unsigned long)s.records);
+    Storage::logf("wardrive", "Session stopped: %s, %lu rows, %lu devices, %lu without fix",
+                  filename.c_str(), (unsigned long)s.rowsWritten, (unsigned long)s.records,
+                  (unsigned long)s.noFix);
+}
+
+String WardriveLog::getFilename() {
+    return filename;
+}
+
+void WardriveLog::setPosition(const WardriveFix& fix) {
+    portENTER_CRITICAL(&mux);
+    position = fix;
+    portEXIT_CRITICAL(&mux);
+}
+
+WardriveStats WardriveLog::getStats() {
+    portENTER_CRITICAL(&mux);
+    WardriveStats s = stats;
+    s.records = wifiRecords.size() + bleRecords.size();
+    portEXIT_CRITICAL(&mux);
+
+    uint32_t elapsed = (active ? millis() : lastFlush) - startedAt;
+    s.rowsPerSec = elapsed ? s.rowsWritten * 1000.0f / elapsed : 0;
+    return s;
+}
+
+// ============================================================================
+// Sightings
+// ============================================================================
+
+// Caller holds mux. Returns the record when this sighting is now its best,
+// nullptr when it changes nothing.
+WardriveLog::Record* WardriveLog::sighting(MacTable<Record>& table, size_t limit,
+                                           const MacAddr& addr, int8_t rssi, bool ble) {
+    stats.sightings++;
+    if (!position.valid) {
+        stats.noFix++;
+        return nullptr;
+    }
+
+    Record* r = table.find(addr);
+    if (!r) {
+        if (table.size() >= limit) {
+            stats.dropped++;
+            return nullptr;
+        }
+        r = table.insert(addr);
+        if (!r) {
+            stats.dropped++;
+            return nullptr;
+        }
+        r->mac = addr;
+        r->ble = ble;
+        r->firstSeen = position.time;
+    } else if (rssi <= r->rssi) {
+        return nullptr;
+    }
+
+    r->rssi = rssi;
+    r->latitude = position.latitude;
+    r->longitude = position.longitude;
+    r->altitude = position.altitude;
+    r->accuracy = position.accuracy;
+    stats.improved++;
+
+    // One queue entry however often it improves before the next flush
+    if (!r->dirty) {
+        r->dirty = true;
+        dirty.push_back({ble, table.findHandle(addr)});
+    }
+    return r;
+}
+
+void WardriveLog::recordWiFi(const APInfo& ap) {
+    int8_t rssi = ap.rssi < -128 ? -128 : (ap.rssi > 0 ? 0 : (int8_t)ap.rssi);
+
+    portENTER_CRITICAL(&mux);
+    Record* r = sighting(wifiRecords, WARDRIVE_MAX_WIFI, ap.bssid, rssi, false);
+    if (r) {
+        if (!ap.ssid.isEmpty()) {
+            strncpy(r->name, ap.ssid.c_str(), sizeof(r->name) - 1);
+            r->name[sizeof(r->name) - 1] = '\0';
+        }
+        r->channel = ap.channel;
+        r->auth = ap.encryption;
+        r->akms = ap.akms;
+        r->ciphers = ap.pairwiseCiphers;
+        r->wpa = ap.hasWPA;
+        r->rsn = ap.hasWPA2 || ap.hasWPA3;
+        r->wps = ap.hasWPS;
+    }
+    portEXIT_CRITICAL(&mux);
+}
+
+void WardriveLog::recordBLE(const MacAddr& addr, const char* name, int8_t rssi) {
+    portENTER_CRITICAL(&mux);
+    Record* r = sighting(bleRecords, WARDRIVE_MAX_BLE, addr, rssi, true);
+    if (r && name && name[0]) {
+        strncpy(r->name, name, sizeof(r->name) - 1);
+        r->name[sizeof(r->name) - 1] = '\0';
+    }
+    portEXIT_CRITICAL(&mux);
+}
+
+// ============================================================================
+// CSV output
+// ============================================================================
+
+// Quotes the field if it holds a comma, quote or line break
+static void csvField(const char* in, char* out, size_t len) {
+    bool quote = strpbrk(in, ",\"\r\n") != nullptr;
+    size_t o = 0;
+    if (quote) out[o++] = '"';
+    for (; *in && o + 3 < len; in++) {
+        if (*in == '"') out[o++] = '"';
+        out[o++] = (*in == '\r' || *in == '\n') ? ' ' : *in;
+    }
+    if (quote) out[o++] = '"';
+    out[o] = '\0';
+}
+
+static const char* cipherName(uint8_t ciphers) {
+    if (ciphers & WiFiIE::CIPHER_CCMP) return (ciphers & WiFiIE::CIPHER_TKIP) ? "CCMP+TKIP" : "CCMP";
+    if (ciphers & WiFiIE::CIPHER_GCMP256) return "GCMP-256";
+    if (ciphers & WiFiIE::CIPHER_TKIP) return "TKIP";
+    return "CCMP";
+}
+
+// WiGLE's AuthMode column, in Android's capabilities format:
+// [WPA2-PSK-CCMP][WPS][ESS]
+static void capabilities(wifi_auth_mode_t auth, uint16_t akms, uint8_t ciphers,
+                         bool wpa, bool rsn, bool wps, char* out, size_t len) {
+    using namespace WiFiIE;
+
+    // APs only seen by an active scan have no elements decoded
+    if (!akms) {
+        switch (auth) {
+            case WIFI_AUTH_WPA_PSK: wpa = true; akms = AKM_PSK; break;
+            case WIFI_AUTH_WPA2_PSK: rsn = true; akms = AKM_PSK; break;
+            case WIFI_AUTH_WPA_WPA2_PSK: wpa = rsn = true; akms = AKM_PSK; break;
+            case WIFI_AUTH_WPA2_ENTERPRISE: rsn = true; akms = AKM_8021X; break;
+            case WIFI_AUTH_WPA3_PSK: rsn = true; akms = AKM_SAE; break;
+            case WIFI_AUTH_WPA2_WPA3_PSK: rsn = true; akms = AKM_PSK | AKM_SAE; break;
+            default: break;
+        }
+    }
+
+    const char* cipher = cipherName(ciphers);
+    const char* keyMgmt = (akms & (AKM_8021X | AKM_FT_8021X | AKM_8021X_SHA256 | AKM_SUITE_B)) ? "EAP" : "PSK";
+    bool legacy = akms & (AKM_8021X | AKM_FT_8021X | AKM_8021X_SHA256 | AKM_SUITE_B |
+                          AKM_PSK | AKM_FT_PSK | AKM_PSK_SHA256);
+    size_t o = 0;
+    out[0] = '\0';
+
+    if (auth == WIFI_AUTH_WEP) o += snprintf(out + o, len - o, "[WEP]");
+    if (wpa) o += snprintf(out + o, len - o, "[WPA-%s-%s]", keyMgmt, cipher);
+    if (rsn && legacy) o += snprintf(out + o, len - o, "[WPA2-%s-%s]", keyMgmt, cipher);
+    if (rsn && (akms & (AKM_SAE | AKM_FT_SAE))) o += snprintf(out + o, len - o, "[WPA3-SAE-%s]", cipher);
+    if (akms & AKM_OWE) o += snprintf(out + o, len - o, "[OWE]");
+    if (wps) o += snprintf(out + o, len - o, "[WPS]");
+    snprintf(out + o, len - o, "[ESS]");
+}
+
+size_t WardriveLog::formatRow(const Record& r, char* out, size_t len) {
+    char mac[18];
+    char name[72];
+    char caps[96];
+    char seen[20];
+
+    r.mac.format(mac);
+    csvField(r.name, name, sizeof(name));
+
+    if (r.ble) snprintf(caps, sizeof(caps), "Misc [LE]");
+    else capabilities(r.auth, r.akms, r.ciphers, r.wpa, r.rsn, r.wps, caps, sizeof(caps));
+
+    time_t t = r.firstSeen;
+    struct tm tm;
+    gmtime_r(&t, &tm);
+    strftime(seen, sizeof(seen), "%Y-%m-%d %H:%M:%S", &tm);
+
+    int n = snprintf(out, len, "%s,%s,%s,%s,%u,%d,%.6f,%.6f,%.1f,%.1f,%s\n",
+                     mac, name, caps, seen, r.ble ? 0u : (unsigned)r.channel, r.rssi,
+                     r.latitude, r.longitude, r.altitude, r.accuracy, r.ble ? "BLE" : "WIFI");
+    if (n < 0) return 0;
+    return (size_t)n < len ? n : len - 1;
+}
+
+// ============================================================================
+// Flushing
+// ============================================================================
+
+void WardriveLog::update(uint32_t now) {
+    if (!active || now - lastFlush < WARDRIVE_FLUSH_MS) return;
+    lastFlush = now;
+    flush();
+}
+
+bool WardriveLog::flush() {
+    if (!file) return false;
+
+    static Record batch[WARDRIVE_FLUSH_BATCH];
+    static char text[WARDRIVE_FLUSH_BATCH * WARDRIVE_ROW_MAX];
+    uint32_t started = micros();
+    uint32_t rows = 0;
+    uint32_t bytes = 0;
+    bool ok = true;
+
+    for (;;) {
+        // Copy a batch out under the lock; the sightings keep coming while
+        // it's formatted and written
+        size_t n = 0;
+        portENTER_CRITICAL(&mux);
+        while (n < WARDRIVE_FLUSH_BATCH && !dirty.empty()) {
+            DirtyRef ref = dirty.back();
+            dirty.pop_back();
+            Record* r = (ref.ble ? bleRecords : wifiRecords).get(ref.handle);
+            if (!r) continue;
+            r->dirty = false;
+            batch[n++] = *r;
+        }
+        portEXIT_CRITICAL(&mux);
+        if (n == 0) break;
+
+        size_t len = 0;
+        for (size_t i = 0; i < n; i++) {
+            len += formatRow(batch[i], text + len, sizeof(text) - len);
+        }
+        if (file.write((const uint8_t*)text, len) != len) ok = false;
+        rows += n;
+        bytes += len;
+
+        if (n < WARDRIVE_FLUSH_BATCH) break;
+    }
+
+    if (rows == 0) return ok;
+    file.flush();
+
+    uint32_t elapsed = micros() - started;
+    portENTER_CRITICAL(&mux);
+    stats.rowsWritten += rows;
+    stats.bytesWritten += bytes;
+    stats.flushes++;
+    stats.lastFlushUs = elapsed;
+    if (elapsed > stats.maxFlushUs) stats.maxFlushUs = elapsed;
+    portEXIT_CRITICAL(&mux);
+
+    if (!ok) Serial.println("[WARDRIVE] Write to SD failed");
+    return ok;
+}
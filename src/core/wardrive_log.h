@@ -0,0 +1,126 @@
+/**
+ * ShitBird Firmware - Wardrive Logger (WiGLE CSV)
+ *
+ * Keeps one record per BSSID and per BLE address holding its strongest
+ * sighting and where that happened. A sighting only touches the record when
+ * it beats the stored RSSI, so a parked AP beaconing ten times a second
+ * costs a table lookup, not a CSV line. Changed records are appended to a
+ * WiGLE 1.4 CSV every WARDRIVE_FLUSH_MS in batched writes through one open
+ * file, which WiGLE's upload dedupes by keeping each MAC's best row.
+ *
+ * observe*() are safe from any task (parser, BLE host) and do nothing while
+ * no session is running; setPosition() and update() are for the main loop.
+ */
+
+#ifndef SHITBIRD_WARDRIVE_LOG_H
+#define SHITBIRD_WARDRIVE_LOG_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <esp_wifi_types.h>
+#include <freertos/FreeRTOS.h>
+#include <vector>
+#include "config.h"
+#include "mac_table.h"
+
+struct APInfo;
+
+// Where the device is, as the GPS last reported it
+struct WardriveFix {
+    bool valid;
+    double latitude;
+    double longitude;
+    float altitude;      // m
+    float accuracy;      // m
+    uint32_t time;       // Unix seconds, UTC
+};
+
+struct WardriveStats {
+    uint32_t sightings;   // observe*() calls while logging
+    uint32_t noFix;       // Dropped for want of a position
+    uint32_t improved;    // Created a record or beat its RSSI
+    uint32_t dropped;     // New devices refused with the table full
+    uint32_t records;     // Distinct devices held
+    uint32_t rowsWritten;
+    uint32_t bytesWritten;
+    uint32_t flushes;
+    float rowsPerSec;     // Since the session started
+    uint32_t lastFlushUs;
+    uint32_t maxFlushUs;
+};
+
+class WardriveLog {
+public:
+    // Creates path and writes the WiGLE header
+    static bool start(const char* path);
+    // Flushes what's pending and closes the file
+    static void stop();
+    static bool isActive() { return active; }
+    static String getFilename();
+
+    static void setPosition(const WardriveFix& fix);
+
+    static void observeWiFi(const APInfo& ap) {
+        if (active) recordWiFi(ap);
+    }
+    // name may be nullptr when the advertisement carried none
+    static void observeBLE(const MacAddr& addr, const char* name, int8_t rssi) {
+        if (active) recordBLE(addr, name, rssi);
+    }
+
+    // Main loop: appends changed records once WARDRIVE_FLUSH_MS has passed
+    static void update(uint32_t now);
+    // Appends changed records now; false if the write failed
+    static bool flush();
+
+    static WardriveStats getStats();
+
+private:
+    struct Record {
+        MacAddr mac;
+        char name[33];        // SSID or BLE name
+        int8_t rssi;          // Best seen
+        uint8_t channel;
+        bool ble;
+        bool dirty;           // Changed since its last row
+        uint32_t firstSeen;   // Unix seconds
+
+        // WiFi security, for the capabilities column
+        wifi_auth_mode_t auth;
+        uint16_t akms;
+        uint8_t ciphers;
+        bool wpa;             // WPA1 element
+        bool rsn;             // RSN element (WPA2/WPA3)
+        bool wps;
+
+        // Position of the best sighting
+        double latitude;
+        double longitude;
+        float altitude;
+        float accuracy;
+    };
+
+    struct DirtyRef {
+        bool ble;
+        MacHandle handle;
+    };
+
+    static volatile bool active;
+    static String filename;
+    static File file;
+    static MacTable<Record> wifiRecords;
+    static MacTable<Record> bleRecords;
+    static std::vector<DirtyRef> dirty;
+    static WardriveFix position;
+    static WardriveStats stats;
+    static uint32_t startedAt;
+    static uint32_t lastFlush;
+    static portMUX_TYPE mux;
+
+    static void recordWiFi(const APInfo& ap);
+    static void recordBLE(const MacAddr& addr, const char* name, int8_t rssi);
+    static Record* sighting(MacTable<Record>& table, size_t limit, const MacAddr& addr, int8_t rssi, bool ble);
+    static size_t formatRow(const Record& r, char* out, size_t len);
+};
+
+#endif // SHITBIRD_WARDRIVE_LOG_H
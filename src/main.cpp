@@ -12,6 +12,11 @@
 #include "core/keyboard.h"
 #include "core/storage.h"
 #include "core/power.h"
+#include "core/expiry_wheel.h"
+#include "core/oui_db.h"
+#include "core/task_registry.h"
+#include "core/wardrive_log.h"
+#include "core/radio_scheduler.h"
 #include "ui/ui_manager.h"
 #include "ui/splash.h"
 
@@ -78,6 +83,9 @@ void setup() {
     Serial.println("[BOOT] Initializing keyboard...");
     Keyboard::init();
 
+    // Vendor names come from flash, so they work without an SD card
+    OuiDb::init();
+
     // Skip power init for now
     // Serial.println("[BOOT] Initializing power management...");
     // Power::init();
@@ -98,12 +106,22 @@ void setup() {
     LoRaModule::init();
     #endif
 
+    // Splits the 2.4 GHz radio when WiFi monitor and BLE scan both run
+    #if ENABLE_WIFI && ENABLE_BLE
+    RadioScheduler::init();
+    #endif
+
     // SD card init after LoRa (SPI must be initialized first)
     #if ENABLE_SD
     Serial.println("[BOOT] Initializing storage...");
     Storage::init();
     #endif
 
+    // Fingerprints from the card, on top of the built-in ones
+    #if ENABLE_BLE && ENABLE_SD
+    BLEModule::loadFingerprints();
+    #endif
+
     #if ENABLE_GPS
     Serial.println("[BOOT] Initializing GPS module...");
     GPSModule::init();
@@ -123,6 +141,10 @@ void setup() {
     Serial.println("[BOOT] Initializing UI...");
     UIManager::init();
 
+    // loop() runs here too, on CORE_APP below the parsers
+    TaskRegistry::adopt(xTaskGetCurrentTaskHandle(), TaskRole::LOOP, getArduinoLoopTaskStackSize());
+    TaskRegistry::logSummary();
+
     // Boot complete
     Serial.println("[BOOT] Boot complete!");
     Serial.printf("[BOOT] Free heap: %d bytes\n", ESP.getFreeHeap());
@@ -142,6 +164,25 @@ void loop() {
     GPSModule::update();
     #endif
 
+    // Radio modules: received packets and statistics
+    #if ENABLE_WIFI
+    WiFiModule::update();
+    #endif
+
+    #if ENABLE_BLE
+    BLEModule::update();
+    #endif
+
+    #if ENABLE_LORA
+    LoRaModule::update();
+    #endif
+
+    // Age out APs, clients, BLE devices and mesh nodes that have gone quiet
+    ExpiryWheel::advance(millis());
+
+    // Append improved wardrive sightings to SD
+    WardriveLog::update(millis());
+
     // Update UI
     UIManager::update();
 
@@ -5,6 +5,7 @@
 #include "badusb_module.h"
 #include "../../core/system.h"
 #include "../../core/storage.h"
+#include "../../core/task_registry.h"
 #include "../../ui/ui_manager.h"
 
 // Static member initialization
@@ -416,15 +417,7 @@ void BadUSBModule::runPayload() {
     currentLine = 0;
     g_systemState.currentMode = OperationMode::BADUSB;
 
-    xTaskCreatePinnedToCore(
-        payloadTask,
-        "BadUSB_Payload",
-        8192,
-        nullptr,
-        2,
-        &payloadTaskHandle,
-        1
-    );
+    TaskRegistry::spawn(payloadTask, "BadUSB_Payload", 8192, nullptr, TaskRole::PERIPHERAL, &payloadTaskHandle);
 
     Storage::log("badusb", "Payload execution started");
 }
@@ -435,10 +428,7 @@ void BadUSBModule::stopPayload() {
 
     Serial.println("[BADUSB] Stopping payload");
 
-    if (payloadTaskHandle) {
-        vTaskDelete(payloadTaskHandle);
-        payloadTaskHandle = nullptr;
-    }
+    TaskRegistry::kill(payloadTaskHandle);
 
     releaseAll();
     state = BadUSBState::CONNECTED;
@@ -505,7 +495,7 @@ void BadUSBModule::payloadTask(void* param) {
         g_systemState.currentMode = OperationMode::IDLE;
     }
 
-    vTaskDelete(nullptr);
+    TaskRegistry::exit();
 }
 
 void BadUSBModule::executeCommand(const DuckyLine& cmd) {
@@ -0,0 +1,121 @@
+/**
+ * ShitBird Firmware - BLE Addresses and Advertising Data
+ *
+ * BLEAddr keys the device table by address and address type. BLEAd walks
+ * the AD structures of an advertisement (and its scan response) in place,
+ * so devices keep their raw advertising data and decode names, service
+ * UUIDs and manufacturer data only when something asks. Nothing allocates.
+ */
+
+#ifndef SHITBIRD_BLE_ADV_H
+#define SHITBIRD_BLE_ADV_H
+
+#include <Arduino.h>
+#include "../../core/mac_addr.h"
+
+// The same 48 bits as a public and as a random address are two devices
+struct BLEAddr {
+    uint64_t value;  // MacAddr::value, address type (BLE_ADDR_*) in bits 48-55
+
+    BLEAddr() : value(0) {}
+    BLEAddr(const MacAddr& mac, uint8_t type) : value(mac.value | ((uint64_t)type << 48)) {}
+
+    // From the little-endian byte order of NimBLE and the link layer
+    static BLEAddr fromNative(const uint8_t* addr, uint8_t type) {
+        uint8_t mac[6];
+        for (int i = 0; i < 6; i++) mac[i] = addr[5 - i];
+        return BLEAddr(MacAddr::fromBytes(mac), type);
+    }
+
+    MacAddr mac() const { return MacAddr(value); }
+    uint8_t type() const { return (uint8_t)(value >> 48); }
+
+    uint32_t hash() const { return mac().hash() ^ (type() * 0x9E3779B1u); }
+
+    bool operator==(const BLEAddr& other) const { return value == other.value; }
+    bool operator!=(const BLEAddr& other) const { return value != other.value; }
+};
+
+namespace BLEAd {
+    // AD types (Bluetooth Assigned Numbers, 2.3)
+    const uint8_t TYPE_FLAGS            = 0x01;
+    const uint8_t TYPE_UUID16_PARTIAL   = 0x02;
+    const uint8_t TYPE_UUID16_COMPLETE  = 0x03;
+    const uint8_t TYPE_UUID32_PARTIAL   = 0x04;
+    const uint8_t TYPE_UUID32_COMPLETE  = 0x05;
+    const uint8_t TYPE_UUID128_PARTIAL  = 0x06;
+    const uint8_t TYPE_UUID128_COMPLETE = 0x07;
+    const uint8_t TYPE_NAME_SHORT       = 0x08;
+    const uint8_t TYPE_NAME_COMPLETE    = 0x09;
+    const uint8_t TYPE_TX_POWER         = 0x0A;
+    const uint8_t TYPE_SERVICE_DATA16   = 0x16;
+    const uint8_t TYPE_APPEARANCE       = 0x19;
+    const uint8_t TYPE_MANUFACTURER     = 0xFF;
+
+    struct Structure {
+        uint8_t type;
+        uint8_t len;          // Data length, excluding the type byte
+        const uint8_t* data;
+    };
+
+    class Iterator {
+    public:
+        Iterator(const uint8_t* data, size_t len) : pos(data), end(data + len) {}
+
+        // False at the end, at zero padding, or where a length would run past
+        bool next(Structure& ad) {
+            if (end - pos < 2 || pos[0] == 0) return false;
+            uint8_t len = pos[0];
+            if (len > end - pos - 1) return false;
+            ad.type = pos[1];
+            ad.len = len - 1;
+            ad.data = pos + 2;
+            pos += 1 + len;
+            return true;
+        }
+
+    private:
+        const uint8_t* pos;
+        const uint8_t* end;
+    };
+
+    // First structure of this type
+    inline bool find(const uint8_t* data, size_t len, uint8_t type, Structure& out) {
+        Iterator it(data, len);
+        while (it.next(out)) {
+            if (out.type == type) return true;
+        }
+        return false;
+    }
+
+    // Listed as a 16-bit service UUID, or carrying service data for one
+    inline bool hasUuid16(const uint8_t* data, size_t len, uint16_t uuid) {
+        Iterator it(data, len);
+        Structure ad;
+        while (it.next(ad)) {
+            if (ad.type == TYPE_UUID16_PARTIAL || ad.type == TYPE_UUID16_COMPLETE) {
+                for (uint8_t i = 0; i + 1 < ad.len; i += 2) {
+                    if ((ad.data[i] | (ad.data[i + 1] << 8)) == uuid) return true;
+                }
+            } else if (ad.type == TYPE_SERVICE_DATA16 && ad.len >= 2) {
+                if ((ad.data[0] | (ad.data[1] << 8)) == uuid) return true;
+            }
+        }
+        return false;
+    }
+
+    // Complete local name, else the shortened one, NUL-terminated into out;
+    // false if the advertisement has neither
+    inline bool name(const uint8_t* data, size_t len, char* out, size_t outLen) {
+        Structure ad;
+        if (!find(data, len, TYPE_NAME_COMPLETE, ad) && !find(data, len, TYPE_NAME_SHORT, ad)) {
+            return false;
+        }
+        size_t n = ad.len < outLen - 1 ? ad.len : outLen - 1;
+        memcpy(out, ad.data, n);
+        out[n] = '\0';
+        return true;
+    }
+}
+
+#endif // SHITBIRD_BLE_ADV_H
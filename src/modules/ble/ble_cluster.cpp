@@ -0,0 +1,344 @@
+/**
+ * ShitBird Firmware - BLE Advertiser Clustering Implementation
+ */
+
+#include "ble_cluster.h"
+#include "../../core/table_budget.h"
+
+#define ADDR_TYPE_RANDOM        1       // BLE_ADDR_RANDOM
+#define APPLE_COMPANY_ID        0x004C
+#define QUIET_INTERVALS         3       // Missed reports before an identity counts as gone
+
+namespace {
+
+inline void mix(uint32_t& h, uint8_t b) {
+    h ^= b;
+    h *= 16777619u;
+}
+
+inline void mix(uint32_t& h, const uint8_t* data, size_t len) {
+    for (size_t i = 0; i < len; i++) mix(h, data[i]);
+}
+
+} // namespace
+
+BLEClusterer::BLEClusterer() : addrs(0) {
+    lock = xSemaphoreCreateMutex();
+    for (auto& c : clusters) c = BLECluster();
+    nextId = 1;
+    links = 0;
+    splits = 0;
+    evicted = 0;
+}
+
+void BLEClusterer::reset() {
+    xSemaphoreTake(lock, portMAX_DELAY);
+    if (!addrs.capacity()) addrs.bound(BLE_CLUSTER_ADDRS);
+    addrs.clear();
+    for (auto& c : clusters) c = BLECluster();
+    links = 0;
+    splits = 0;
+    evicted = 0;
+    xSemaphoreGive(lock);
+}
+
+// Random with the top two bits other than 11 (static): resolvable or
+// non-resolvable private, the kinds that rotate
+bool BLEClusterer::isPrivate(const BLEAddr& addr) {
+    return addr.type() == ADDR_TYPE_RANDOM && (addr.mac().value >> 46) != 3;
+}
+
+uint32_t BLEClusterer::signature(const uint8_t* adv, size_t len, int8_t* txPower) {
+    uint32_t h = 2166136261u;
+    *txPower = BLE_CLUSTER_NO_TX_POWER;
+
+    BLEAd::Iterator it(adv, len);
+    BLEAd::Structure ad;
+    while (it.next(ad)) {
+        mix(h, ad.type);
+        switch (ad.type) {
+            case BLEAd::TYPE_TX_POWER:
+                if (ad.len >= 1) *txPower = (int8_t)ad.data[0];
+                break;
+
+            case BLEAd::TYPE_MANUFACTURER: {
+                mix(h, ad.len);
+                if (ad.len < 2) break;
+                mix(h, ad.data, 2);
+                uint16_t company = ad.data[0] | (ad.data[1] << 8);
+                if (company == APPLE_COMPANY_ID) {
+                    // Continuity: the message types and lengths, not their contents
+                    size_t p = 2;
+                    while (p + 2 <= ad.len) {
+                        mix(h, ad.data + p, 2);
+                        p += 2 + ad.data[p + 1];
+                    }
+                } else if (ad.len > 2) {
+                    mix(h, ad.data[2]);
+                }
+                break;
+            }
+
+            case BLEAd::TYPE_SERVICE_DATA16:
+                mix(h, ad.len);
+                if (ad.len >= 2) mix(h, ad.data, 2);
+                break;
+
+            // Stable content: UUID lists, names, flags
+            case BLEAd::TYPE_FLAGS:
+            case BLEAd::TYPE_UUID16_PARTIAL:
+            case BLEAd::TYPE_UUID16_COMPLETE:
+            case BLEAd::TYPE_UUID32_PARTIAL:
+            case BLEAd::TYPE_UUID32_COMPLETE:
+            case BLEAd::TYPE_UUID128_PARTIAL:
+            case BLEAd::TYPE_UUID128_COMPLETE:
+            case BLEAd::TYPE_NAME_SHORT:
+            case BLEAd::TYPE_NAME_COMPLETE:
+            case BLEAd::TYPE_APPEARANCE:
+                mix(h, ad.data, ad.len);
+                break;
+
+            default:
+                mix(h, ad.len);
+                break;
+        }
+    }
+    return h;
+}
+
+uint32_t BLEClusterer::observe(const BLEAddr& addr, const uint8_t* adv, size_t len, int8_t rssi,
+                               const char* type, uint32_t now) {
+    // Only a new address needs it, but it's a walk over at most 31 bytes
+    // and keeps the lock to the table work
+    int8_t txPower;
+    uint32_t sig = signature(adv, len, &txPower);
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    if (!addrs.capacity()) {
+        xSemaphoreGive(lock);
+        return 0;
+    }
+
+    AddrEntry* entry = addrs.find(addr);
+    BLECluster* c = entry ? clusterOf(*entry) : nullptr;
+
+    if (c) {
+        // An address this identity had moved on from is still about, so the
+        // move was another device's
+        if (c->current().addr != addr) split(*c, now);
+
+        uint32_t gap = now - entry->lastSeen;
+        if (gap < BLE_CLUSTER_LINK_MS) {
+            c->intervalMs = c->intervalMs ? (uint16_t)((3u * c->intervalMs + gap) / 4) : (uint16_t)gap;
+        }
+        c->rssi = (int8_t)((3 * c->rssi + rssi) / 4);
+    } else {
+        uint16_t slot = allocate(now, -1);
+        c = &clusters[slot];
+        c->id = nextId++;
+        c->signature = sig;
+        c->txPower = txPower;
+        c->linkable = isPrivate(addr);
+        c->pending = c->linkable;
+        c->rssi = rssi;
+        c->firstSeen = now;
+        pushAddress(*c, addr, now);
+
+        entry = track(addr, now);
+        if (entry) {
+            entry->cluster = slot;
+            entry->clusterId = c->id;
+        }
+    }
+
+    strncpy(c->type, type, sizeof(c->type) - 1);
+    c->type[sizeof(c->type) - 1] = '\0';
+    c->lastSeen = now;
+    c->history[(c->head + BLE_CLUSTER_HISTORY - 1) % BLE_CLUSTER_HISTORY].lastSeen = now;
+    if (entry) entry->lastSeen = now;
+
+    if (c->pending) {
+        if (now - c->firstSeen > 2 * BLE_CLUSTER_LINK_MS) {
+            c->pending = false;
+        } else {
+            int slot = findLink(*c, now);
+            if (slot >= 0) {
+                merge(*c, clusters[slot], entry);
+                c = &clusters[slot];
+            }
+        }
+    }
+    uint32_t id = c->id;
+    xSemaphoreGive(lock);
+    return id;
+}
+
+// Caller holds lock
+BLECluster* BLEClusterer::clusterOf(const AddrEntry& entry) {
+    BLECluster& c = clusters[entry.cluster];
+    return c.id == entry.clusterId ? &c : nullptr;
+}
+
+// Caller holds lock. The identity the new address n most likely continues,
+// or -1: same payload structure and TX power, last heard no more than
+// BLE_CLUSTER_LINK_MS before n first was, and quiet since for a few of its
+// advertising intervals, so not still advertising itself; heard at about
+// the same strength. Closest in RSSI, then time.
+int BLEClusterer::findLink(const BLECluster& n, uint32_t now) const {
+    int best = -1;
+    uint32_t bestScore = UINT32_MAX;
+    for (int i = 0; i < BLE_CLUSTER_MAX; i++) {
+        const BLECluster& c = clusters[i];
+        if (!c.id || &c == &n || !c.linkable || c.signature != n.signature || c.txPower != n.txPower) continue;
+
+        // Heard once, there's no telling it has stopped
+        if (!c.intervalMs) continue;
+
+        int32_t gap = (int32_t)(n.firstSeen - c.lastSeen);
+        if (gap <= 0 || gap > BLE_CLUSTER_LINK_MS) continue;
+
+        uint32_t quietMs = min((uint32_t)c.intervalMs * QUIET_INTERVALS, (uint32_t)BLE_CLUSTER_LINK_MS);
+        if (now - c.lastSeen < quietMs) continue;
+
+        uint32_t drssi = (uint32_t)abs(c.rssi - n.rssi);
+        if (drssi > BLE_CLUSTER_RSSI_DB) continue;
+
+        uint32_t score = drssi * 500 + (uint32_t)gap;
+        if (score < bestScore) {
+            bestScore = score;
+            best = i;
+        }
+    }
+    return best;
+}
+
+// Caller holds lock. Folds the new address n into the identity it continues
+// and frees n's slot.
+void BLEClusterer::merge(BLECluster& n, BLECluster& into, AddrEntry* entry) {
+    BLEClusterAddr moved = n.current();
+    pushAddress(into, moved.addr, moved.firstSeen);
+    into.history[(into.head + BLE_CLUSTER_HISTORY - 1) % BLE_CLUSTER_HISTORY].lastSeen = moved.lastSeen;
+    memcpy(into.type, n.type, sizeof(into.type));
+    into.lastSeen = n.lastSeen;
+    into.rotations++;
+
+    if (entry) {
+        entry->cluster = (uint16_t)(&into - clusters);
+        entry->clusterId = into.id;
+    }
+    n = BLECluster();
+    links++;
+}
+
+// Caller holds lock. A free slot, else the one unheard longest other than keep
+uint16_t BLEClusterer::allocate(uint32_t now, int keep) {
+    int victim = -1;
+    for (int i = 0; i < BLE_CLUSTER_MAX; i++) {
+        if (!clusters[i].id) {
+            victim = i;
+            break;
+        }
+        if (i == keep) continue;
+        if (victim < 0 || (int32_t)(clusters[i].lastSeen - clusters[victim].lastSeen) < 0) victim = i;
+    }
+    if (clusters[victim].id) evicted++;
+    clusters[victim] = BLECluster();
+    return (uint16_t)victim;
+}
+
+// Caller holds lock
+void BLEClusterer::pushAddress(BLECluster& c, const BLEAddr& addr, uint32_t now) {
+    c.history[c.head] = {addr, now, now};
+    c.head = (c.head + 1) % BLE_CLUSTER_HISTORY;
+    if (c.count < BLE_CLUSTER_HISTORY) c.count++;
+}
+
+// Caller holds lock. Moves c's newest address out to an identity of its own.
+void BLEClusterer::split(BLECluster& c, uint32_t now) {
+    BLEClusterAddr moved = c.current();
+    int from = &c - clusters;
+    uint16_t slot = allocate(now, from);
+    BLECluster& n = clusters[slot];
+
+    n.id = nextId++;
+    n.signature = c.signature;
+    memcpy(n.type, c.type, sizeof(n.type));
+    n.txPower = c.txPower;
+    n.rssi = c.rssi;
+    n.linkable = c.linkable;
+    n.intervalMs = c.intervalMs;
+    n.firstSeen = moved.firstSeen;
+    n.lastSeen = moved.lastSeen;
+    n.history[0] = moved;
+    n.head = 1 % BLE_CLUSTER_HISTORY;
+    n.count = 1;
+
+    AddrEntry* entry = addrs.find(moved.addr);
+    if (entry) {
+        entry->cluster = slot;
+        entry->clusterId = n.id;
+    }
+
+    if (c.count > 1) {
+        c.head = (c.head + BLE_CLUSTER_HISTORY - 1) % BLE_CLUSTER_HISTORY;
+        c.count--;
+    }
+    if (c.rotations) c.rotations--;
+    splits++;
+}
+
+// Caller holds lock. Makes room by giving up the address unheard longest.
+BLEClusterer::AddrEntry* BLEClusterer::track(const BLEAddr& addr, uint32_t now) {
+    if (addrs.full()) {
+        MacHandle victim = addrs.leastValuable([now](const AddrEntry& e) {
+            return now - e.lastSeen + 1;
+        });
+        if (AddrEntry* e = addrs.get(victim)) addrs.erase(e->addr);
+    }
+    AddrEntry* entry = addrs.insert(addr);
+    if (entry) entry->addr = addr;
+    return entry;
+}
+
+size_t BLEClusterer::getPresentCount(uint32_t now) const {
+    size_t n = 0;
+    xSemaphoreTake(lock, portMAX_DELAY);
+    for (const auto& c : clusters) {
+        if (c.id && now - c.lastSeen <= BLE_CLUSTER_PRESENT_MS) n++;
+    }
+    xSemaphoreGive(lock);
+    return n;
+}
+
+size_t BLEClusterer::getClusters(BLECluster* out, size_t max) const {
+    uint8_t order[BLE_CLUSTER_MAX];
+    size_t used = 0;
+    size_t n = 0;
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    // Insertion sort by latest report, newest first
+    for (int i = 0; i < BLE_CLUSTER_MAX; i++) {
+        if (!clusters[i].id) continue;
+        size_t j = used++;
+        while (j > 0 && (int32_t)(clusters[order[j - 1]].lastSeen - clusters[i].lastSeen) < 0) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = (uint8_t)i;
+    }
+    for (; n < used && n < max; n++) out[n] = clusters[order[n]];
+    xSemaphoreGive(lock);
+    return n;
+}
+
+BLEClusterStats BLEClusterer::getStats() const {
+    BLEClusterStats s = {};
+    xSemaphoreTake(lock, portMAX_DELAY);
+    s.addresses = addrs.size();
+    for (const auto& c : clusters) s.clusters += c.id != 0;
+    s.links = links;
+    s.splits = splits;
+    s.evicted = evicted;
+    xSemaphoreGive(lock);
+    return s;
+}
@@ -0,0 +1,133 @@
+/**
+ * ShitBird Firmware - BLE Advertiser Clustering
+ *
+ * Phones and trackers rotate their private addresses every ~15 minutes, so
+ * counting addresses counts each of them several times over. This links a
+ * new private address to the identity an older one went quiet in, giving a
+ * count of devices rather than of addresses.
+ *
+ * A new private address starts as an identity of its own, pending. It is
+ * folded into an older identity that went quiet at most BLE_CLUSTER_LINK_MS
+ * before it appeared, advertises the same payload structure (AD types,
+ * company ID and message types, service UUIDs) and TX power, and is heard
+ * within BLE_CLUSTER_RSSI_DB of it; the closest in RSSI and time wins. The
+ * older identity must have missed a few of its advertising intervals first,
+ * so one still advertising isn't taken. Should an address already linked
+ * away be heard again, the link was wrong and the newer address is split
+ * back out. Public and static random addresses don't rotate and are never
+ * linked.
+ *
+ * It runs per report: a known address is a hash lookup, and only a new one
+ * walks the identities. Addresses and identities are fixed tables, each
+ * giving up the one unheard longest when full, and each identity keeps its
+ * last BLE_CLUSTER_HISTORY addresses in a ring.
+ *
+ * observe() is for the BLE scan worker; reset() and the getters are for the
+ * main loop. They share a mutex, and observe() hashes the payload before
+ * taking it.
+ */
+
+#ifndef SHITBIRD_BLE_CLUSTER_H
+#define SHITBIRD_BLE_CLUSTER_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "config.h"
+#include "ble_adv.h"
+#include "ble_fingerprint.h"
+#include "../../core/mac_table.h"
+
+#define BLE_CLUSTER_NO_TX_POWER 127
+
+static_assert(BLE_CLUSTER_MAX <= 256, "getClusters() orders clusters by uint8_t slot");
+
+// One address an identity used
+struct BLEClusterAddr {
+    BLEAddr addr;
+    uint32_t firstSeen;
+    uint32_t lastSeen;
+};
+
+// One device, across its address rotations
+struct BLECluster {
+    uint32_t id;              // Never reused; 0 for a free slot
+    uint32_t signature;       // BLEClusterer::signature() of its payload
+    char type[BLE_FP_TYPE_MAX];  // deviceType of the latest address
+    int8_t txPower;           // BLE_CLUSTER_NO_TX_POWER if not advertised
+    int8_t rssi;              // Smoothed
+    bool linkable;            // Private address: may continue as another
+    bool pending;             // New address, still looking for one it continues
+    uint16_t intervalMs;      // Smoothed gap between reports, 0 until known
+    uint32_t firstSeen;
+    uint32_t lastSeen;
+    uint32_t rotations;       // Addresses linked after the first
+    uint8_t head;             // Next history slot
+    uint8_t count;            // History slots in use
+    BLEClusterAddr history[BLE_CLUSTER_HISTORY];
+
+    // The address it uses now
+    const BLEClusterAddr& current() const {
+        return history[(head + BLE_CLUSTER_HISTORY - 1) % BLE_CLUSTER_HISTORY];
+    }
+};
+
+struct BLEClusterStats {
+    uint32_t addresses;       // Held in the address table
+    uint32_t clusters;        // Identities held
+    uint32_t links;           // New addresses joined to an identity
+    uint32_t splits;          // Links undone
+    uint32_t evicted;         // Identities given up for room
+};
+
+class BLEClusterer {
+public:
+    BLEClusterer();
+
+    // One advertising report; the identity it belongs to, 0 before the
+    // first reset(). type is copied.
+    uint32_t observe(const BLEAddr& addr, const uint8_t* adv, size_t len, int8_t rssi,
+                 const char* type, uint32_t now);
+
+    // Distinct devices heard in the last BLE_CLUSTER_PRESENT_MS
+    size_t getPresentCount(uint32_t now) const;
+    // Copies up to max identities, most recently heard first; returns how many
+    size_t getClusters(BLECluster* out, size_t max) const;
+    BLEClusterStats getStats() const;
+
+    // Forgets everything; allocates the address table the first time, so
+    // call it once PSRAM is up. observe() ignores reports until then.
+    void reset();
+
+    // Hash of what stays put across a rotation: AD types and lengths, company
+    // ID and message types, service UUIDs. txPower is set from the payload.
+    static uint32_t signature(const uint8_t* adv, size_t len, int8_t* txPower);
+
+private:
+    struct AddrEntry {
+        BLEAddr addr;
+        uint16_t cluster;     // Slot in clusters
+        uint32_t clusterId;   // Stale if the slot's id no longer matches
+        uint32_t lastSeen;
+    };
+
+    MacTable<AddrEntry, BLEAddr> addrs;
+    BLECluster clusters[BLE_CLUSTER_MAX];
+    uint32_t nextId;
+    uint32_t links;
+    uint32_t splits;
+    uint32_t evicted;
+    SemaphoreHandle_t lock;
+
+    BLECluster* clusterOf(const AddrEntry& entry);
+    int findLink(const BLECluster& n, uint32_t now) const;
+    void merge(BLECluster& n, BLECluster& into, AddrEntry* entry);
+    uint16_t allocate(uint32_t now, int keep);
+    void pushAddress(BLECluster& c, const BLEAddr& addr, uint32_t now);
+    void split(BLECluster& c, uint32_t now);
+    AddrEntry* track(const BLEAddr& addr, uint32_t now);
+
+    static bool isPrivate(const BLEAddr& addr);
+};
+
+#endif // SHITBIRD_BLE_CLUSTER_H
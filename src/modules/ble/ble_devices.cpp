@@ -0,0 +1,111 @@
+/**
+ * ShitBird Firmware - BLE Device Table
+ *
+ * Advertisers keyed by address and address type in a MacTable, each holding
+ * its raw advertising data inline. Recording a report is a hash lookup and
+ * a copy, with no heap traffic. Has no NimBLE dependency so the native
+ * environment can build it.
+ */
+
+#include "ble_module.h"
+#include "../../core/expiry_wheel.h"
+
+MacTable<BLEDeviceInfo, BLEAddr> BLEModule::devices;
+SemaphoreHandle_t BLEModule::devicesLock = nullptr;
+TableStats BLEModule::deviceTable = {"BLE devices"};
+TrackerMonitor BLEModule::trackerMonitor;
+BLEClusterer BLEModule::clusterer;
+
+TrackerMonitor& BLEModule::getTrackerMonitor() {
+    return trackerMonitor;
+}
+
+BLEClusterer& BLEModule::getClusterer() {
+    return clusterer;
+}
+
+MacTable<BLEDeviceInfo, BLEAddr>& BLEModule::getDevices() {
+    return devices;
+}
+
+// Created by init(); before that nothing else touches the table
+void BLEModule::lockDevices() {
+    if (devicesLock) xSemaphoreTake(devicesLock, portMAX_DELAY);
+}
+
+void BLEModule::unlockDevices() {
+    if (devicesLock) xSemaphoreGive(devicesLock);
+}
+
+void BLEModule::clearDevices() {
+    lockDevices();
+    devices.clear();
+    unlockDevices();
+    ExpiryWheel::clear(ExpiryTable::BLE_DEVICE);
+}
+
+BLEDeviceInfo* BLEModule::getDevice(const BLEAddr& addr) {
+    return devices.find(addr);
+}
+
+void BLEModule::setDeviceBudget(size_t bytes) {
+    ExpiryWheel::clear(ExpiryTable::BLE_DEVICE);
+    devices.bound(bytes / MacTable<BLEDeviceInfo, BLEAddr>::entryBytes());
+    deviceTable.bytes = bytes;
+    deviceTable.capacity = devices.capacity();
+}
+
+TableStats BLEModule::getDeviceTableStats() {
+    TableStats s = deviceTable;
+    s.size = devices.size();
+    return s;
+}
+
+// Caller holds devicesLock
+bool BLEModule::evictDevice(uint32_t now) {
+    MacHandle victim = devices.leastValuable([now](const BLEDeviceInfo& device) {
+        return evictionCost(device.rssi, device.lastSeen, now);
+    });
+    BLEDeviceInfo* device = devices.get(victim);
+    if (!device) {
+        deviceTable.refused++;
+        return false;
+    }
+
+    ExpiryWheel::cancel(ExpiryTable::BLE_DEVICE, victim);
+    devices.erase(device->addr);
+    deviceTable.evicted++;
+    return true;
+}
+
+BLEDeviceInfo* BLEModule::recordAdvertisement(const BLEAddr& addr, int8_t rssi, bool connectable,
+                                              const uint8_t* payload, size_t len, uint32_t now,
+                                              bool* created) {
+    if (len > BLE_ADV_DATA_MAX) len = BLE_ADV_DATA_MAX;
+
+    if (devices.full() && !devices.find(addr) && !evictDevice(now)) {
+        if (created) *created = false;
+        return nullptr;
+    }
+
+    bool isNew;
+    BLEDeviceInfo* device = devices.insert(addr, &isNew);
+    if (created) *created = isNew && device;
+    if (!device) return nullptr;
+
+    device->rssi = rssi;
+    device->lastSeen = now;
+    memcpy(device->adv, payload, len);
+    device->advLen = len;
+
+    // A report without a name keeps the one an earlier scan response gave
+    BLEAd::name(payload, len, device->name, sizeof(device->name));
+
+    if (isNew) {
+        device->addr = addr;
+        device->isConnectable = connectable;
+        identifyDevice(*device);
+        ExpiryWheel::schedule(ExpiryTable::BLE_DEVICE, devices.findHandle(addr), now);
+    }
+    return device;
+}
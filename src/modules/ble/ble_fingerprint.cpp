@@ -0,0 +1,360 @@
+/**
+ * ShitBird Firmware - BLE Fingerprint Rules Implementation
+ *
+ * Has no NimBLE dependency so the native environment can build it.
+ */
+
+#include "ble_fingerprint.h"
+#include "ble_adv.h"
+#include "../../core/storage.h"
+#include <algorithm>
+
+// BLE_FINGERPRINT_RULES and BLE_FINGERPRINT_INDEX, from the build
+#include "ble_fingerprint_rules.h"
+
+std::vector<BLEFingerprint> BLEFingerprintDb::loaded;
+std::vector<BLEFingerprintIndex> BLEFingerprintDb::loadedIndex;
+std::vector<const char*> BLEFingerprintDb::loadedTypes;
+
+namespace {
+
+const size_t BUILTIN_COUNT = sizeof(BLE_FINGERPRINT_RULES) / sizeof(BLE_FINGERPRINT_RULES[0]);
+const size_t BUILTIN_INDEX_COUNT = sizeof(BLE_FINGERPRINT_INDEX) / sizeof(BLE_FINGERPRINT_INDEX[0]);
+
+// Every type an SD rule has named. Append-only and never freed: device,
+// cluster and tracker records keep pointers into it across reloads.
+std::vector<const char*> typePool;
+
+const char* internType(const char* type) {
+    for (const char* t : typePool) {
+        if (strcmp(t, type) == 0) return t;
+    }
+    char* copy = strdup(type);
+    typePool.push_back(copy);
+    return copy;
+}
+
+// Best match so far and the flags of everything that matched
+struct Match {
+    const BLEFingerprint* best;
+    uint8_t flags;
+};
+
+// Case-insensitive; prefix is lowercase
+bool hasPrefix(const char* name, const char* prefix) {
+    for (; *prefix; name++, prefix++) {
+        if (tolower((unsigned char)*name) != *prefix) return false;
+    }
+    return true;
+}
+
+bool matches(const BLEFingerprint& rule, const uint8_t* data, size_t len, const char* name) {
+    if (rule.dataLen) {
+        if (rule.offset + rule.dataLen > len) return false;
+        for (uint8_t i = 0; i < rule.dataLen; i++) {
+            if ((data[rule.offset + i] & rule.mask[i]) != rule.data[i]) return false;
+        }
+    }
+    return !rule.name[0] || hasPrefix(name, rule.name);
+}
+
+const BLEFingerprintIndex* findIndex(const BLEFingerprintIndex* index, size_t count, uint32_t match) {
+    const BLEFingerprintIndex* end = index + count;
+    const BLEFingerprintIndex* it = std::lower_bound(index, end, match,
+        [](const BLEFingerprintIndex& entry, uint32_t m) { return entry.match < m; });
+    return it != end && it->match == match ? it : nullptr;
+}
+
+// Rules are most specific first within a key and id, so the first match
+// there is the only one that can beat the best so far
+void consider(const BLEFingerprint* rules, const BLEFingerprintIndex* index, size_t indexCount,
+              uint8_t key, uint16_t id, const uint8_t* data, size_t len, const char* name, Match& m) {
+    const BLEFingerprintIndex* entry = findIndex(index, indexCount, ((uint32_t)key << 16) | id);
+    if (!entry) return;
+
+    bool scored = false;
+    for (uint16_t i = 0; i < entry->count; i++) {
+        const BLEFingerprint& rule = rules[entry->first + i];
+        if (!matches(rule, data, len, name)) continue;
+        m.flags |= rule.flags;
+        if (!scored && (!m.best || rule.score > m.best->score)) m.best = &rule;
+        scored = true;
+    }
+}
+
+uint8_t hexNibble(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    c = tolower((unsigned char)c);
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return 0xFF;
+}
+
+// Hex digits in [begin, end) into out; false if odd, bad or too long
+bool parseHex(const char* begin, const char* end, uint8_t* out, size_t max, size_t& len) {
+    if ((end - begin) % 2 || (size_t)(end - begin) / 2 > max) return false;
+    len = 0;
+    for (const char* p = begin; p < end; p += 2) {
+        uint8_t hi = hexNibble(p[0]);
+        uint8_t lo = hexNibble(p[1]);
+        if (hi > 15 || lo > 15) return false;
+        out[len++] = (hi << 4) | lo;
+    }
+    return true;
+}
+
+bool fieldIs(const char* begin, const char* end, const char* text) {
+    return (size_t)(end - begin) == strlen(text) && memcmp(begin, text, end - begin) == 0;
+}
+
+} // namespace
+
+const BLEFingerprint* BLEFingerprintDb::classify(const uint8_t* adv, size_t advLen,
+                                                 const char* name, uint8_t& flags) {
+    Match m = {nullptr, 0};
+    const BLEFingerprint* sdRules = loaded.data();
+    const BLEFingerprintIndex* sdIndex = loadedIndex.data();
+    size_t sdIndexCount = loadedIndex.size();
+
+    // SD rules first, so they keep the best slot on a tie
+    auto lookup = [&](uint8_t key, uint16_t id, const uint8_t* data, size_t len) {
+        if (sdIndexCount) consider(sdRules, sdIndex, sdIndexCount, key, id, data, len, name, m);
+        consider(BLE_FINGERPRINT_RULES, BLE_FINGERPRINT_INDEX, BUILTIN_INDEX_COUNT,
+                 key, id, data, len, name, m);
+    };
+
+    BLEAd::Iterator it(adv, advLen);
+    BLEAd::Structure ad;
+    while (it.next(ad)) {
+        switch (ad.type) {
+            case BLEAd::TYPE_MANUFACTURER:
+                if (ad.len >= 2) {
+                    lookup(BLE_FP_KEY_COMPANY, ad.data[0] | (ad.data[1] << 8), ad.data + 2, ad.len - 2);
+                }
+                break;
+            case BLEAd::TYPE_UUID16_PARTIAL:
+            case BLEAd::TYPE_UUID16_COMPLETE:
+                for (uint8_t i = 0; i + 1 < ad.len; i += 2) {
+                    lookup(BLE_FP_KEY_SERVICE, ad.data[i] | (ad.data[i + 1] << 8), nullptr, 0);
+                }
+                break;
+            case BLEAd::TYPE_SERVICE_DATA16:
+                if (ad.len >= 2) {
+                    lookup(BLE_FP_KEY_SERVICE, ad.data[0] | (ad.data[1] << 8), ad.data + 2, ad.len - 2);
+                }
+                break;
+            case BLEAd::TYPE_APPEARANCE:
+                if (ad.len >= 2) {
+                    lookup(BLE_FP_KEY_APPEARANCE, ad.data[0] | (ad.data[1] << 8), nullptr, 0);
+                }
+                break;
+        }
+    }
+
+    if (name && name[0]) {
+        lookup(BLE_FP_KEY_NAME, (uint8_t)tolower((unsigned char)name[0]), nullptr, 0);
+    }
+
+    flags = m.flags;
+    return m.best;
+}
+
+uint8_t BLEFingerprintDb::score(const BLEFingerprint& rule) {
+    int bits = 0;
+    for (uint8_t i = 0; i < rule.dataLen; i++) bits += __builtin_popcount(rule.mask[i]);
+    return (rule.key == BLE_FP_KEY_NAME ? 0 : 16) + 2 * bits + 4 * strlen(rule.name);
+}
+
+bool BLEFingerprintDb::parseRule(const char* line, BLEFingerprint& rule, const char** error) {
+    const char* why = nullptr;
+    if (!error) error = &why;
+    *error = nullptr;
+
+    const char* start = line;
+    while (*start == ' ' || *start == '\t') start++;
+    if (!*start || *start == '#' || *start == '\r' || *start == '\n') return false;
+
+    // key,id,offset,data,mask,name,flags,type
+    const char* fields[9];
+    int count = 0;
+    fields[count++] = line;
+    const char* end = line;
+    for (; *end && *end != '\r' && *end != '\n'; end++) {
+        if (*end == ',') {
+            if (count == 8) break;
+            fields[count++] = end + 1;
+        }
+    }
+    if (count != 8 || *end == ',') {
+        *error = "expected 8 fields";
+        return false;
+    }
+    fields[8] = end + 1;
+    auto fieldEnd = [&](int i) { return fields[i + 1] - 1; };
+
+    memset(&rule, 0, sizeof(rule));
+
+    if (fieldIs(fields[0], fieldEnd(0), "company")) rule.key = BLE_FP_KEY_COMPANY;
+    else if (fieldIs(fields[0], fieldEnd(0), "service")) rule.key = BLE_FP_KEY_SERVICE;
+    else if (fieldIs(fields[0], fieldEnd(0), "appearance")) rule.key = BLE_FP_KEY_APPEARANCE;
+    else if (fieldIs(fields[0], fieldEnd(0), "name")) rule.key = BLE_FP_KEY_NAME;
+    else {
+        *error = "unknown key";
+        return false;
+    }
+
+    size_t nameLen = fieldEnd(5) - fields[5];
+    if (nameLen >= BLE_FP_NAME_MAX) {
+        *error = "name prefix too long";
+        return false;
+    }
+    for (size_t i = 0; i < nameLen; i++) rule.name[i] = tolower((unsigned char)fields[5][i]);
+
+    if (rule.key == BLE_FP_KEY_NAME) {
+        if (fieldEnd(1) != fields[1] || !nameLen) {
+            *error = "name rules take a name and no id";
+            return false;
+        }
+        rule.id = (uint8_t)rule.name[0];
+    } else {
+        uint8_t id[2];
+        size_t idLen;
+        if (fieldEnd(1) - fields[1] != 4 || !parseHex(fields[1], fieldEnd(1), id, 2, idLen)) {
+            *error = "id must be 4 hex digits";
+            return false;
+        }
+        rule.id = (id[0] << 8) | id[1];
+    }
+
+    int offset = 0;
+    for (const char* p = fields[2]; p < fieldEnd(2); p++) {
+        if (*p < '0' || *p > '9') {
+            *error = "bad offset";
+            return false;
+        }
+        offset = offset * 10 + (*p - '0');
+        if (offset > 255) break;
+    }
+
+    size_t dataLen, maskLen;
+    if (!parseHex(fields[3], fieldEnd(3), rule.data, BLE_FP_DATA_MAX, dataLen) ||
+        !parseHex(fields[4], fieldEnd(4), rule.mask, BLE_FP_DATA_MAX, maskLen)) {
+        *error = "bad data or mask";
+        return false;
+    }
+    if (!maskLen) {
+        memset(rule.mask, 0xFF, dataLen);
+    } else if (maskLen != dataLen) {
+        *error = "mask and data differ in length";
+        return false;
+    }
+    if (dataLen && rule.key != BLE_FP_KEY_COMPANY && rule.key != BLE_FP_KEY_SERVICE) {
+        *error = "only company and service rules match data";
+        return false;
+    }
+    if (offset + dataLen > 255) {
+        *error = "offset out of range";
+        return false;
+    }
+    rule.offset = offset;
+    rule.dataLen = dataLen;
+    for (size_t i = 0; i < dataLen; i++) rule.data[i] &= rule.mask[i];
+
+    const char* flag = fields[6];
+    while (flag < fieldEnd(6)) {
+        const char* flagEnd = flag;
+        while (flagEnd < fieldEnd(6) && *flagEnd != '|') flagEnd++;
+        if (fieldIs(flag, flagEnd, "apple")) rule.flags |= BLE_FP_APPLE;
+        else if (fieldIs(flag, flagEnd, "samsung")) rule.flags |= BLE_FP_SAMSUNG;
+        else if (fieldIs(flag, flagEnd, "google")) rule.flags |= BLE_FP_GOOGLE;
+        else if (fieldIs(flag, flagEnd, "microsoft")) rule.flags |= BLE_FP_MICROSOFT;
+        else if (fieldIs(flag, flagEnd, "tracker")) rule.flags |= BLE_FP_TRACKER;
+        else if (flagEnd != flag) {
+            *error = "unknown flag";
+            return false;
+        }
+        flag = flagEnd + 1;
+    }
+
+    size_t typeLen = end - fields[7];
+    if (!typeLen || typeLen >= BLE_FP_TYPE_MAX) {
+        *error = "type must be 1-23 characters";
+        return false;
+    }
+    memcpy(rule.type, fields[7], typeLen);
+
+    rule.score = score(rule);
+    return true;
+}
+
+int BLEFingerprintDb::load(const char* path) {
+    if (!Storage::exists(path)) return -1;
+    String text = Storage::readFile(path);
+
+    std::vector<BLEFingerprint> rules;
+    int lineNumber = 0;
+    int rejected = 0;
+    const char* line = text.c_str();
+    while (*line) {
+        lineNumber++;
+        BLEFingerprint rule;
+        const char* error;
+        if (parseRule(line, rule, &error)) {
+            rules.push_back(rule);
+        } else if (error) {
+            Serial.printf("[BLE] %s:%d: %s\n", path, lineNumber, error);
+            rejected++;
+        }
+        const char* next = strchr(line, '\n');
+        if (!next) break;
+        line = next + 1;
+    }
+
+    // The order tools/build_ble_fingerprints.py gives the built-in table
+    std::stable_sort(rules.begin(), rules.end(), [](const BLEFingerprint& a, const BLEFingerprint& b) {
+        if (a.key != b.key) return a.key < b.key;
+        if (a.id != b.id) return a.id < b.id;
+        return a.score > b.score;
+    });
+    if (rules.size() > 0xFFFF) rules.resize(0xFFFF);
+
+    std::vector<BLEFingerprintIndex> index;
+    std::vector<const char*> types;
+    types.reserve(rules.size());
+    for (size_t i = 0; i < rules.size(); i++) {
+        types.push_back(internType(rules[i].type));
+        uint32_t match = ((uint32_t)rules[i].key << 16) | rules[i].id;
+        if (!index.empty() && index.back().match == match) {
+            index.back().count++;
+        } else {
+            index.push_back({match, (uint16_t)i, 1});
+        }
+    }
+
+    loaded.swap(rules);
+    loadedIndex.swap(index);
+    loadedTypes.swap(types);
+    loaded.shrink_to_fit();
+    loadedIndex.shrink_to_fit();
+
+    Storage::logf("ble", "Loaded %u fingerprints from %s, %d rejected",
+                  (unsigned)loaded.size(), path, rejected);
+    return (int)loaded.size();
+}
+
+void BLEFingerprintDb::unload() {
+    std::vector<BLEFingerprint>().swap(loaded);
+    std::vector<BLEFingerprintIndex>().swap(loadedIndex);
+    std::vector<const char*>().swap(loadedTypes);
+}
+
+const char* BLEFingerprintDb::typeOf(const BLEFingerprint& rule) {
+    // Built-in rules are in flash; SD rules hand out their interned copy
+    if (!loaded.empty() && &rule >= loaded.data() && &rule < loaded.data() + loaded.size()) {
+        return loadedTypes[&rule - loaded.data()];
+    }
+    return rule.type;
+}
+
+size_t BLEFingerprintDb::getBuiltinCount() {
+    return BUILTIN_COUNT;
+}
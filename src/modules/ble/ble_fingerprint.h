@@ -0,0 +1,96 @@
+/**
+ * ShitBird Firmware - BLE Fingerprint Rules
+ *
+ * Devices are classified by a table of rules rather than code. Each rule is
+ * keyed on one advertised field (company ID, 16-bit service UUID, appearance,
+ * or the first letter of the name) and can narrow further with a masked byte
+ * pattern over the manufacturer or service data and a name prefix.
+ *
+ * The built-in rules are tools/ble_fingerprints.csv, compiled by
+ * tools/build_ble_fingerprints.py into a const (flash) array sorted by key
+ * and id, plus a dispatch index of one entry per key and id. Rules in the
+ * same CSV format load from BLE_FINGERPRINT_FILE on the SD card and are
+ * sorted and indexed the same way at load.
+ *
+ * classify() walks the AD structures once and binary-searches the index for
+ * each field it finds. It allocates nothing.
+ */
+
+#ifndef SHITBIRD_BLE_FINGERPRINT_H
+#define SHITBIRD_BLE_FINGERPRINT_H
+
+#include <Arduino.h>
+#include <vector>
+
+#define BLE_FINGERPRINT_FILE    "/settings/ble_fingerprints.csv"
+
+// What a rule is keyed on (tools/build_ble_fingerprints.py KEYS)
+#define BLE_FP_KEY_COMPANY      0
+#define BLE_FP_KEY_SERVICE      1
+#define BLE_FP_KEY_APPEARANCE   2
+#define BLE_FP_KEY_NAME         3   // id is the lowercase first letter
+
+// Rule flags (tools/build_ble_fingerprints.py FLAGS)
+#define BLE_FP_APPLE            0x01
+#define BLE_FP_SAMSUNG          0x02
+#define BLE_FP_GOOGLE           0x04
+#define BLE_FP_MICROSOFT        0x08
+#define BLE_FP_TRACKER          0x10
+
+#define BLE_FP_DATA_MAX         8
+#define BLE_FP_NAME_MAX         16
+#define BLE_FP_TYPE_MAX         24
+
+struct BLEFingerprint {
+    uint8_t key;
+    uint8_t flags;
+    uint16_t id;                     // Company ID, UUID, appearance or letter
+    uint8_t offset;                  // Into the manufacturer / service data
+    uint8_t dataLen;
+    uint8_t score;                   // Specificity; the best match names the device
+    uint8_t data[BLE_FP_DATA_MAX];   // Already masked
+    uint8_t mask[BLE_FP_DATA_MAX];
+    char name[BLE_FP_NAME_MAX];      // Lowercase name prefix, or empty
+    char type[BLE_FP_TYPE_MAX];
+};
+
+// Rules [first, first + count) share key and id
+struct BLEFingerprintIndex {
+    uint32_t match;                  // key << 16 | id
+    uint16_t first;
+    uint16_t count;
+};
+
+class BLEFingerprintDb {
+public:
+    // Best rule for an advertisement, or nullptr. flags collects the flags
+    // of every rule that matched. Rules from the SD card win ties.
+    static const BLEFingerprint* classify(const uint8_t* adv, size_t advLen,
+                                          const char* name, uint8_t& flags);
+
+    // Replaces the SD rules with those in path; the number loaded, or -1 if
+    // the file can't be read. Bad lines are skipped and logged. Devices
+    // classified by the old SD rules may match differently, so re-identify them.
+    static int load(const char* path = BLE_FINGERPRINT_FILE);
+    static void unload();
+
+    // The device type a rule names. Lives for the life of the program, so
+    // it outlasts load() and unload() replacing the rule it came from.
+    static const char* typeOf(const BLEFingerprint& rule);
+
+    static size_t getBuiltinCount();
+    static size_t getLoadedCount() { return loaded.size(); }
+
+    // One CSV line; false for blanks, comments and bad rules (error says why)
+    static bool parseRule(const char* line, BLEFingerprint& rule, const char** error = nullptr);
+
+    // Data bits count double a name letter; non-name keys start at 16
+    static uint8_t score(const BLEFingerprint& rule);
+
+private:
+    static std::vector<BLEFingerprint> loaded;
+    static std::vector<BLEFingerprintIndex> loadedIndex;
+    static std::vector<const char*> loadedTypes;   // Interned, parallel to loaded
+};
+
+#endif // SHITBIRD_BLE_FINGERPRINT_H
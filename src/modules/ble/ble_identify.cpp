@@ -0,0 +1,36 @@
+/**
+ * ShitBird Firmware - BLE Device Identification
+ *
+ * Classifies advertisers against the fingerprint rules (ble_fingerprint.h),
+ * read straight from the advertising data the device table keeps.
+ * Has no NimBLE dependency so the native environment can build it.
+ */
+
+#include "ble_module.h"
+#include "ble_fingerprint.h"
+
+void BLEModule::identifyDevice(BLEDeviceInfo& device) {
+    uint8_t flags;
+    const BLEFingerprint* rule = BLEFingerprintDb::classify(device.adv, device.advLen,
+                                                            device.name, flags);
+
+    device.deviceType = rule ? BLEFingerprintDb::typeOf(*rule) : "Unknown";
+    device.isApple = flags & BLE_FP_APPLE;
+    device.isSamsung = flags & BLE_FP_SAMSUNG;
+    device.isGoogle = flags & BLE_FP_GOOGLE;
+    device.isMicrosoft = flags & BLE_FP_MICROSOFT;
+    device.isTracker = flags & BLE_FP_TRACKER;
+}
+
+int BLEModule::loadFingerprints(const char* path) {
+    int count = BLEFingerprintDb::load(path);
+    if (count < 0) return count;
+
+    // Devices the previous SD rules classified may match differently now
+    lockDevices();
+    for (auto& device : devices) {
+        identifyDevice(device);
+    }
+    unlockDevices();
+    return count;
+}
@@ -5,20 +5,46 @@
 #include "ble_module.h"
 #include "../../core/system.h"
 #include "../../core/storage.h"
+#include "../../core/task_registry.h"
+#include "../../core/capture_session.h"
+#include "../../core/expiry_wheel.h"
+#include "../../core/mac_addr.h"
+#include "../../core/wardrive_log.h"
 #include "../../ui/ui_manager.h"
+#if ENABLE_GPS
+#include "../gps/gps_module.h"
+#endif
 #include <esp_random.h>
 
 // Static member initialization
 bool BLEModule::initialized = false;
 bool BLEModule::scanning = false;
+bool BLEModule::scanPaused = false;
+uint32_t BLEModule::scanDeadline = 0;
+SemaphoreHandle_t BLEModule::scanLock = nullptr;
 bool BLEModule::spamming = false;
 bool BLEModule::capturing = false;
 bool BLEModule::connected = false;
 BLEAttackType BLEModule::currentAttack = BLEAttackType::NONE;
 
-std::vector<BLEDeviceInfo> BLEModule::devices;
 std::vector<BLEDeviceInfo> BLEModule::airtags;
-std::vector<BLEPacket> BLEModule::capturedPackets;
+
+SpscRing<BLEScanReport, BLE_REPORT_RING_SLOTS> BLEModule::reportRing;
+volatile uint32_t BLEModule::reportReceived = 0;
+volatile uint32_t BLEModule::reportDropped = 0;
+uint32_t BLEModule::reportHighWater = 0;
+uint32_t BLEModule::reportRate = 0;
+uint32_t BLEModule::rateReceived = 0;
+uint32_t BLEModule::rateStart = 0;
+
+SpscRing<BLEScanReport, BLE_PDU_RING_SLOTS> BLEModule::pduRing;
+PcapWriter BLEModule::pcapWriter;
+String BLEModule::pcapFilename;
+TaskHandle_t BLEModule::captureTaskHandle = nullptr;
+SemaphoreHandle_t BLEModule::captureLock = nullptr;
+uint32_t BLEModule::pduReceived = 0;
+uint32_t BLEModule::pduDropped = 0;
+uint32_t BLEModule::pduHighWater = 0;
 
 NimBLEClient* BLEModule::pClient = nullptr;
 NimBLEAdvertising* BLEModule::pAdvertising = nullptr;
@@ -38,10 +64,12 @@ void BLEModule::init() {
     NimBLEDevice::init("ShitBird");
     NimBLEDevice::setPower(ESP_PWR_LVL_P9);  // Max power
     NimBLEDevice::setMTU(517);
+    TaskRegistry::adopt(xTaskGetHandle("nimble_host"), TaskRole::SYSTEM);
 
     // Get scan instance
     pScan = NimBLEDevice::getScan();
-    pScan->setAdvertisedDeviceCallbacks(&scanCallbacks, false);
+    // Duplicates wanted: otherwise the controller reports each address once
+    pScan->setAdvertisedDeviceCallbacks(&scanCallbacks, true);
     pScan->setActiveScan(true);
     pScan->setInterval(100);
     pScan->setWindow(99);
@@ -50,6 +78,36 @@ void BLEModule::init() {
     // Get advertising instance
     pAdvertising = NimBLEDevice::getAdvertising();
 
+    if (!devicesLock) devicesLock = xSemaphoreCreateMutex();
+    if (!scanLock) scanLock = xSemaphoreCreateMutex();
+    if (!captureLock) captureLock = xSemaphoreCreateMutex();
+
+    // Once PSRAM is up; a re-init keeps what was tracked
+    if (!devices.capacity()) {
+        setDeviceBudget(BLE_DEVICE_TABLE_BYTES);
+        clusterer.reset();
+        Serial.printf("[BLE] Tracking up to %u devices\n", (unsigned)devices.capacity());
+    }
+
+    // Keyed by handle, as the WiFi tables are; locked, as expiry runs on
+    // the main loop while the scan worker records
+    ExpiryWheel::registerTable(ExpiryTable::BLE_DEVICE, BLE_DEVICE_TTL,
+        [](uint64_t key, uint32_t& lastSeen) {
+            lockDevices();
+            const BLEDeviceInfo* device = devices.get((MacHandle)key);
+            if (device) lastSeen = device->lastSeen;
+            unlockDevices();
+            return device != nullptr;
+        },
+        [](uint64_t key, uint32_t staleBefore) {
+            lockDevices();
+            BLEDeviceInfo* device = devices.get((MacHandle)key);
+            bool stale = device && (int32_t)(device->lastSeen - staleBefore) <= 0;
+            if (stale) devices.erase(device->addr);
+            unlockDevices();
+            return stale;
+        });
+
     initialized = true;
     Serial.println("[BLE] Initialized");
 }
@@ -57,18 +115,38 @@ void BLEModule::init() {
 void BLEModule::update() {
     if (!initialized) return;
 
-    // Update BLE statistics
-    g_systemState.bleDevicesFound = devices.size();
-
-    // Prune old devices (not seen in 60 seconds)
+    // Devices, not addresses: rotated addresses count once
     uint32_t now = millis();
-    devices.erase(
-        std::remove_if(devices.begin(), devices.end(),
-            [now](const BLEDeviceInfo& d) {
-                return (now - d.lastSeen) > 60000;
-            }),
-        devices.end()
-    );
+    g_systemState.bleDevicesFound = clusterer.getPresentCount(now);
+
+    // The radio stops itself at the deadline; the session ends here
+    if (scanning && scanDeadline && (int32_t)(now - scanDeadline) >= 0) {
+        Serial.printf("[BLE] Scan complete, %u addresses\n", (unsigned)devices.size());
+        stopScan();
+    }
+
+    if (now - rateStart >= 1000) {
+        uint32_t received = reportReceived;
+        reportRate = (uint64_t)(received - rateReceived) * 1000 / (now - rateStart);
+        rateReceived = received;
+        rateStart = now;
+    }
+
+    #if ENABLE_GPS
+    trackerMonitor.setPosition(GPSModule::getFix());
+    #endif
+
+    // A tracker that keeps turning up wherever we go
+    if (trackerMonitor.poll()) {
+        TrackerAlert alert;
+        if (trackerMonitor.getAlerts(&alert, 1)) {
+            char msg[48];
+            snprintf(msg, sizeof(msg), "%s at %u places", alert.type, alert.locations);
+            UIManager::showMessage("Tracker Following", msg);
+        }
+    }
+
+    // Stale devices are aged out by ExpiryWheel (BLE_DEVICE_TTL)
 }
 
 void BLEModule::deinit() {
@@ -78,6 +156,7 @@ void BLEModule::deinit() {
     stopSpam();
     disconnect();
 
+    TaskRegistry::forget(xTaskGetHandle("nimble_host"));
     NimBLEDevice::deinit(true);
     initialized = false;
 }
@@ -87,221 +166,226 @@ void BLEModule::deinit() {
 // ============================================================================
 
 void BLEModule::startScan(uint32_t duration) {
-    if (!initialized || scanning) return;
+    if (!initialized) return;
+    xSemaphoreTake(scanLock, portMAX_DELAY);
+    if (scanning) {
+        xSemaphoreGive(scanLock);
+        return;
+    }
 
     Serial.println("[BLE] Starting scan...");
+    reportRing.reset();
+    reportReceived = 0;
+    reportDropped = 0;
+    reportHighWater = 0;
+    rateReceived = 0;
+    rateStart = millis();
+    scanDeadline = duration ? rateStart + duration * 1000 : 0;
+    scanPaused = false;
     scanning = true;
     g_systemState.currentMode = OperationMode::BLE_SCAN;
 
+    TaskRegistry::spawn(scanTask, "BLE_Scan", 4096, nullptr, TaskRole::PARSER, &scanTaskHandle);
+
     // Clear previous results if starting fresh
     // devices.clear();  // Optional: keep previous devices
 
-    if (duration == 0) {
-        // Continuous scanning
-        pScan->start(0, false);
-    } else {
-        pScan->start(duration, false);
-    }
+    // Returns at once; 0 is continuous. Results arrive through
+    // scanCallbacks, and update() ends a timed scan at its deadline.
+    pScan->start(duration, nullptr, false);
+    xSemaphoreGive(scanLock);
 
     Storage::logf("ble", "Scan started, duration: %d", duration);
 }
 
 void BLEModule::stopScan() {
+    if (!scanLock) return;
+    xSemaphoreTake(scanLock, portMAX_DELAY);
+    endScan();
+    xSemaphoreGive(scanLock);
+}
+
+// Caller holds scanLock
+void BLEModule::endScan() {
     if (!scanning) return;
 
     Serial.println("[BLE] Stopping scan...");
-    pScan->stop();
     scanning = false;
+    scanPaused = false;
+    pScan->stop();
+
+    // Let the worker record what's queued and exit on its own
+    if (scanTaskHandle) {
+        xTaskNotifyGive(scanTaskHandle);
+        for (int i = 0; i < 20 && scanTaskHandle; i++) {
+            vTaskDelay(pdMS_TO_TICKS(10));
+        }
+    }
 
     if (g_systemState.currentMode == OperationMode::BLE_SCAN) {
         g_systemState.currentMode = OperationMode::IDLE;
     }
 
     Storage::logf("ble", "Scan stopped, found %d devices", devices.size());
+    if (reportDropped > 0) {
+        Storage::logf("ble", "Scan reports: %lu, %lu dropped, ring peak %lu/%d",
+                      (unsigned long)reportReceived, (unsigned long)reportDropped,
+                      (unsigned long)reportHighWater, BLE_REPORT_RING_SLOTS);
+    }
 }
 
 bool BLEModule::isScanning() {
     return scanning;
 }
 
-std::vector<BLEDeviceInfo>& BLEModule::getDevices() {
-    return devices;
+void BLEModule::pauseScan(bool paused) {
+    if (!scanLock) return;
+    xSemaphoreTake(scanLock, portMAX_DELAY);
+    if (scanning && paused != scanPaused) {
+        scanPaused = paused;
+
+        // A timed scan resumes for what's left of it, and one whose deadline
+        // passed while paused ends here
+        int32_t left = scanDeadline ? (int32_t)(scanDeadline - millis()) : 0;
+        if (paused) {
+            pScan->stop();
+        } else if (scanDeadline == 0) {
+            pScan->start(0, nullptr, false);
+        } else if (left > 0) {
+            pScan->start((left + 999) / 1000, nullptr, false);
+        } else {
+            endScan();
+        }
+    }
+    xSemaphoreGive(scanLock);
 }
 
-void BLEModule::clearDevices() {
-    devices.clear();
+BLEScanStats BLEModule::getScanStats() {
+    BLEScanStats stats;
+    stats.received = reportReceived;
+    stats.dropped = reportDropped;
+    stats.queued = reportRing.size();
+    stats.highWater = reportHighWater;
+    stats.perSecond = scanning ? reportRate : 0;
+    return stats;
 }
 
-BLEDeviceInfo* BLEModule::getDevice(const String& address) {
-    for (auto& device : devices) {
-        if (device.address == address) {
-            return &device;
-        }
-    }
-    return nullptr;
+// Report event types map onto LL PDU types ADV_IND, ADV_DIRECT_IND,
+// ADV_SCAN_IND, ADV_NONCONN_IND, SCAN_RSP
+#define BLE_PDU_SCAN_RSP        4
+
+static uint8_t pduType(uint8_t eventType) {
+    static const uint8_t pduTypes[5] = {0, 1, 6, 2, BLE_PDU_SCAN_RSP};
+    return eventType < 5 ? pduTypes[eventType] : 0;
 }
 
-// Scan callback implementation
+// Runs in the NimBLE host task: copy into the ring and get out
 void BLEModule::ScanCallbacks::onResult(NimBLEAdvertisedDevice* device) {
-    String address = device->getAddress().toString().c_str();
+    reportReceived++;
 
-    // Check if device already exists
-    BLEDeviceInfo* existing = nullptr;
-    for (auto& d : devices) {
-        if (d.address == address) {
-            existing = &d;
-            break;
-        }
+    BLEScanReport* slot = reportRing.acquire();
+    if (!slot) {
+        reportDropped++;
+        return;
     }
 
-    if (existing) {
-        // Update existing device
-        existing->rssi = device->getRSSI();
-        existing->lastSeen = millis();
-        if (device->haveName()) {
-            existing->name = device->getName().c_str();
-            existing->hasName = true;
-        }
-    } else {
-        // New device
-        BLEDeviceInfo info;
-        info.address = address;
-        info.name = device->haveName() ? device->getName().c_str() : "";
-        info.hasName = device->haveName();
-        info.rssi = device->getRSSI();
-        info.isConnectable = device->isConnectable();
-        info.appearance = device->getAppearance();
-        info.lastSeen = millis();
-        info.addressType = device->getAddress().getType();
-
-        // Get service UUIDs
-        if (device->haveServiceUUID()) {
-            for (int i = 0; i < device->getServiceUUIDCount(); i++) {
-                info.serviceUUIDs.push_back(device->getServiceUUID(i).toString().c_str());
-            }
-        }
+    NimBLEAddress address = device->getAddress();
+    slot->time = millis();
+    memcpy(slot->advA, address.getNative(), 6);
+    slot->addrType = address.getType();
+    slot->eventType = device->getAdvType();
+    slot->rssi = device->getRSSI();
+    // Active scanning reports the advertisement with its scan response
+    // appended; advLen keeps where one ends for capture
+    slot->len = (uint8_t)min(device->getPayloadLength(), (size_t)BLE_ADV_DATA_MAX);
+    slot->advLen = (uint8_t)min((size_t)device->getAdvLength(), (size_t)slot->len);
+    memcpy(slot->data, device->getPayload(), slot->len);
+    reportRing.publish();
+
+    if (scanTaskHandle) {
+        xTaskNotifyGive(scanTaskHandle);
+    }
+}
 
-        // Get manufacturer data
-        if (device->haveManufacturerData()) {
-            std::string mfgData = device->getManufacturerData();
-            if (mfgData.length() >= 2) {
-                uint16_t companyId = (uint8_t)mfgData[0] | ((uint8_t)mfgData[1] << 8);
-                std::vector<uint8_t> data(mfgData.begin() + 2, mfgData.end());
-                info.manufacturerData[companyId] = data;
-            }
-        }
+void BLEModule::scanTask(void* param) {
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
 
-        // Identify device type
-        identifyDevice(info);
+        uint32_t pending = reportRing.size();
+        if (pending > reportHighWater) reportHighWater = pending;
 
-        devices.push_back(info);
+        // Drain fully, even after stopScan(), so nothing heard is lost
+        int batch = 0;
+        const BLEScanReport* report;
+        while ((report = reportRing.front()) != nullptr) {
+            processReport(*report);
+            reportRing.pop();
 
-        // Check if it's an AirTag
-        if (info.isTracker && info.isApple) {
-            airtags.push_back(info);
+            if (++batch >= BLE_REPORT_BATCH) {
+                batch = 0;
+                taskYIELD();
+            }
         }
 
-        // Log discovery
-        if (capturing) {
-            BLEPacket pkt;
-            pkt.timestamp = millis();
-            pkt.address = address;
-            pkt.rssi = device->getRSSI();
-            pkt.type = 0;  // Advertisement
-            // Store raw data if needed
-            capturedPackets.push_back(pkt);
-        }
+        if (!scanning) break;
     }
-}
 
-void BLEModule::onScanComplete(NimBLEScanResults results) {
-    Serial.printf("[BLE] Scan complete, %d devices found\n", devices.size());
-    scanning = false;
+    scanTaskHandle = nullptr;
+    TaskRegistry::exit();
 }
 
-void BLEModule::identifyDevice(BLEDeviceInfo& device) {
-    device.isApple = false;
-    device.isSamsung = false;
-    device.isGoogle = false;
-    device.isMicrosoft = false;
-    device.isTracker = false;
-    device.deviceType = "Unknown";
-
-    // Check manufacturer data
-    for (const auto& mfg : device.manufacturerData) {
-        uint16_t companyId = mfg.first;
-
-        switch (companyId) {
-            case 0x004C:  // Apple
-                device.isApple = true;
-                device.deviceType = "Apple Device";
-
-                // Check for AirTag/FindMy
-                if (mfg.second.size() > 0 && mfg.second[0] == 0x12) {
-                    device.isTracker = true;
-                    device.deviceType = "Apple AirTag/FindMy";
-                }
-                break;
-
-            case 0x0075:  // Samsung
-                device.isSamsung = true;
-                device.deviceType = "Samsung Device";
-
-                // Check for SmartTag
-                if (device.name.indexOf("SmartTag") >= 0) {
-                    device.isTracker = true;
-                    device.deviceType = "Samsung SmartTag";
-                }
-                break;
-
-            case 0x00E0:  // Google
-                device.isGoogle = true;
-                device.deviceType = "Google Device";
-                break;
-
-            case 0x0006:  // Microsoft
-                device.isMicrosoft = true;
-                device.deviceType = "Microsoft Device";
-                break;
-
-            case 0x0059:  // Nordic (often Tile)
-                if (device.name.indexOf("Tile") >= 0) {
-                    device.isTracker = true;
-                    device.deviceType = "Tile Tracker";
-                }
-                break;
+void BLEModule::processReport(const BLEScanReport& report) {
+    BLEAddr addr = BLEAddr::fromNative(report.advA, report.addrType);
+    bool randomAddress = report.addrType != BLE_ADDR_PUBLIC;
+
+    // The advertisement and its scan response as the two PDUs they were
+    if (CaptureSession::isActive()) {
+        CaptureSession::writeBLE(pduType(report.eventType), randomAddress, report.advA,
+                                 report.data, report.advLen, report.rssi);
+        if (report.len > report.advLen) {
+            CaptureSession::writeBLE(BLE_PDU_SCAN_RSP, randomAddress, report.advA,
+                                     report.data + report.advLen, report.len - report.advLen, report.rssi);
         }
     }
 
-    // Check by name patterns
-    if (device.hasName) {
-        String nameLower = device.name;
-        nameLower.toLowerCase();
-
-        if (nameLower.indexOf("airpods") >= 0) {
-            device.isApple = true;
-            device.deviceType = "Apple AirPods";
-        } else if (nameLower.indexOf("watch") >= 0 && device.isSamsung) {
-            device.deviceType = "Samsung Watch";
-        } else if (nameLower.indexOf("buds") >= 0 && device.isSamsung) {
-            device.deviceType = "Samsung Buds";
-        } else if (nameLower.indexOf("pixel") >= 0) {
-            device.isGoogle = true;
-            device.deviceType = "Google Pixel";
+    // Copy into the ring and leave the SD card to captureTask. Checked again
+    // under captureLock so stopCapture() knows no copy is still in flight.
+    if (capturing) {
+        xSemaphoreTake(captureLock, portMAX_DELAY);
+        if (capturing) {
+            pduReceived++;
+            BLEScanReport* slot = pduRing.acquire();
+            if (slot) {
+                *slot = report;
+                pduRing.publish();
+                if (captureTaskHandle) xTaskNotifyGive(captureTaskHandle);
+            } else {
+                pduDropped++;
+            }
         }
+        xSemaphoreGive(captureLock);
     }
 
-    // Check service UUIDs
-    for (const String& uuid : device.serviceUUIDs) {
-        if (uuid.indexOf("fd6f") >= 0) {
-            // COVID exposure notification
-            device.deviceType = "Exposure Notification";
-        } else if (uuid.indexOf("fe2c") >= 0) {
-            // Tile
-            device.isTracker = true;
-            device.deviceType = "Tile Tracker";
-        }
+    // ADV_IND and ADV_DIRECT_IND
+    bool connectable = report.eventType <= 1;
+
+    // info points into the table, so it's used under the lock
+    lockDevices();
+    bool created;
+    BLEDeviceInfo* info = recordAdvertisement(addr, report.rssi, connectable,
+                                              report.data, report.len, report.time, &created);
+    WardriveLog::observeBLE(addr.mac(), info && info->hasName() ? info->name : nullptr, report.rssi);
+    uint32_t identity = clusterer.observe(addr, report.data, report.len, report.rssi,
+                                          info ? info->deviceType : "Unknown", report.time);
+    if (identity && info && info->isTracker) {
+        trackerMonitor.observe(identity, addr, report.rssi, info->deviceType, report.time);
+    }
+
+    // Check if it's an AirTag
+    if (created && info->isTracker && info->isApple && airtags.size() < deviceTable.capacity) {
+        airtags.push_back(*info);
     }
+    unlockDevices();
 }
 
 // ============================================================================
@@ -317,15 +401,7 @@ void BLEModule::startSpam(BLEAttackType type) {
     g_systemState.currentMode = OperationMode::BLE_ATTACK;
 
     // Create spam task
-    xTaskCreatePinnedToCore(
-        spamTask,
-        "BLE_Spam",
-        4096,
-        nullptr,
-        1,
-        &spamTaskHandle,
-        0  // Core 0
-    );
+    TaskRegistry::spawn(spamTask, "BLE_Spam", 4096, nullptr, TaskRole::ATTACK, &spamTaskHandle);
 
     Storage::logf("ble", "Spam attack started, type: %d", (int)type);
 }
@@ -336,10 +412,7 @@ void BLEModule::stopSpam() {
     Serial.println("[BLE] Stopping spam attack");
     spamming = false;
 
-    if (spamTaskHandle) {
-        vTaskDelete(spamTaskHandle);
-        spamTaskHandle = nullptr;
-    }
+    TaskRegistry::kill(spamTaskHandle);
 
     pAdvertising->stop();
     currentAttack = BLEAttackType::NONE;
@@ -387,7 +460,7 @@ void BLEModule::spamTask(void* param) {
         vTaskDelay(pdMS_TO_TICKS(g_systemState.settings.ble.spamInterval));
     }
 
-    vTaskDelete(nullptr);
+    TaskRegistry::exit();
 }
 
 void BLEModule::sendAppleSpam() {
@@ -698,14 +771,19 @@ bool BLEModule::writeCharacteristic(const String& serviceUUID, const String& cha
 // ============================================================================
 
 void BLEModule::startAirtagSniff() {
+    lockDevices();
     airtags.clear();
+    unlockDevices();
     startScan(0);  // Continuous scan
     Storage::log("ble", "AirTag sniffing started");
 }
 
 void BLEModule::stopAirtagSniff() {
     stopScan();
-    Storage::logf("ble", "AirTag sniffing stopped, found %d tags", airtags.size());
+    lockDevices();
+    size_t found = airtags.size();
+    unlockDevices();
+    Storage::logf("ble", "AirTag sniffing stopped, found %u tags", (unsigned)found);
 }
 
 void BLEModule::spoofAirtag(const uint8_t* payload, size_t len) {
@@ -734,36 +812,117 @@ std::vector<BLEDeviceInfo>& BLEModule::getAirtagList() {
 // Packet Capture
 // ============================================================================
 
-void BLEModule::startCapture() {
-    capturedPackets.clear();
+void BLEModule::startCapture(const char* filename) {
+    if (capturing) stopCapture();
+    if (!captureLock || captureTaskHandle) return;
+
+    String path = String(PATH_PCAP) + "/" + filename;
+    if (!pcapWriter.open(path.c_str(), PCAP_LINKTYPE_BLUETOOTH_LE_LL_PHDR)) {
+        Serial.println("[BLE] Failed to create PCAP file");
+        return;
+    }
+
+    // No consumer, and the producer skips the ring until capturing is set
+    pduRing.reset();
+    pduReceived = 0;
+    pduDropped = 0;
+    pduHighWater = 0;
+    pcapFilename = path;
+
+    xSemaphoreTake(captureLock, portMAX_DELAY);
     capturing = true;
-    Storage::log("ble", "Packet capture started");
+    xSemaphoreGive(captureLock);
+
+    TaskRegistry::spawn(captureTask, "BLE_Capture", 4096, nullptr, TaskRole::PARSER, &captureTaskHandle);
+
+    Serial.printf("[BLE] PCAP capture started: %s\n", path.c_str());
+    Storage::logf("ble", "PCAP capture started: %s", filename);
 }
 
 void BLEModule::stopCapture() {
+    if (!capturing) return;
+
+    // Once the lock is ours scanTask has finished any report it was copying
+    // and copies no more
+    xSemaphoreTake(captureLock, portMAX_DELAY);
     capturing = false;
-    Storage::logf("ble", "Packet capture stopped, %d packets", capturedPackets.size());
+    xSemaphoreGive(captureLock);
+
+    // Let the task write what's queued and exit on its own; the writer is
+    // only closed once it has
+    if (captureTaskHandle) {
+        xTaskNotifyGive(captureTaskHandle);
+        while (captureTaskHandle) {
+            vTaskDelay(pdMS_TO_TICKS(10));
+        }
+    }
+
+    PcapWriterStats stats = pcapWriter.getStats();
+    pcapWriter.close();
+    pcapFilename = "";
+
+    Storage::logf("ble", "PCAP stopped: %lu reports, %lu dropped, ring peak %lu/%d, %lu written",
+                  (unsigned long)pduReceived, (unsigned long)pduDropped,
+                  (unsigned long)pduHighWater, BLE_PDU_RING_SLOTS,
+                  (unsigned long)stats.packets);
 }
 
 bool BLEModule::isCapturing() {
     return capturing;
 }
 
-std::vector<BLEPacket>& BLEModule::getCapturedPackets() {
-    return capturedPackets;
+BLECaptureStats BLEModule::getCaptureStats() {
+    BLECaptureStats stats;
+    stats.received = pduReceived;
+    stats.dropped = pduDropped;
+    stats.highWater = pduHighWater;
+    return stats;
 }
 
-bool BLEModule::exportPackets(const char* filename) {
-    // Export as CSV for now
-    String path = String(PATH_PCAP) + "/" + filename;
+PcapWriterStats BLEModule::getPcapStats() {
+    return pcapWriter.getStats();
+}
+
+// One LL PDU record: pseudo-header, AdvA, data and an unreported CRC
+static void writePdu(PcapWriter& writer, uint8_t type, const BLEScanReport& report,
+                     const uint8_t* data, uint8_t len) {
+    uint8_t record[BLE_LL_PHDR_RECORD_HEADER + BLE_ADV_DATA_MAX + 3];
+    CaptureSession::buildBLEHeader(record, type, report.addrType != BLE_ADDR_PUBLIC,
+                                   report.advA, len, report.rssi);
+    memcpy(record + BLE_LL_PHDR_RECORD_HEADER, data, len);
+    memset(record + BLE_LL_PHDR_RECORD_HEADER + len, 0, 3);
+    writer.writePacket(record, BLE_LL_PHDR_RECORD_HEADER + len + 3);
+}
+
+void BLEModule::captureTask(void* param) {
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+
+        uint32_t pending = pduRing.size();
+        if (pending > pduHighWater) pduHighWater = pending;
+
+        // Drain fully, even after stopCapture(), so the file ends with the
+        // last report heard
+        int batch = 0;
+        const BLEScanReport* pdu;
+        while ((pdu = pduRing.front()) != nullptr) {
+            writePdu(pcapWriter, pduType(pdu->eventType), *pdu, pdu->data, pdu->advLen);
+            if (pdu->len > pdu->advLen) {
+                writePdu(pcapWriter, BLE_PDU_SCAN_RSP, *pdu, pdu->data + pdu->advLen, pdu->len - pdu->advLen);
+            }
+            pduRing.pop();
 
-    String csv = "timestamp,address,rssi,type\n";
-    for (const auto& pkt : capturedPackets) {
-        csv += String(pkt.timestamp) + "," + pkt.address + "," +
-               String(pkt.rssi) + "," + String(pkt.type) + "\n";
+            if (++batch >= BLE_PDU_BATCH) {
+                batch = 0;
+                taskYIELD();
+            }
+        }
+
+        if (!capturing) break;
     }
 
-    return Storage::writeFile(path.c_str(), csv.c_str());
+    captureTaskHandle = nullptr;
+    TaskRegistry::exit();
 }
 
 // ============================================================================
@@ -786,11 +945,81 @@ void BLEModule::buildMenu(void* menuPtr) {
 
     menu->addItem(MenuItem("View Devices", []() {
         // TODO: Show device list screen
-        auto& devices = BLEModule::getDevices();
-        String msg = String(devices.size()) + " devices found";
+        BLEModule::lockDevices();
+        size_t addresses = BLEModule::getDevices().size();
+        BLEModule::unlockDevices();
+        size_t unique = BLEModule::getClusterer().getPresentCount(millis());
+        String msg = String(unique) + " devices, " + String(addresses) + " addresses";
         UIManager::showMessage("BLE Devices", msg);
     }));
 
+    // Rebuilt on each visit: one row per device, most recently heard first,
+    // with the addresses it has gone by
+    menu->addItem(MenuItem("Unique Devices", [menu]() {
+        static MenuScreen* uniqueScreen = new MenuScreen("Unique Devices", menu);
+        static BLECluster clusters[BLE_CLUSTER_MAX];
+        BLEClusterer& clusterer = BLEModule::getClusterer();
+        size_t count = clusterer.getClusters(clusters, BLE_CLUSTER_MAX);
+        uint32_t now = millis();
+
+        uniqueScreen->items.clear();
+        BLEClusterStats stats = clusterer.getStats();
+        char head[48];
+        snprintf(head, sizeof(head), "%u here, %lu links, %lu splits",
+                 (unsigned)clusterer.getPresentCount(now), (unsigned long)stats.links,
+                 (unsigned long)stats.splits);
+        uniqueScreen->addItem(MenuItem(head, nullptr));
+
+        for (size_t i = 0; i < count; i++) {
+            const BLECluster& c = clusters[i];
+            char label[48];
+            snprintf(label, sizeof(label), "%s %lu addr %ddBm %lus", c.type,
+                     (unsigned long)c.rotations + 1, c.rssi, (unsigned long)((now - c.lastSeen) / 1000));
+
+            // Addresses, oldest first, with when each was heard
+            String text;
+            for (uint8_t h = 0; h < c.count; h++) {
+                const BLEClusterAddr& a = c.history[(c.head + BLE_CLUSTER_HISTORY - c.count + h) % BLE_CLUSTER_HISTORY];
+                char addr[18];
+                char row[48];
+                a.addr.mac().format(addr);
+                snprintf(row, sizeof(row), "%s %lum-%lum ago\n", addr,
+                         (unsigned long)((now - a.firstSeen) / 60000), (unsigned long)((now - a.lastSeen) / 60000));
+                text += row;
+            }
+            String title = String("Device ") + String((unsigned long)c.id);
+            uniqueScreen->addItem(MenuItem(label, [title, text]() {
+                UIManager::showMessage(title, text);
+            }));
+        }
+
+        uniqueScreen->addItem(MenuItem("< Back", nullptr));
+        static_cast<MenuItem&>(uniqueScreen->items.back()).type = MenuItemType::BACK;
+        UIManager::showScreen(uniqueScreen);
+    }));
+
+    menu->addItem(MenuItem("Scan Stats", []() {
+        BLEScanStats stats = BLEModule::getScanStats();
+        char msg[48];
+        snprintf(msg, sizeof(msg), "%lu/s Q %lu/%d Peak %lu Drop %lu",
+                 (unsigned long)stats.perSecond, (unsigned long)stats.queued, BLE_REPORT_RING_SLOTS,
+                 (unsigned long)stats.highWater, (unsigned long)stats.dropped);
+        UIManager::showMessage("BLE Scan", msg);
+    }));
+
+    menu->addItem(MenuItem("Reload Fingerprints", []() {
+        // The scan worker classifies against the rules being replaced
+        if (BLEModule::isScanning()) {
+            UIManager::showMessage("Fingerprints", "Stop the scan first");
+            return;
+        }
+        int loaded = BLEModule::loadFingerprints();
+        char msg[40];
+        snprintf(msg, sizeof(msg), "%u built-in, %d from SD",
+                 (unsigned)BLEFingerprintDb::getBuiltinCount(), loaded < 0 ? 0 : loaded);
+        UIManager::showMessage("Fingerprints", msg);
+    }));
+
     // Spam attacks
     menu->addItem(MenuItem("Apple Spam", []() {
         BLEModule::startSpam(BLEAttackType::APPLE_SPAM);
@@ -822,12 +1051,85 @@ void BLEModule::buildMenu(void* menuPtr) {
         UIManager::showMessage("BLE Attack", "Spam stopped");
     }));
 
+    // Rebuilt on each visit: one row per tracker, most recently heard first
+    menu->addItem(MenuItem("Tracker Alerts", [menu]() {
+        static MenuScreen* trackerScreen = new MenuScreen("Trackers", menu);
+        static TrackerAlert alerts[TRACKER_MAX_ALERTS];
+        TrackerMonitor& monitor = BLEModule::getTrackerMonitor();
+        size_t count = monitor.getAlerts(alerts, TRACKER_MAX_ALERTS);
+
+        trackerScreen->items.clear();
+        if (count == 0) {
+            char line[40];
+            snprintf(line, sizeof(line), "No alerts, %u trackers near", (unsigned)monitor.getTrackedCount());
+            trackerScreen->addItem(MenuItem(line, nullptr));
+        }
+        for (size_t i = 0; i < count; i++) {
+            const TrackerAlert& a = alerts[i];
+            char label[48];
+            snprintf(label, sizeof(label), "%s %u places %lum", a.type, a.locations,
+                     (unsigned long)(a.followedMs / 60000));
+
+            // Where it was heard, oldest first; * where it reached a new place
+            TrackerPoint trail[TRACKER_TRAIL_POINTS];
+            size_t points = monitor.getTrail(a.identity, trail, TRACKER_TRAIL_POINTS);
+            String text;
+            for (size_t p = 0; p < points; p++) {
+                char row[48];
+                snprintf(row, sizeof(row), "%c%lum %.5f,%.5f %ddBm\n", trail[p].place ? '*' : ' ',
+                         (unsigned long)((trail[p].time - trail[0].time) / 60000),
+                         trail[p].latitude / 1e6, trail[p].longitude / 1e6, trail[p].rssi);
+                text += row;
+            }
+            if (!points) text = "Trail aged out";
+
+            char addr[18];
+            a.addr.format(addr);
+            String title = addr;
+            trackerScreen->addItem(MenuItem(label, [title, text]() {
+                UIManager::showMessage(title, text);
+            }));
+        }
+
+        trackerScreen->addItem(MenuItem("< Back", nullptr));
+        static_cast<MenuItem&>(trackerScreen->items.back()).type = MenuItemType::BACK;
+        UIManager::showScreen(trackerScreen);
+    }));
+
     // AirTag
     menu->addItem(MenuItem("AirTag Sniff", []() {
         BLEModule::startAirtagSniff();
         UIManager::showMessage("AirTag", "Sniffing for AirTags...");
     }));
 
+    // Advertising capture
+    menu->addItem(MenuItem("Start PCAP", []() {
+        char filename[32];
+        snprintf(filename, sizeof(filename), "ble_%lu.pcap", millis());
+        BLEModule::startCapture(filename);
+        if (!BLEModule::isScanning()) BLEModule::startScan(0);
+        UIManager::showMessage("BLE PCAP", BLEModule::isCapturing() ? "Capture started" : "Failed to open file");
+    }));
+
+    menu->addItem(MenuItem("Stop PCAP", []() {
+        BLEModule::stopCapture();
+        UIManager::showMessage("BLE PCAP", "Capture stopped");
+    }));
+
+    menu->addItem(MenuItem("PCAP Stats", []() {
+        if (!BLEModule::isCapturing()) {
+            UIManager::showMessage("BLE PCAP", "Not capturing");
+            return;
+        }
+        BLECaptureStats rx = BLEModule::getCaptureStats();
+        PcapWriterStats stats = BLEModule::getPcapStats();
+        char msg[40];
+        snprintf(msg, sizeof(msg), "%lu pkts Drop %lu/%lu",
+                 (unsigned long)stats.packets, (unsigned long)rx.dropped,
+                 (unsigned long)stats.dropped);
+        UIManager::showMessage("BLE PCAP", msg);
+    }));
+
     menu->addItem(MenuItem("< Back", nullptr));
     static_cast<MenuItem&>(menu->items.back()).type = MenuItemType::BACK;
 }
@@ -9,8 +9,17 @@
 #include <Arduino.h>
 #include <NimBLEDevice.h>
 #include <vector>
-#include <map>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 #include "config.h"
+#include "../../core/mac_table.h"
+#include "../../core/table_budget.h"
+#include "../../core/spsc_ring.h"
+#include "../../core/pcap_writer.h"
+#include "ble_adv.h"
+#include "ble_fingerprint.h"
+#include "tracker_monitor.h"
+#include "ble_cluster.h"
 
 // BLE Attack Types
 enum class BLEAttackType {
@@ -28,26 +37,47 @@ enum class BLEAttackType {
     CUSTOM                // Custom advertisement
 };
 
-// Discovered BLE Device
+// Discovered BLE Device. The advertising data is kept as received, a fixed
+// inline buffer, and decoded through the accessors when needed.
 struct BLEDeviceInfo {
-    String address;
-    String name;
-    int rssi;
+    BLEAddr addr;
+    char name[32];        // Last name advertised; empty until one is
+    int8_t rssi;
     bool isConnectable;
-    bool hasName;
-    uint16_t appearance;
-    std::vector<String> serviceUUIDs;
-    std::map<uint16_t, std::vector<uint8_t>> manufacturerData;
     uint32_t lastSeen;
-    uint8_t addressType;
+    uint8_t advLen;
+    uint8_t adv[BLE_ADV_DATA_MAX];  // AD structures of the latest report
 
     // Identified device type
-    String deviceType;
+    const char* deviceType;
     bool isApple;
     bool isSamsung;
     bool isGoogle;
     bool isMicrosoft;
     bool isTracker;  // AirTag, Tile, etc.
+
+    MacAddr mac() const { return addr.mac(); }
+    uint8_t addressType() const { return addr.type(); }
+    bool hasName() const { return name[0] != '\0'; }
+
+    // First manufacturer-specific structure: company ID and the bytes after it
+    bool manufacturerData(uint16_t& companyId, const uint8_t*& data, uint8_t& len) const {
+        BLEAd::Structure ad;
+        if (!BLEAd::find(adv, advLen, BLEAd::TYPE_MANUFACTURER, ad) || ad.len < 2) return false;
+        companyId = ad.data[0] | (ad.data[1] << 8);
+        data = ad.data + 2;
+        len = ad.len - 2;
+        return true;
+    }
+
+    bool hasService(uint16_t uuid16) const { return BLEAd::hasUuid16(adv, advLen, uuid16); }
+
+    // 0 if not advertised
+    uint16_t appearance() const {
+        BLEAd::Structure ad;
+        if (!BLEAd::find(adv, advLen, BLEAd::TYPE_APPEARANCE, ad) || ad.len < 2) return 0;
+        return ad.data[0] | (ad.data[1] << 8);
+    }
 };
 
 // GATT Service Info
@@ -57,13 +87,33 @@ struct GATTServiceInfo {
     std::vector<String> characteristics;
 };
 
-// BLE Packet for logging
-struct BLEPacket {
-    uint32_t timestamp;
-    String address;
+// Advertising report as the scan callback copies it out of NimBLE, for the
+// scan worker and, while capturing, on to the capture task
+struct BLEScanReport {
+    uint32_t time;          // millis() when received
+    uint8_t advA[6];        // Air (little-endian) order
+    uint8_t addrType;       // BLE_ADDR_*
+    uint8_t eventType;      // HCI report event type: ADV_IND = 0, ..., SCAN_RSP = 4
     int8_t rssi;
-    uint8_t type;
-    std::vector<uint8_t> data;
+    uint8_t len;
+    uint8_t advLen;         // Of data, from the advertising PDU; the rest is its scan response
+    uint8_t data[BLE_ADV_DATA_MAX];
+};
+
+// Scan report counters
+struct BLEScanStats {
+    uint32_t received;   // Reports delivered by NimBLE
+    uint32_t dropped;    // Lost because the ring was full
+    uint32_t queued;     // Waiting for the scan worker now
+    uint32_t highWater;  // Most reports ever waiting in the ring
+    uint32_t perSecond;  // Received over the last second
+};
+
+// Advertising capture counters
+struct BLECaptureStats {
+    uint32_t received;   // Reports delivered while capturing
+    uint32_t dropped;    // Lost because the ring was full
+    uint32_t highWater;  // Most PDUs ever waiting in the ring
 };
 
 class BLEModule {
@@ -76,9 +126,23 @@ public:
     static void startScan(uint32_t duration = 0);  // 0 = continuous
     static void stopScan();
     static bool isScanning();
-    static std::vector<BLEDeviceInfo>& getDevices();
+    // For RadioScheduler: takes the radio off BLE without ending the scan
+    static void pauseScan(bool paused);
+    static MacTable<BLEDeviceInfo, BLEAddr>& getDevices();
     static void clearDevices();
-    static BLEDeviceInfo* getDevice(const String& address);
+    // Held while the device table changes: the scan worker records into
+    // it and expiry erases from the main loop. Take it to walk the table,
+    // and hold it while using what getDevice() or getAirtagList() return.
+    static void lockDevices();
+    static void unlockDevices();
+    static BLEDeviceInfo* getDevice(const BLEAddr& addr);
+    static TableStats getDeviceTableStats();
+    static BLEScanStats getScanStats();
+
+    // Trackers that keep turning up as the unit moves (tracker_monitor.h)
+    static TrackerMonitor& getTrackerMonitor();
+    // Devices across their address rotations (ble_cluster.h)
+    static BLEClusterer& getClusterer();
 
     // GATT Operations
     static bool connect(const String& address);
@@ -108,12 +172,27 @@ public:
     static void sendMouseClick(uint8_t button);
     static void sendMouseScroll(int8_t delta);
 
-    // Packet capture
-    static void startCapture();
+    // Packet capture: every advertising report to PATH_PCAP/filename as
+    // LINKTYPE_BLUETOOTH_LE_LL_WITH_PHDR, which carries the RSSI
+    static void startCapture(const char* filename);
     static void stopCapture();
     static bool isCapturing();
-    static std::vector<BLEPacket>& getCapturedPackets();
-    static bool exportPackets(const char* filename);
+    static BLECaptureStats getCaptureStats();
+    static PcapWriterStats getPcapStats();
+
+    // Device identification (ble_identify.cpp, also built by the native benchmark)
+    static void identifyDevice(BLEDeviceInfo& device);
+    // Replaces the SD fingerprint rules (ble_fingerprint.h) and re-identifies
+    // every tracked device; the number of rules loaded, or -1
+    static int loadFingerprints(const char* path = BLE_FINGERPRINT_FILE);
+
+    // Device table (ble_devices.cpp, also built by the native benchmark).
+    // Updates or adds the advertiser, identifying it when it's new; nullptr
+    // if it's new and the table has nothing it may give up.
+    static void setDeviceBudget(size_t bytes);
+    static BLEDeviceInfo* recordAdvertisement(const BLEAddr& addr, int8_t rssi, bool connectable,
+                                              const uint8_t* payload, size_t len, uint32_t now,
+                                              bool* created = nullptr);
 
     // Menu integration
     static void buildMenu(void* menuScreen);
@@ -121,14 +200,52 @@ public:
 private:
     static bool initialized;
     static bool scanning;
+    static bool scanPaused;
+    static uint32_t scanDeadline;   // millis() a timed scan ends, 0 if continuous
+    // Held by startScan(), stopScan() and pauseScan(): the main loop and
+    // RadioScheduler both start and stop the radio
+    static SemaphoreHandle_t scanLock;
     static bool spamming;
     static bool capturing;
     static bool connected;
     static BLEAttackType currentAttack;
 
-    static std::vector<BLEDeviceInfo> devices;
+    static MacTable<BLEDeviceInfo, BLEAddr> devices;
+    static SemaphoreHandle_t devicesLock;
+    static TableStats deviceTable;
+    static TrackerMonitor trackerMonitor;
+    static BLEClusterer clusterer;
     static std::vector<BLEDeviceInfo> airtags;
-    static std::vector<BLEPacket> capturedPackets;
+
+    // Scan callback -> scanTask, which does everything else with a report
+    static SpscRing<BLEScanReport, BLE_REPORT_RING_SLOTS> reportRing;
+    static volatile uint32_t reportReceived;
+    static volatile uint32_t reportDropped;
+    static uint32_t reportHighWater;
+    static uint32_t reportRate;
+    static uint32_t rateReceived;
+    static uint32_t rateStart;
+
+    // While capturing, scanTask passes every report through pduRing to
+    // captureTask, which formats it for pcapWriter
+    static SpscRing<BLEScanReport, BLE_PDU_RING_SLOTS> pduRing;
+    static PcapWriter pcapWriter;
+    static String pcapFilename;
+    static TaskHandle_t captureTaskHandle;
+    // Held by scanTask while it copies a report into pduRing, and by
+    // startCapture()/stopCapture() to switch capturing
+    static SemaphoreHandle_t captureLock;
+    static uint32_t pduReceived;
+    static uint32_t pduDropped;
+    static uint32_t pduHighWater;
+
+    // Drains reportRing into the device table in batches
+    static void scanTask(void* param);
+    static void endScan();
+    static void processReport(const BLEScanReport& report);
+
+    // Drains pduRing into pcapWriter
+    static void captureTask(void* param);
 
     static NimBLEClient* pClient;
     static NimBLEAdvertising* pAdvertising;
@@ -146,9 +263,8 @@ private:
     static void sendAirtagSpam();
     static void sendAllSpam();
 
-    // Device identification
-    static void identifyDevice(BLEDeviceInfo& device);
-    static String getDeviceTypeName(const BLEDeviceInfo& device);
+    // Make room in a full device table by giving up its least valuable entry
+    static bool evictDevice(uint32_t now);
 
     // Scan callback
     class ScanCallbacks : public NimBLEAdvertisedDeviceCallbacks {
@@ -157,7 +273,6 @@ private:
     };
 
     static ScanCallbacks scanCallbacks;
-    static void onScanComplete(NimBLEScanResults results);
 };
 
 // ============================================================================
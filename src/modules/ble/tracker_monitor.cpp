@@ -0,0 +1,260 @@
+/**
+ * ShitBird Firmware - "Following Me" Tracker Detection Implementation
+ */
+
+#include "tracker_monitor.h"
+#include "../../core/storage.h"
+#include <math.h>
+
+TrackerMonitor::TrackerMonitor() {
+    reset();
+}
+
+void TrackerMonitor::reset() {
+    portENTER_CRITICAL(&mux);
+    for (auto& t : trackers) t.used = false;
+    for (auto& a : alerts) a.identity = 0;
+    memset(pendingLog, 0, sizeof(pendingLog));
+    position = WardriveFix();
+    evicted = 0;
+    portEXIT_CRITICAL(&mux);
+}
+
+void TrackerMonitor::setPosition(const WardriveFix& fix) {
+    portENTER_CRITICAL(&mux);
+    position = fix;
+    portEXIT_CRITICAL(&mux);
+}
+
+void TrackerMonitor::observe(uint64_t identity, const BLEAddr& addr, int8_t rssi,
+                             const char* type, uint32_t now) {
+    Tracker snapshot;
+    WardriveFix fix;
+
+    portENTER_CRITICAL(&mux);
+    Tracker* t = find(identity);
+    if (!t) t = insert(identity);
+
+    // Unheard long enough and it's a new run: it wasn't following
+    if (!t->used || now - t->lastSeen > TRACKER_FORGET_MS) {
+        t->used = true;
+        t->firstSeen = now;
+        t->locations = 0;
+        t->head = 0;
+        t->points = 0;
+        t->alerted = false;
+    }
+    t->addr = addr.mac();
+    strncpy(t->type, type, sizeof(t->type) - 1);
+    t->type[sizeof(t->type) - 1] = '\0';
+    t->lastSeen = now;
+    t->rssi = rssi;
+
+    fix = position;
+    if (!fix.valid) {
+        check(*t, now);
+        portEXIT_CRITICAL(&mux);
+        return;
+    }
+    snapshot = *t;
+    portEXIT_CRITICAL(&mux);
+
+    // The distance math runs unlocked against a copy. Only this task adds
+    // points, so the trail still matches it unless reset() cleared it.
+    TrackerPoint point;
+    bool add = nextPoint(snapshot, fix, rssi, now, point);
+
+    portENTER_CRITICAL(&mux);
+    t = find(identity);
+    if (t && t->firstSeen == snapshot.firstSeen) {
+        if (add) append(*t, point);
+        check(*t, now);
+    }
+    portEXIT_CRITICAL(&mux);
+}
+
+// Caller holds mux
+TrackerMonitor::Tracker* TrackerMonitor::find(uint64_t identity) {
+    for (auto& t : trackers) {
+        if (t.used && t.identity == identity) return &t;
+    }
+    return nullptr;
+}
+
+// Caller holds mux. A free slot, else the tracker unheard longest; one that
+// has raised an alert goes last.
+TrackerMonitor::Tracker* TrackerMonitor::insert(uint64_t identity) {
+    Tracker* victim = nullptr;
+    for (auto& t : trackers) {
+        if (!t.used) {
+            victim = &t;
+            break;
+        }
+        if (!victim || t.alerted < victim->alerted ||
+            (t.alerted == victim->alerted && (int32_t)(t.lastSeen - victim->lastSeen) < 0)) {
+            victim = &t;
+        }
+    }
+    if (victim->used) evicted++;
+    victim->used = false;
+    victim->identity = identity;
+    return victim;
+}
+
+// A point per TRACKER_SAMPLE_MS or per quarter of TRACKER_LOCATION_M
+// moved; a new place when it's that far from every place still in the
+// trail. false if t's trail needs no point for this sighting.
+bool TrackerMonitor::nextPoint(const Tracker& t, const WardriveFix& fix, int8_t rssi, uint32_t now,
+                               TrackerPoint& point) {
+    int32_t lat = (int32_t)lround(fix.latitude * 1e6);
+    int32_t lon = (int32_t)lround(fix.longitude * 1e6);
+
+    if (t.points) {
+        const TrackerPoint& latest = t.trail[(t.head + TRACKER_TRAIL_POINTS - 1) % TRACKER_TRAIL_POINTS];
+        if (now - latest.time < TRACKER_SAMPLE_MS &&
+            distanceM(latest.latitude, latest.longitude, lat, lon) < TRACKER_LOCATION_M / 4) {
+            return false;
+        }
+    }
+
+    bool newPlace = true;
+    for (uint8_t i = 0; i < t.points && newPlace; i++) {
+        const TrackerPoint& p = t.trail[i];
+        if (p.place && distanceM(p.latitude, p.longitude, lat, lon) < TRACKER_LOCATION_M) newPlace = false;
+    }
+
+    point = {now, lat, lon, rssi, newPlace};
+    return true;
+}
+
+// Caller holds mux
+void TrackerMonitor::append(Tracker& t, const TrackerPoint& point) {
+    if (point.place && t.locations < 255) t.locations++;
+
+    t.trail[t.head] = point;
+    t.head = (t.head + 1) % TRACKER_TRAIL_POINTS;
+    if (t.points < TRACKER_TRAIL_POINTS) t.points++;
+}
+
+// Caller holds mux. Raises or updates t's alert once it's been at enough places.
+void TrackerMonitor::check(Tracker& t, uint32_t now) {
+    if (t.locations >= TRACKER_ALERT_LOCATIONS ||
+        (t.locations >= 2 && now - t.firstSeen >= TRACKER_ALERT_MS)) {
+        raise(t);
+        t.alerted = true;
+    }
+}
+
+// Equirectangular; plenty for a few kilometres
+uint32_t TrackerMonitor::distanceM(int32_t lat1, int32_t lon1, int32_t lat2, int32_t lon2) {
+    const double M_PER_MICRODEGREE = 0.111195;
+    double meanLat = (lat1 + lat2) * 0.5e-6 * M_PI / 180.0;
+    double dx = (double)(lon2 - lon1) * cos(meanLat) * M_PER_MICRODEGREE;
+    double dy = (double)(lat2 - lat1) * M_PER_MICRODEGREE;
+    return (uint32_t)sqrt(dx * dx + dy * dy);
+}
+
+// Caller holds mux. One alert per tracker, updated while it keeps following;
+// a new one takes the slot of the alert updated longest ago.
+void TrackerMonitor::raise(const Tracker& t) {
+    uint8_t slot = 0;
+    bool found = false;
+    for (uint8_t i = 0; i < TRACKER_MAX_ALERTS; i++) {
+        if (alerts[i].identity == t.identity) {
+            slot = i;
+            found = true;
+            break;
+        }
+        if (alerts[i].identity == 0) {
+            slot = i;
+            break;
+        }
+        if (alerts[slot].identity && (int32_t)(alerts[i].last - alerts[slot].last) < 0) slot = i;
+    }
+
+    TrackerAlert& a = alerts[slot];
+    if (!found || !t.alerted) {
+        a.identity = t.identity;
+        a.first = t.lastSeen;
+        pendingLog[slot] = true;
+    }
+    a.addr = t.addr;
+    memcpy(a.type, t.type, sizeof(a.type));
+    a.locations = t.locations;
+    a.followedMs = t.lastSeen - t.firstSeen;
+    a.rssi = t.rssi;
+    a.last = t.lastSeen;
+}
+
+size_t TrackerMonitor::poll() {
+    TrackerAlert toLog[TRACKER_MAX_ALERTS];
+    size_t n = 0;
+
+    portENTER_CRITICAL(&mux);
+    for (uint8_t i = 0; i < TRACKER_MAX_ALERTS; i++) {
+        if (!pendingLog[i]) continue;
+        toLog[n++] = alerts[i];
+        pendingLog[i] = false;
+    }
+    portEXIT_CRITICAL(&mux);
+
+    // SD writes stay out of the scan worker and outside the lock
+    for (size_t i = 0; i < n; i++) {
+        const TrackerAlert& a = toLog[i];
+        char addr[18];
+        a.addr.format(addr);
+
+        Serial.printf("[TRACKER] %s %s following: %u places, %lu min\n", a.type, addr,
+                      a.locations, (unsigned long)(a.followedMs / 60000));
+        Storage::logf("tracker", "%s %s (id %016llX) seen at %u places over %lu s, rssi %d",
+                      a.type, addr, (unsigned long long)a.identity, a.locations,
+                      (unsigned long)(a.followedMs / 1000), a.rssi);
+    }
+    return n;
+}
+
+size_t TrackerMonitor::getAlerts(TrackerAlert* out, size_t max) const {
+    uint8_t order[TRACKER_MAX_ALERTS];
+    size_t used = 0;
+    size_t n = 0;
+
+    portENTER_CRITICAL(&mux);
+    // Insertion sort by latest sighting, newest first; there are only a handful
+    for (uint8_t i = 0; i < TRACKER_MAX_ALERTS; i++) {
+        if (alerts[i].identity == 0) continue;
+        size_t j = used++;
+        while (j > 0 && (int32_t)(alerts[order[j - 1]].last - alerts[i].last) < 0) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+    for (; n < used && n < max; n++) out[n] = alerts[order[n]];
+    portEXIT_CRITICAL(&mux);
+    return n;
+}
+
+size_t TrackerMonitor::getTrail(uint64_t identity, TrackerPoint* out, size_t max) const {
+    size_t n = 0;
+    portENTER_CRITICAL(&mux);
+    for (const auto& t : trackers) {
+        if (!t.used || t.identity != identity) continue;
+        uint8_t start = (t.head + TRACKER_TRAIL_POINTS - t.points) % TRACKER_TRAIL_POINTS;
+        for (; n < t.points && n < max; n++) {
+            out[n] = t.trail[(start + n) % TRACKER_TRAIL_POINTS];
+        }
+        break;
+    }
+    portEXIT_CRITICAL(&mux);
+    return n;
+}
+
+size_t TrackerMonitor::getTrackedCount() const {
+    size_t n = 0;
+    portENTER_CRITICAL(&mux);
+    for (const auto& t : trackers) {
+        if (t.used) n++;
+    }
+    portEXIT_CRITICAL(&mux);
+    return n;
+}
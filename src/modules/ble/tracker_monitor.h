@@ -0,0 +1,112 @@
+/**
+ * ShitBird Firmware - "Following Me" Tracker Detection
+ *
+ * Keeps a short trail of where and when each tracker-class advertiser was
+ * heard, fed with the GPS position. A tracker heard at
+ * TRACKER_ALERT_LOCATIONS places TRACKER_LOCATION_M apart, or heard for
+ * TRACKER_ALERT_MS at more than one place, raises an alert.
+ *
+ * Trackers are told apart by BLEClusterer identity, not address. A Find My
+ * or Find My Device tag rotates its key material together with its address,
+ * so neither outlasts a rotation; once the clusterer links the new address
+ * to the old one, sightings go back to the old trail. Until then, a few
+ * advertising intervals, the new address has a trail of its own.
+ *
+ * Both the trackers and their trails are fixed arrays. A full table replaces
+ * the tracker unheard longest, and each trail is a ring of
+ * TRACKER_TRAIL_POINTS, so a busy transit station can't exhaust RAM.
+ *
+ * observe() is for the BLE scan context; setPosition(), poll() and the
+ * getters are for the main loop.
+ */
+
+#ifndef SHITBIRD_TRACKER_MONITOR_H
+#define SHITBIRD_TRACKER_MONITOR_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include "config.h"
+#include "ble_adv.h"
+#include "ble_fingerprint.h"
+#include "../../core/wardrive_log.h"
+
+// One place a tracker was heard
+struct TrackerPoint {
+    uint32_t time;         // millis()
+    int32_t latitude;      // Microdegrees
+    int32_t longitude;
+    int8_t rssi;
+    bool place;            // First point at a new place
+};
+
+struct TrackerAlert {
+    uint64_t identity;     // BLEClusterer identity
+    MacAddr addr;          // Latest address it used
+    char type[BLE_FP_TYPE_MAX];  // deviceType when raised
+    uint8_t locations;     // Distinct places it was heard
+    uint32_t followedMs;   // From first to latest sighting
+    int8_t rssi;           // Of the latest sighting
+    uint32_t first;        // millis() when raised
+    uint32_t last;         // Latest sighting since
+};
+
+class TrackerMonitor {
+public:
+    TrackerMonitor();
+
+    // One advertisement from a tracker-class device; identity is what
+    // BLEClusterer::observe() returned for it. type is copied.
+    void observe(uint64_t identity, const BLEAddr& addr, int8_t rssi,
+                 const char* type, uint32_t now);
+
+    // Without a valid fix sightings still count, but not as places
+    void setPosition(const WardriveFix& fix);
+
+    // Main loop: logs new alerts to SD; how many there were
+    size_t poll();
+
+    // Copies up to max alerts, most recent first; returns how many
+    size_t getAlerts(TrackerAlert* out, size_t max) const;
+    // The trail of one tracker, oldest first; returns how many points
+    size_t getTrail(uint64_t identity, TrackerPoint* out, size_t max) const;
+    size_t getTrackedCount() const;
+    uint32_t getEvicted() const { return evicted; }
+
+    void reset();
+
+private:
+    struct Tracker {
+        uint64_t identity;
+        MacAddr addr;
+        char type[BLE_FP_TYPE_MAX];
+        uint32_t firstSeen;     // Start of the current run of sightings
+        uint32_t lastSeen;
+        int8_t rssi;
+        uint8_t locations;
+        uint8_t head;           // Next trail slot
+        uint8_t points;         // Trail slots in use
+        bool used;
+        bool alerted;           // This run has raised its alert
+        TrackerPoint trail[TRACKER_TRAIL_POINTS];
+    };
+
+    Tracker trackers[TRACKER_MAX_DEVICES];
+    TrackerAlert alerts[TRACKER_MAX_ALERTS];
+    bool pendingLog[TRACKER_MAX_ALERTS];
+    WardriveFix position;
+    uint32_t evicted;
+    mutable portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+
+    Tracker* find(uint64_t identity);
+    Tracker* insert(uint64_t identity);
+    void append(Tracker& t, const TrackerPoint& point);
+    void check(Tracker& t, uint32_t now);
+    void raise(const Tracker& t);
+
+    static bool nextPoint(const Tracker& t, const WardriveFix& fix, int8_t rssi, uint32_t now,
+                          TrackerPoint& point);
+
+    static uint32_t distanceM(int32_t lat1, int32_t lon1, int32_t lat2, int32_t lon2);
+};
+
+#endif // SHITBIRD_TRACKER_MONITOR_H
@@ -4,6 +4,8 @@
 
 #include "gps_module.h"
 #include "../../core/system.h"
+#include "../../core/storage.h"
+#include "../../core/wardrive_log.h"
 #include "../../ui/ui_manager.h"
 
 // Static member initialization
@@ -37,6 +39,10 @@ void GPSModule::update() {
     
     // Update last data if we have a valid location
     processGPS();
+
+    if (WardriveLog::isActive()) {
+        WardriveLog::setPosition(getFix());
+    }
 }
 
 void GPSModule::deinit() {
@@ -89,6 +95,31 @@ void GPSModule::processGPS() {
     }
 }
 
+// Days since 1970-01-01 for a proleptic Gregorian date
+static int32_t daysFromCivil(int32_t y, uint32_t m, uint32_t d) {
+    y -= m <= 2;
+    int32_t era = (y >= 0 ? y : y - 399) / 400;
+    uint32_t yoe = (uint32_t)(y - era * 400);
+    uint32_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (int32_t)doe - 719468;
+}
+
+WardriveFix GPSModule::getFix() {
+    WardriveFix fix = {};
+    fix.valid = hasFix();
+    fix.latitude = lastData.latitude;
+    fix.longitude = lastData.longitude;
+    fix.altitude = lastData.altitude;
+    // TinyGPS++ reports HDOP x100; ~2.5 m UERE is typical for a u-blox M10
+    fix.accuracy = lastData.hdop / 100.0f * 2.5f;
+    if (lastData.year >= 1970) {
+        fix.time = daysFromCivil(lastData.year, lastData.month, lastData.day) * 86400UL +
+                   lastData.hour * 3600UL + lastData.minute * 60UL + lastData.second;
+    }
+    return fix;
+}
+
 bool GPSModule::isInitialized() {
     return initialized;
 }
@@ -227,5 +258,38 @@ void GPSModule::buildMenu(void* menuPtr) {
         UIManager::showMessage("GPS Time", date + "\n" + time, 3000);
     }));
     
+    menu->addItem(MenuItem("Start Wardrive", []() {
+        if (!Storage::isMounted()) {
+            UIManager::showMessage("Wardrive", "No SD card", 2000);
+            return;
+        }
+        char path[48];
+        snprintf(path, sizeof(path), PATH_WARDRIVE "/wardrive_%lu.csv", millis());
+        if (WardriveLog::start(path)) {
+            UIManager::showMessage("Wardrive", GPSModule::hasFix() ? "Logging" : "Logging (waiting for fix)", 2000);
+        } else {
+            UIManager::showMessage("Wardrive", "Failed to create file", 2000);
+        }
+    }));
+
+    menu->addItem(MenuItem("Stop Wardrive", []() {
+        if (!WardriveLog::isActive()) {
+            UIManager::showMessage("Wardrive", "Not running", 2000);
+            return;
+        }
+        WardriveLog::stop();
+        WardriveStats stats = WardriveLog::getStats();
+        UIManager::showMessage("Wardrive", String(stats.records) + " devices saved", 3000);
+    }));
+
+    menu->addItem(MenuItem("Wardrive Stats", []() {
+        WardriveStats stats = WardriveLog::getStats();
+        char buf[40];
+        snprintf(buf, sizeof(buf), "%lu dev %.1f r/s flush %lums",
+                 (unsigned long)stats.records, stats.rowsPerSec,
+                 (unsigned long)(stats.maxFlushUs / 1000));
+        UIManager::showMessage(WardriveLog::isActive() ? "Wardrive (running)" : "Wardrive", buf, 4000);
+    }));
+
     menu->addItem(MenuItem::back());
 }
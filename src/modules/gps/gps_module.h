@@ -9,6 +9,7 @@
 #include <Arduino.h>
 #include <TinyGPSPlus.h>
 #include "config.h"
+#include "../../core/wardrive_log.h"
 
 struct GPSData {
     double latitude;
@@ -48,6 +49,8 @@ public:
     static double getAltitude();
     static double getSpeed();
     static double getCourse();
+    // Invalid without a fix
+    static WardriveFix getFix();
     
     // Formatting
     static String getPositionString();
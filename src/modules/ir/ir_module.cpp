@@ -5,6 +5,7 @@
 #include "ir_module.h"
 #include "../../core/system.h"
 #include "../../core/storage.h"
+#include "../../core/task_registry.h"
 #include "../../ui/ui_manager.h"
 
 // Static member initialization
@@ -255,15 +256,7 @@ void IRModule::startTVBGone() {
     tvbGoneIndex = 0;
     g_systemState.currentMode = OperationMode::IR_TX;
 
-    xTaskCreatePinnedToCore(
-        tvbGoneTask,
-        "IR_TVBGone",
-        4096,
-        nullptr,
-        1,
-        &tvbGoneTaskHandle,
-        0
-    );
+    TaskRegistry::spawn(tvbGoneTask, "IR_TVBGone", 4096, nullptr, TaskRole::ATTACK, &tvbGoneTaskHandle);
 
     Storage::log("ir", "TV-B-Gone started");
 }
@@ -274,10 +267,7 @@ void IRModule::stopTVBGone() {
     Serial.println("[IR] Stopping TV-B-Gone");
     tvbGoneRunning = false;
 
-    if (tvbGoneTaskHandle) {
-        vTaskDelete(tvbGoneTaskHandle);
-        tvbGoneTaskHandle = nullptr;
-    }
+    TaskRegistry::kill(tvbGoneTaskHandle);
 
     if (g_systemState.currentMode == OperationMode::IR_TX) {
         g_systemState.currentMode = OperationMode::IDLE;
@@ -359,7 +349,7 @@ void IRModule::tvbGoneTask(void* param) {
         g_systemState.currentMode = OperationMode::IDLE;
     }
 
-    vTaskDelete(nullptr);
+    TaskRegistry::exit();
 }
 
 // ============================================================================
@@ -440,15 +430,7 @@ void IRModule::startBruteForce(IRProtocol protocol, uint16_t startCode) {
     bruteForceCode = startCode;
     g_systemState.currentMode = OperationMode::IR_TX;
 
-    xTaskCreatePinnedToCore(
-        bruteForceTask,
-        "IR_BruteForce",
-        4096,
-        nullptr,
-        1,
-        &bruteForceTaskHandle,
-        0
-    );
+    TaskRegistry::spawn(bruteForceTask, "IR_BruteForce", 4096, nullptr, TaskRole::ATTACK, &bruteForceTaskHandle);
 
     Storage::logf("ir", "Brute force started: %s",
                   protocolToString(protocol).c_str());
@@ -460,10 +442,7 @@ void IRModule::stopBruteForce() {
     Serial.println("[IR] Stopping brute force");
     bruteForcing = false;
 
-    if (bruteForceTaskHandle) {
-        vTaskDelete(bruteForceTaskHandle);
-        bruteForceTaskHandle = nullptr;
-    }
+    TaskRegistry::kill(bruteForceTaskHandle);
 
     if (g_systemState.currentMode == OperationMode::IR_TX) {
         g_systemState.currentMode = OperationMode::IDLE;
@@ -512,7 +491,7 @@ void IRModule::bruteForceTask(void* param) {
         g_systemState.currentMode = OperationMode::IDLE;
     }
 
-    vTaskDelete(nullptr);
+    TaskRegistry::exit();
 }
 
 // ============================================================================
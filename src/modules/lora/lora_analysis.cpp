@@ -0,0 +1,123 @@
+/**
+ * ShitBird Firmware - LoRa Packet Analysis
+ *
+ * Packet identification and Meshtastic header decoding. Independent of the
+ * radio driver so the native environment can build it.
+ */
+
+#include "lora_module.h"
+#include "../../core/expiry_wheel.h"
+
+// Meshtastic decode state
+MacTable<MeshtasticNode, MeshNodeId> LoRaModule::meshtasticNodes;
+TableStats LoRaModule::nodeTable = {"Mesh nodes"};
+uint8_t LoRaModule::meshtasticKey[32] = {0};
+bool LoRaModule::hasMeshtasticKey = false;
+
+LoRaPacketType LoRaModule::identifyPacket(const uint8_t* data, size_t len) {
+    if (len < 4) return LoRaPacketType::UNKNOWN;
+
+    // Check for Meshtastic packet structure
+    // Meshtastic packets have a specific header format
+    if (len >= sizeof(Meshtastic::PacketHeader)) {
+        // Check if it looks like a Meshtastic packet
+        // The first bytes should be destination node ID
+        return LoRaPacketType::MESHTASTIC;
+    }
+
+    // TODO: Add MeshCore and LoRaWAN detection
+
+    return LoRaPacketType::RAW;
+}
+
+bool LoRaModule::decodeMeshtasticPacket(LoRaPacket& packet) {
+    if (packet.data.size() < sizeof(Meshtastic::PacketHeader)) {
+        return false;
+    }
+
+    const uint8_t* data = packet.data.data();
+    const Meshtastic::PacketHeader* header = (const Meshtastic::PacketHeader*)data;
+
+    packet.meshFrom = header->sender;
+    packet.meshTo = header->dest;
+    packet.meshHopLimit = header->flags & 0x07;
+    packet.meshWantAck = (header->flags >> 3) & 0x01;
+
+    // Update node list
+    updateMeshtasticNode(packet);
+
+    // The payload after header is encrypted with AES-128 or AES-256
+    // Decryption requires the channel key
+    if (hasMeshtasticKey) {
+        // TODO: Implement AES decryption
+        packet.decoded = false;
+    }
+
+    return true;
+}
+
+bool LoRaModule::decodeMeshCorePacket(LoRaPacket& packet) {
+    // TODO: Implement MeshCore packet decoding
+    return false;
+}
+
+void LoRaModule::updateMeshtasticNode(const LoRaPacket& packet) {
+    uint32_t now = millis();
+
+    // init() sizes it; the native build has no radio to init
+    if (!meshtasticNodes.capacity()) setNodeBudget(LORA_NODE_TABLE_BYTES);
+
+    if (MeshtasticNode* node = meshtasticNodes.find(packet.meshFrom)) {
+        node->lastRssi = packet.rssi;
+        node->lastSeen = now;
+        return;
+    }
+
+    // Full: the least valuable node gives up its place
+    if (meshtasticNodes.full()) {
+        MacHandle victim = meshtasticNodes.leastValuable([now](const MeshtasticNode& node) {
+            return evictionCost(node.lastRssi, node.lastSeen, now);
+        });
+        MeshtasticNode* old = meshtasticNodes.get(victim);
+        if (!old) {
+            nodeTable.refused++;
+            return;
+        }
+        ExpiryWheel::cancel(ExpiryTable::LORA_NODE, victim);
+        meshtasticNodes.erase(old->nodeId);
+        nodeTable.evicted++;
+    }
+
+    MeshtasticNode* node = meshtasticNodes.insert(packet.meshFrom);
+    if (!node) return;
+    node->nodeId = packet.meshFrom;
+    node->lastRssi = packet.rssi;
+    node->lastSeen = now;
+    node->hopLimit = packet.meshHopLimit;
+    ExpiryWheel::schedule(ExpiryTable::LORA_NODE, meshtasticNodes.findHandle(packet.meshFrom), now);
+
+    Serial.printf("[LORA] New Meshtastic node: %08X\n", packet.meshFrom);
+}
+
+void LoRaModule::setNodeBudget(size_t bytes) {
+    ExpiryWheel::clear(ExpiryTable::LORA_NODE);
+    meshtasticNodes.bound(bytes / MacTable<MeshtasticNode, MeshNodeId>::entryBytes());
+    nodeTable.bytes = bytes;
+    nodeTable.capacity = meshtasticNodes.capacity();
+}
+
+TableStats LoRaModule::getNodeTableStats() {
+    TableStats s = nodeTable;
+    s.size = meshtasticNodes.size();
+    return s;
+}
+
+String LoRaModule::packetToHex(const uint8_t* data, size_t len) {
+    String hex = "";
+    for (size_t i = 0; i < len; i++) {
+        char buf[4];
+        snprintf(buf, sizeof(buf), "%02X ", data[i]);
+        hex += buf;
+    }
+    return hex;
+}
@@ -5,6 +5,9 @@
 #include "lora_module.h"
 #include "../../core/system.h"
 #include "../../core/storage.h"
+#include "../../core/task_registry.h"
+#include "../../core/capture_session.h"
+#include "../../core/expiry_wheel.h"
 #include "../../ui/ui_manager.h"
 #include <SPI.h>
 
@@ -22,7 +25,6 @@ volatile bool LoRaModule::transmittedFlag = false;
 
 LoRaPacket LoRaModule::lastPacket;
 std::vector<LoRaPacket> LoRaModule::packetHistory;
-std::vector<MeshtasticNode> LoRaModule::meshtasticNodes;
 std::vector<FrequencyScanResult> LoRaModule::frequencyResults;
 
 float LoRaModule::currentFrequency = LORA_FREQUENCY;
@@ -32,9 +34,6 @@ uint8_t LoRaModule::currentCR = LORA_CODING_RATE;
 uint8_t LoRaModule::currentSyncWord = LORA_SYNC_WORD;
 int8_t LoRaModule::currentTxPower = LORA_TX_POWER;
 
-uint8_t LoRaModule::meshtasticKey[32] = {0};
-bool LoRaModule::hasMeshtasticKey = false;
-
 // Node identity - generate from MAC
 uint32_t LoRaModule::myNodeId = 0;
 String LoRaModule::myLongName = "ShitBird";
@@ -125,6 +124,23 @@ void LoRaModule::init() {
     // Configure for best sensitivity
     radio->setRxBoostedGainMode(true);
 
+    if (!meshtasticNodes.capacity()) setNodeBudget(LORA_NODE_TABLE_BYTES);
+
+    // Keyed by handle, as the WiFi and BLE tables are. Everything that
+    // touches the nodes runs on the main loop, so there's no lock.
+    ExpiryWheel::registerTable(ExpiryTable::LORA_NODE, LORA_NODE_TTL,
+        [](uint64_t key, uint32_t& lastSeen) {
+            const MeshtasticNode* node = meshtasticNodes.get((MacHandle)key);
+            if (node) lastSeen = node->lastSeen;
+            return node != nullptr;
+        },
+        [](uint64_t key, uint32_t staleBefore) {
+            MeshtasticNode* node = meshtasticNodes.get((MacHandle)key);
+            bool stale = node && (int32_t)(node->lastSeen - staleBefore) <= 0;
+            if (stale) meshtasticNodes.erase(node->nodeId);
+            return stale;
+        });
+
     initialized = true;
     g_systemState.loraActive = true;
 
@@ -283,6 +299,9 @@ void LoRaModule::processReceivedPacket() {
         packet.data.assign(data, data + len);
         packet.decoded = false;
 
+        CaptureSession::writeLoRa(currentFrequency, currentBandwidth, currentSF, currentSyncWord,
+                                  packet.rssi, packet.snr, data, len);
+
         // Identify packet type
         packet.type = identifyPacket(data, len);
 
@@ -364,6 +383,7 @@ void LoRaModule::startMeshtasticSniff() {
 
     currentMode = LoRaMode::MESHTASTIC_SNIFF;
     meshtasticNodes.clear();
+    ExpiryWheel::clear(ExpiryTable::LORA_NODE);
 
     radio->startReceive();
 
@@ -385,7 +405,7 @@ bool LoRaModule::isMeshtasticSniffing() {
     return currentMode == LoRaMode::MESHTASTIC_SNIFF;
 }
 
-std::vector<MeshtasticNode>& LoRaModule::getMeshtasticNodes() {
+MacTable<MeshtasticNode, MeshNodeId>& LoRaModule::getMeshtasticNodes() {
     return meshtasticNodes;
 }
 
@@ -473,15 +493,7 @@ void LoRaModule::startFrequencyAnalyzer(float startFreq, float endFreq, float st
     params[1] = endFreq;
     params[2] = step;
 
-    xTaskCreatePinnedToCore(
-        analyzerTask,
-        "LoRa_Analyzer",
-        4096,
-        params,
-        1,
-        &analyzerTaskHandle,
-        0
-    );
+    TaskRegistry::spawn(analyzerTask, "LoRa_Analyzer", 4096, params, TaskRole::RADIO, &analyzerTaskHandle);
 
     Storage::logf("lora", "Frequency analyzer: %.3f-%.3f MHz", startFreq, endFreq);
 }
@@ -489,10 +501,7 @@ void LoRaModule::startFrequencyAnalyzer(float startFreq, float endFreq, float st
 void LoRaModule::stopFrequencyAnalyzer() {
     if (currentMode != LoRaMode::FREQUENCY_ANALYZER) return;
 
-    if (analyzerTaskHandle) {
-        vTaskDelete(analyzerTaskHandle);
-        analyzerTaskHandle = nullptr;
-    }
+    TaskRegistry::kill(analyzerTaskHandle);
 
     currentMode = LoRaMode::IDLE;
     Serial.println("[LORA] Frequency analyzer stopped");
@@ -535,7 +544,7 @@ void LoRaModule::analyzerTask(void* param) {
     currentMode = LoRaMode::IDLE;
     Serial.printf("[LORA] Analyzer complete, %d results\n", frequencyResults.size());
 
-    vTaskDelete(nullptr);
+    TaskRegistry::exit();
 }
 
 // ============================================================================
@@ -548,24 +557,13 @@ void LoRaModule::startScan() {
     Serial.println("[LORA] Starting scan...");
     currentMode = LoRaMode::SCANNING;
 
-    xTaskCreatePinnedToCore(
-        scanTask,
-        "LoRa_Scan",
-        4096,
-        nullptr,
-        1,
-        &scanTaskHandle,
-        0
-    );
+    TaskRegistry::spawn(scanTask, "LoRa_Scan", 4096, nullptr, TaskRole::RADIO, &scanTaskHandle);
 }
 
 void LoRaModule::stopScan() {
     if (!isScanning()) return;
 
-    if (scanTaskHandle) {
-        vTaskDelete(scanTaskHandle);
-        scanTaskHandle = nullptr;
-    }
+    TaskRegistry::kill(scanTaskHandle);
 
     currentMode = LoRaMode::IDLE;
 }
@@ -605,89 +603,7 @@ void LoRaModule::scanTask(void* param) {
     radio->setFrequency(currentFrequency);
     radio->setSpreadingFactor(currentSF);
 
-    vTaskDelete(nullptr);
-}
-
-// ============================================================================
-// Packet Analysis
-// ============================================================================
-
-LoRaPacketType LoRaModule::identifyPacket(const uint8_t* data, size_t len) {
-    if (len < 4) return LoRaPacketType::UNKNOWN;
-
-    // Check for Meshtastic packet structure
-    // Meshtastic packets have a specific header format
-    if (len >= sizeof(Meshtastic::PacketHeader)) {
-        // Check if it looks like a Meshtastic packet
-        // The first bytes should be destination node ID
-        return LoRaPacketType::MESHTASTIC;
-    }
-
-    // TODO: Add MeshCore and LoRaWAN detection
-
-    return LoRaPacketType::RAW;
-}
-
-bool LoRaModule::decodeMeshtasticPacket(LoRaPacket& packet) {
-    if (packet.data.size() < sizeof(Meshtastic::PacketHeader)) {
-        return false;
-    }
-
-    const uint8_t* data = packet.data.data();
-    const Meshtastic::PacketHeader* header = (const Meshtastic::PacketHeader*)data;
-
-    packet.meshFrom = header->sender;
-    packet.meshTo = header->dest;
-    packet.meshHopLimit = header->flags & 0x07;
-    packet.meshWantAck = (header->flags >> 3) & 0x01;
-
-    // Update node list
-    updateMeshtasticNode(packet);
-
-    // The payload after header is encrypted with AES-128 or AES-256
-    // Decryption requires the channel key
-    if (hasMeshtasticKey) {
-        // TODO: Implement AES decryption
-        packet.decoded = false;
-    }
-
-    return true;
-}
-
-bool LoRaModule::decodeMeshCorePacket(LoRaPacket& packet) {
-    // TODO: Implement MeshCore packet decoding
-    return false;
-}
-
-void LoRaModule::updateMeshtasticNode(const LoRaPacket& packet) {
-    // Check if node already exists
-    for (auto& node : meshtasticNodes) {
-        if (node.nodeId == packet.meshFrom) {
-            node.lastRssi = packet.rssi;
-            node.lastSeen = millis();
-            return;
-        }
-    }
-
-    // Add new node
-    MeshtasticNode node;
-    node.nodeId = packet.meshFrom;
-    node.lastRssi = packet.rssi;
-    node.lastSeen = millis();
-    node.hopLimit = packet.meshHopLimit;
-    meshtasticNodes.push_back(node);
-
-    Serial.printf("[LORA] New Meshtastic node: %08X\n", packet.meshFrom);
-}
-
-String LoRaModule::packetToHex(const uint8_t* data, size_t len) {
-    String hex = "";
-    for (size_t i = 0; i < len; i++) {
-        char buf[4];
-        snprintf(buf, sizeof(buf), "%02X ", data[i]);
-        hex += buf;
-    }
-    return hex;
+    TaskRegistry::exit();
 }
 
 // ============================================================================
@@ -10,6 +10,8 @@
 #include <RadioLib.h>
 #include <vector>
 #include "config.h"
+#include "../../core/table_budget.h"
+#include "../../core/mac_table.h"
 
 // LoRa Operation Modes
 enum class LoRaMode {
@@ -58,11 +60,23 @@ struct FrequencyScanResult {
     bool hasSignal;
 };
 
-// Meshtastic Node Info
+// Meshtastic node number, as the node table's key
+struct MeshNodeId {
+    uint32_t value;
+
+    MeshNodeId() : value(0) {}
+    MeshNodeId(uint32_t value) : value(value) {}
+
+    uint32_t hash() const { return MacAddr(value).hash(); }
+    bool operator==(const MeshNodeId& other) const { return value == other.value; }
+};
+
+// Meshtastic Node Info. Names are inline, at Meshtastic's own limits, so
+// the node budget covers all of an entry's memory.
 struct MeshtasticNode {
     uint32_t nodeId;
-    String longName;
-    String shortName;
+    char longName[40];    // Empty until the node's user info is heard
+    char shortName[5];
     float lastLat;
     float lastLon;
     int32_t lastRssi;
@@ -106,7 +120,10 @@ public:
     static void startMeshtasticSniff();
     static void stopMeshtasticSniff();
     static bool isMeshtasticSniffing();
-    static std::vector<MeshtasticNode>& getMeshtasticNodes();
+    static MacTable<MeshtasticNode, MeshNodeId>& getMeshtasticNodes();
+    static TableStats getNodeTableStats();
+    // Refits the node table to a byte budget, dropping every node
+    static void setNodeBudget(size_t bytes);
     static void setMeshtasticKey(const uint8_t* key, size_t len);
 
     // Meshtastic Node Functions (legitimate communication)
@@ -170,7 +187,8 @@ private:
 
     static LoRaPacket lastPacket;
     static std::vector<LoRaPacket> packetHistory;
-    static std::vector<MeshtasticNode> meshtasticNodes;
+    static MacTable<MeshtasticNode, MeshNodeId> meshtasticNodes;
+    static TableStats nodeTable;
     static std::vector<FrequencyScanResult> frequencyResults;
 
     static float currentFrequency;
@@ -0,0 +1,184 @@
+/**
+ * ShitBird Firmware - Per-Channel Utilization / Airtime Estimator Implementation
+ */
+
+#include "airtime_monitor.h"
+
+// Non-HT rates by rx_ctrl.rate (wifi_phy_rate_t), in 100 kbit/s. 0-3 are
+// DSSS/CCK with the long preamble, 5-7 with the short one, 8+ OFDM.
+static const uint16_t LEGACY_RATES[16] = {
+    10, 20, 55, 110, 0, 20, 55, 110, 480, 240, 120, 60, 540, 360, 180, 90
+};
+
+// HT MCS 0-7 per spatial stream, 20 MHz, long GI, in 100 kbit/s
+static const uint16_t HT20_RATES[8] = {65, 130, 195, 260, 390, 520, 585, 650};
+
+#define SIG_MODE_NON_HT         0
+#define DSSS_LONG_PREAMBLE_US   192
+#define DSSS_SHORT_PREAMBLE_US  96
+#define OFDM_PREAMBLE_US        20      // L-STF, L-LTF, L-SIG
+#define HT_PREAMBLE_US          36      // Plus HT-SIG, HT-STF, one HT-LTF
+#define HT_EXTRA_LTF_US         4       // Per additional stream
+#define SIGNAL_EXTENSION_US     6       // 2.4 GHz OFDM
+#define OFDM_SERVICE_TAIL_BITS  22
+
+// Symbols to carry len bytes at rate (100 kbit/s), 4 us symbols
+static uint32_t ofdmSymbols(uint16_t len, uint32_t rate) {
+    uint32_t bitsPerSymbol = rate * 4 / 10;
+    if (bitsPerSymbol == 0) return 0;
+    return (OFDM_SERVICE_TAIL_BITS + 8u * len + bitsPerSymbol - 1) / bitsPerSymbol;
+}
+
+uint32_t AirtimeMonitor::frameAirtimeUs(const wifi_pkt_rx_ctrl_t& rx, uint16_t len) {
+    if (rx.sig_mode == SIG_MODE_NON_HT) {
+        uint32_t rate = LEGACY_RATES[rx.rate & 0x0F];
+        if (rate == 0) rate = 60;  // Reserved code; assume the 6M floor
+
+        if (rx.rate < 8) {
+            uint32_t preamble = rx.rate < 4 ? DSSS_LONG_PREAMBLE_US : DSSS_SHORT_PREAMBLE_US;
+            return preamble + (8u * len * 10 + rate - 1) / rate;
+        }
+        return OFDM_PREAMBLE_US + 4 * ofdmSymbols(len, rate) + SIGNAL_EXTENSION_US;
+    }
+
+    // HT (and VHT, which the ESP32 reports the same way)
+    uint32_t streams = (rx.mcs >> 3) + 1;
+    uint32_t rate = HT20_RATES[rx.mcs & 0x07] * streams;
+    if (rx.cwb) rate = rate * 108 / 52;  // 40 MHz: 108 data subcarriers vs 52
+
+    uint32_t symbols = ofdmSymbols(len, rate);
+    uint32_t payloadUs = rx.sgi ? (symbols * 36 + 9) / 10 : symbols * 4;
+    return HT_PREAMBLE_US + HT_EXTRA_LTF_US * (streams - 1) + payloadUs + SIGNAL_EXTENSION_US;
+}
+
+AirtimeMonitor::AirtimeMonitor() {
+    reset();
+}
+
+void AirtimeMonitor::reset() {
+    portENTER_CRITICAL(&mux);
+    for (auto& b : ring) {
+        b = Bucket();
+        b.second = UINT32_MAX;
+    }
+    tuned = 0;
+    tunedSince = 0;
+    portEXIT_CRITICAL(&mux);
+}
+
+// The ring slot for second, wiped if it still holds an older one
+AirtimeMonitor::Bucket& AirtimeMonitor::bucketFor(uint32_t second) {
+    Bucket& b = ring[second % AIRTIME_WINDOW_SECS];
+    if (b.second != second) {
+        b = Bucket();
+        b.second = second;
+    }
+    return b;
+}
+
+// Splits the time since tunedSince across the seconds it spans
+void AirtimeMonitor::chargeListening(uint32_t now) {
+    if (tuned == 0) {
+        tunedSince = now;
+        return;
+    }
+
+    // The parser reads millis() before taking the lock, so a frame can come
+    // in stamped before the hop task's last tune(); nothing to charge
+    if ((int32_t)(now - tunedSince) <= 0) return;
+
+    // Nothing before the window's oldest second is kept anyway
+    if (now - tunedSince > (AIRTIME_WINDOW_SECS - 1) * 1000UL) {
+        tunedSince = (now / 1000 + 1 - AIRTIME_WINDOW_SECS) * 1000;
+    }
+
+    while (tunedSince != now) {
+        uint32_t second = tunedSince / 1000;
+        uint32_t end = (second + 1) * 1000;
+        if ((int32_t)(end - now) > 0) end = now;
+
+        Sample& s = bucketFor(second).channels[tuned];
+        s.listenMs += end - tunedSince;
+        tunedSince = end;
+    }
+}
+
+void AirtimeMonitor::recordFrame(const wifi_pkt_rx_ctrl_t& rx, uint16_t len, uint32_t now) {
+    uint8_t channel = rx.channel;
+    if (channel == 0 || channel > MAX_CHANNEL) return;
+    uint32_t airtime = frameAirtimeUs(rx, len);
+
+    portENTER_CRITICAL(&mux);
+    chargeListening(now);
+    Sample& s = bucketFor(now / 1000).channels[channel];
+    s.frames++;
+    s.bytes += len;
+    s.airtimeUs += airtime;
+    portEXIT_CRITICAL(&mux);
+}
+
+void AirtimeMonitor::tune(uint8_t channel, uint32_t now) {
+    if (channel > MAX_CHANNEL) channel = 0;
+
+    portENTER_CRITICAL(&mux);
+    chargeListening(now);
+    tuned = channel;
+    tunedSince = now;
+    portEXIT_CRITICAL(&mux);
+}
+
+void AirtimeMonitor::getUtilization(ChannelUtilization out[MAX_CHANNEL + 1], uint32_t now) {
+    Sample totals[MAX_CHANNEL + 1] = {};
+    uint32_t current = now / 1000;
+
+    portENTER_CRITICAL(&mux);
+    chargeListening(now);
+    for (const Bucket& b : ring) {
+        if (b.second == UINT32_MAX || current - b.second >= AIRTIME_WINDOW_SECS) continue;
+        for (uint8_t ch = 1; ch <= MAX_CHANNEL; ch++) {
+            totals[ch].frames += b.channels[ch].frames;
+            totals[ch].bytes += b.channels[ch].bytes;
+            totals[ch].airtimeUs += b.channels[ch].airtimeUs;
+            totals[ch].listenMs += b.channels[ch].listenMs;
+        }
+    }
+    portEXIT_CRITICAL(&mux);
+
+    for (uint8_t ch = 0; ch <= MAX_CHANNEL; ch++) {
+        ChannelUtilization& u = out[ch];
+        u = ChannelUtilization();
+        if (ch == 0 || totals[ch].listenMs == 0) continue;
+
+        float seconds = totals[ch].listenMs / 1000.0f;
+        u.listenMs = totals[ch].listenMs;
+        u.framesPerSec = totals[ch].frames / seconds;
+        u.bytesPerSec = totals[ch].bytes / seconds;
+        u.airtimePct = totals[ch].airtimeUs / (seconds * 10000.0f);
+        if (u.airtimePct > 100.0f) u.airtimePct = 100.0f;
+    }
+}
+
+uint8_t AirtimeMonitor::recommend(uint16_t mask, uint32_t now) {
+    ChannelUtilization usage[MAX_CHANNEL + 1];
+    getUtilization(usage, now);
+
+    // 2.4 GHz channels are 5 MHz apart and 20 MHz wide, so a neighbour up
+    // to four channels away still shares some of the band
+    uint8_t best = 0;
+    float bestLoad = 0;
+    for (uint8_t ch = 1; ch <= MAX_CHANNEL; ch++) {
+        if (!(mask & (1 << ch)) || usage[ch].listenMs == 0) continue;
+
+        float load = 0;
+        for (int n = ch - 4; n <= ch + 4; n++) {
+            if (n < 1 || n > MAX_CHANNEL) continue;
+            int distance = n > ch ? n - ch : ch - n;
+            load += usage[n].airtimePct * (5 - distance) / 5.0f;
+        }
+        if (best == 0 || load < bestLoad) {
+            best = ch;
+            bestLoad = load;
+        }
+    }
+    return best;
+}
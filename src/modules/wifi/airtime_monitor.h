@@ -0,0 +1,81 @@
+/**
+ * ShitBird Firmware - Per-Channel Utilization / Airtime Estimator
+ *
+ * Every frame the parser sees is charged to its channel: one frame, its
+ * on-air bytes and an airtime estimate from the PHY rate in rx_ctrl
+ * (preamble plus symbols, as 802.11b/g/n time them). Listening time is
+ * charged to whichever channel the radio is tuned to, so rates and airtime
+ * share stay comparable between channels the hopper visits unevenly.
+ *
+ * Both go into a ring of one-second buckets covering the last
+ * AIRTIME_WINDOW_SECS; a bucket is wiped when its second comes round
+ * again. Only decoded frames count (control frames are filtered out and
+ * corrupted ones never arrive), so airtime is a lower bound.
+ *
+ * recordFrame() is for the parser task and tune() for whoever sets the
+ * channel; the getters for the main loop and the web server.
+ */
+
+#ifndef SHITBIRD_AIRTIME_MONITOR_H
+#define SHITBIRD_AIRTIME_MONITOR_H
+
+#include <Arduino.h>
+#include <esp_wifi.h>
+#include <freertos/FreeRTOS.h>
+#include "config.h"
+
+struct ChannelUtilization {
+    uint32_t listenMs;       // Tuned to the channel, within the window
+    float framesPerSec;      // While tuned to it
+    float bytesPerSec;
+    float airtimePct;        // Share of the listening time spent on frames
+};
+
+class AirtimeMonitor {
+public:
+    static const uint8_t MAX_CHANNEL = 14;
+
+    AirtimeMonitor();
+
+    // Parser task: one frame; len is its length off the air, FCS included
+    void recordFrame(const wifi_pkt_rx_ctrl_t& rx, uint16_t len, uint32_t now);
+
+    // The radio is now on channel; 0 when it stops listening
+    void tune(uint8_t channel, uint32_t now);
+
+    // Usage over the window for channels 1-14, indexed by channel
+    void getUtilization(ChannelUtilization out[MAX_CHANNEL + 1], uint32_t now);
+
+    // Least congested of the channels in mask (bit n = channel n), counting
+    // the airtime of the overlapping channels around each; 0 until one of
+    // them has been listened to
+    uint8_t recommend(uint16_t mask, uint32_t now);
+
+    void reset();
+
+    // On-air time of one PPDU, in microseconds
+    static uint32_t frameAirtimeUs(const wifi_pkt_rx_ctrl_t& rx, uint16_t len);
+
+private:
+    struct Sample {
+        uint32_t frames;
+        uint32_t bytes;
+        uint32_t airtimeUs;
+        uint32_t listenMs;
+    };
+
+    struct Bucket {
+        uint32_t second;
+        Sample channels[MAX_CHANNEL + 1];
+    };
+
+    Bucket ring[AIRTIME_WINDOW_SECS];
+    uint8_t tuned;           // 0 while not listening
+    uint32_t tunedSince;     // Listening time is charged up to here
+    mutable portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+
+    Bucket& bucketFor(uint32_t second);
+    void chargeListening(uint32_t now);
+};
+
+#endif // SHITBIRD_AIRTIME_MONITOR_H
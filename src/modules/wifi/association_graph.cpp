@@ -0,0 +1,168 @@
+/**
+ * ShitBird Firmware - Station/AP Association Graph Implementation
+ */
+
+#include "association_graph.h"
+
+AssociationGraph::AssociationGraph(uint16_t capacity)
+    : apNodes(capacity), clientNodes(capacity), count(0) {
+    if (capacity >= NONE) capacity = NONE - 1;
+
+    edges.resize(capacity);
+    freeSlots.reserve(capacity);
+    for (uint16_t i = capacity; i > 0; i--) {
+        edges[i - 1].used = false;
+        edges[i - 1].generation = 0;
+        freeSlots.push_back(i - 1);
+    }
+
+    size_t buckets = 16;
+    while (buckets < (size_t)capacity * 2) buckets <<= 1;
+    index.assign(buckets, NONE);
+}
+
+AssocEdge* AssociationGraph::record(const MacAddr& client, const MacAddr& bssid, uint32_t now, bool* created) {
+    uint16_t slot = lookup(client, bssid);
+    if (created) *created = (slot == NONE);
+
+    if (slot == NONE) {
+        if (freeSlots.empty()) return nullptr;
+
+        // Node tables are sized for the edge capacity, so these can't fail
+        // while a slot is free
+        Node* ap = apNodes.insert(bssid);
+        Node* sta = clientNodes.insert(client);
+        if (!ap || !sta) return nullptr;
+
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+
+        Slot& s = edges[slot];
+        s.used = true;
+        s.edge.client = client;
+        s.edge.bssid = bssid;
+        s.edge.frames = 0;
+        s.edge.firstSeen = now;
+
+        // New nodes come back zeroed; an empty list is NONE
+        if (ap->degree == 0) ap->head = NONE;
+        if (sta->degree == 0) sta->head = NONE;
+        s.nextByAP = ap->head;
+        ap->head = slot;
+        ap->degree++;
+        s.nextByClient = sta->head;
+        sta->head = slot;
+        sta->degree++;
+
+        size_t mask = index.size() - 1;
+        size_t pos = hashPair(client, bssid) & mask;
+        while (index[pos] != NONE) pos = (pos + 1) & mask;
+        index[pos] = slot;
+        count++;
+    }
+
+    AssocEdge& edge = edges[slot].edge;
+    edge.frames++;
+    edge.lastSeen = now;
+    return &edge;
+}
+
+AssocEdge* AssociationGraph::find(const MacAddr& client, const MacAddr& bssid) {
+    uint16_t slot = lookup(client, bssid);
+    return slot == NONE ? nullptr : &edges[slot].edge;
+}
+
+MacHandle AssociationGraph::findHandle(const MacAddr& client, const MacAddr& bssid) const {
+    uint16_t slot = lookup(client, bssid);
+    return slot == NONE ? MAC_HANDLE_INVALID : ((MacHandle)edges[slot].generation << 16) | slot;
+}
+
+AssocEdge* AssociationGraph::get(MacHandle handle) {
+    size_t slot = handle & 0xFFFF;
+    if (handle == MAC_HANDLE_INVALID || slot >= edges.size()) return nullptr;
+    Slot& s = edges[slot];
+    return (s.used && s.generation == (handle >> 16)) ? &s.edge : nullptr;
+}
+
+bool AssociationGraph::erase(const MacAddr& client, const MacAddr& bssid) {
+    size_t mask = index.size() - 1;
+    size_t pos = hashPair(client, bssid) & mask;
+    while (index[pos] != NONE) {
+        uint16_t slot = index[pos];
+        const AssocEdge& edge = edges[slot].edge;
+        if (edge.client == client && edge.bssid == bssid) {
+            unlink(apNodes, bssid, slot, true);
+            unlink(clientNodes, client, slot, false);
+            removeAt(pos);
+
+            Slot& s = edges[slot];
+            s.used = false;
+            s.generation++;
+            if (s.generation == 0xFFFF) s.generation = 0;  // Keep handles != INVALID
+            freeSlots.push_back(slot);
+            count--;
+            return true;
+        }
+        pos = (pos + 1) & mask;
+    }
+    return false;
+}
+
+void AssociationGraph::clear() {
+    for (size_t i = 0; i < edges.size(); i++) {
+        if (edges[i].used) erase(edges[i].edge.client, edges[i].edge.bssid);
+    }
+}
+
+uint16_t AssociationGraph::clientCount(const MacAddr& bssid) {
+    const Node* node = apNodes.find(bssid);
+    return node ? node->degree : 0;
+}
+
+uint16_t AssociationGraph::apCount(const MacAddr& client) {
+    const Node* node = clientNodes.find(client);
+    return node ? node->degree : 0;
+}
+
+uint16_t AssociationGraph::lookup(const MacAddr& client, const MacAddr& bssid) const {
+    size_t mask = index.size() - 1;
+    size_t pos = hashPair(client, bssid) & mask;
+    while (index[pos] != NONE) {
+        const AssocEdge& edge = edges[index[pos]].edge;
+        if (edge.client == client && edge.bssid == bssid) return index[pos];
+        pos = (pos + 1) & mask;
+    }
+    return NONE;
+}
+
+// Lists are short (an AP's clients, a client's APs), so a walk is fine
+void AssociationGraph::unlink(MacTable<Node>& nodes, const MacAddr& key, uint16_t slot, bool byAP) {
+    Node* node = nodes.find(key);
+    if (!node) return;
+
+    uint16_t* link = &node->head;
+    while (*link != NONE && *link != slot) {
+        link = byAP ? &edges[*link].nextByAP : &edges[*link].nextByClient;
+    }
+    if (*link == slot) {
+        *link = byAP ? edges[slot].nextByAP : edges[slot].nextByClient;
+    }
+
+    if (--node->degree == 0) nodes.erase(key);
+}
+
+// Backward-shift deletion, as in MacTable
+void AssociationGraph::removeAt(size_t pos) {
+    size_t mask = index.size() - 1;
+    size_t next = (pos + 1) & mask;
+    while (index[next] != NONE) {
+        const AssocEdge& edge = edges[index[next]].edge;
+        size_t home = hashPair(edge.client, edge.bssid) & mask;
+        if (((next - home) & mask) >= ((next - pos) & mask)) {
+            index[pos] = index[next];
+            pos = next;
+        }
+        next = (next + 1) & mask;
+    }
+    index[pos] = NONE;
+}
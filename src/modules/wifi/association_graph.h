@@ -0,0 +1,97 @@
+/**
+ * ShitBird Firmware - Station/AP Association Graph
+ *
+ * Client <-> BSSID edges learned passively from data frames, each with a
+ * frame count and first/last-seen time. Edges live in a fixed array found
+ * through an open-addressing index on the address pair, and every edge is
+ * also threaded onto a per-BSSID and a per-client list, so an AP's clients
+ * (or a client's APs) are walked without a scan and an AP's client count is
+ * a single lookup. Nothing allocates after construction.
+ *
+ * Handles (slot + generation) behave as in MacTable: valid until the edge is
+ * erased, then they resolve to nullptr.
+ */
+
+#ifndef SHITBIRD_ASSOCIATION_GRAPH_H
+#define SHITBIRD_ASSOCIATION_GRAPH_H
+
+#include <Arduino.h>
+#include <vector>
+#include "../../core/mac_addr.h"
+#include "../../core/mac_table.h"
+
+struct AssocEdge {
+    MacAddr client;
+    MacAddr bssid;
+    uint32_t frames;
+    uint32_t firstSeen;
+    uint32_t lastSeen;
+};
+
+class AssociationGraph {
+    static constexpr uint16_t NONE = 0xFFFF;
+
+public:
+    explicit AssociationGraph(uint16_t capacity);
+
+    // Counts one frame on the client-bssid edge, adding the edge if needed.
+    // nullptr when the graph is full.
+    AssocEdge* record(const MacAddr& client, const MacAddr& bssid, uint32_t now, bool* created = nullptr);
+
+    AssocEdge* find(const MacAddr& client, const MacAddr& bssid);
+    MacHandle findHandle(const MacAddr& client, const MacAddr& bssid) const;
+    AssocEdge* get(MacHandle handle);
+
+    bool erase(const MacAddr& client, const MacAddr& bssid);
+    void clear();
+
+    // Distinct clients seen talking to bssid, and APs seen with client
+    uint16_t clientCount(const MacAddr& bssid);
+    uint16_t apCount(const MacAddr& client);
+
+    // fn(const AssocEdge&) for each edge of the AP or client
+    template <typename Fn>
+    void forEachClient(const MacAddr& bssid, Fn fn) {
+        const Node* node = apNodes.find(bssid);
+        for (uint16_t i = node ? node->head : NONE; i != NONE; i = edges[i].nextByAP) fn(edges[i].edge);
+    }
+    template <typename Fn>
+    void forEachAP(const MacAddr& client, Fn fn) {
+        const Node* node = clientNodes.find(client);
+        for (uint16_t i = node ? node->head : NONE; i != NONE; i = edges[i].nextByClient) fn(edges[i].edge);
+    }
+
+    size_t size() const { return count; }
+    size_t capacity() const { return edges.size(); }
+
+private:
+    struct Slot {
+        AssocEdge edge;
+        uint16_t generation;
+        uint16_t nextByAP;       // Next edge with the same BSSID
+        uint16_t nextByClient;   // Next edge with the same client
+        bool used;
+    };
+
+    // Head of an AP's or a client's edge list
+    struct Node {
+        uint16_t head;
+        uint16_t degree;
+    };
+
+    std::vector<Slot> edges;
+    std::vector<uint16_t> freeSlots;
+    std::vector<uint16_t> index;  // Power-of-two bucket array of slot numbers
+    MacTable<Node> apNodes;
+    MacTable<Node> clientNodes;
+    size_t count;
+
+    static uint32_t hashPair(const MacAddr& client, const MacAddr& bssid) {
+        return client.hash() ^ (bssid.hash() * 0x9E3779B1u);
+    }
+    uint16_t lookup(const MacAddr& client, const MacAddr& bssid) const;
+    void unlink(MacTable<Node>& nodes, const MacAddr& key, uint16_t slot, bool byAP);
+    void removeAt(size_t pos);
+};
+
+#endif // SHITBIRD_ASSOCIATION_GRAPH_H
@@ -0,0 +1,142 @@
+/**
+ * ShitBird Firmware - Adaptive Channel Hop Scheduler Implementation
+ */
+
+#include "channel_scheduler.h"
+
+// Weight of the newest dwell in the smoothed rates
+#define HOP_EWMA_ALPHA          0.25f
+// Score = 1 + frames/s / FRAME_SCALE + new BSSIDs/s * DISCOVERY_WEIGHT
+#define HOP_FRAME_SCALE         20.0f
+#define HOP_DISCOVERY_WEIGHT    10.0f
+
+ChannelScheduler::ChannelScheduler()
+    : pinned(CHANNELS_ALL), excluded(0), current(0), dwellStart(0) {
+    memset(activity, 0, sizeof(activity));
+    memset((void*)frames, 0, sizeof(frames));
+    memset((void*)discoveries, 0, sizeof(discoveries));
+    memset(framesSeen, 0, sizeof(framesSeen));
+    memset(discoveriesSeen, 0, sizeof(discoveriesSeen));
+}
+
+void ChannelScheduler::pin(uint16_t mask) {
+    pinned = mask & 0x7FFE;  // 1-14
+}
+
+void ChannelScheduler::exclude(uint16_t mask) {
+    excluded |= mask;
+}
+
+void ChannelScheduler::reset() {
+    pinned = CHANNELS_ALL;
+    excluded = 0;
+}
+
+uint8_t ChannelScheduler::next(uint32_t now, uint16_t* dwellMs) {
+    if (current) closeDwell(now);
+
+    uint16_t enabled = getEnabled();
+    if (!enabled) {
+        // Everything excluded: stay put rather than hop nowhere
+        uint8_t ch = current ? current : 1;
+        *dwellMs = WIFI_HOP_MAX_DWELL;
+        return ch;
+    }
+
+    // Don't pick the channel we're leaving unless it's the only one
+    uint16_t candidates = enabled;
+    if ((candidates & ~CHANNEL_MASK(current)) != 0) {
+        candidates &= ~CHANNEL_MASK(current);
+    }
+
+    uint8_t best = 0;
+    uint32_t mostOverdue = 0;
+    bool overdue = false;
+    float bestPriority = -1.0f;
+
+    for (uint8_t ch = 1; ch <= MAX_CHANNEL; ch++) {
+        if (!(candidates & CHANNEL_MASK(ch))) continue;
+
+        // Never visited counts as the most overdue of all
+        uint32_t idle = activity[ch].visits ? now - activity[ch].lastVisit : UINT32_MAX;
+
+        if (idle >= WIFI_HOP_MAX_REVISIT) {
+            if (!overdue || idle > mostOverdue) {
+                best = ch;
+                mostOverdue = idle;
+                overdue = true;
+            }
+            continue;
+        }
+        if (overdue) continue;
+
+        // Busy channels win sooner, quiet ones win by waiting
+        float priority = score(ch) * (float)idle;
+        if (priority > bestPriority) {
+            best = ch;
+            bestPriority = priority;
+        }
+    }
+
+    current = best;
+    dwellStart = now;
+    // Frames still in the pipeline from an earlier visit don't count here
+    framesSeen[best] = frames[best];
+    discoveriesSeen[best] = discoveries[best];
+
+    activity[best].dwellMs = dwellFor(best);
+    *dwellMs = activity[best].dwellMs;
+    return best;
+}
+
+uint8_t ChannelScheduler::getBusiest() const {
+    uint8_t busiest = 0;
+    float best = -1.0f;
+    for (uint8_t ch = 1; ch <= MAX_CHANNEL; ch++) {
+        if (activity[ch].visits && activity[ch].framesPerSec > best) {
+            busiest = ch;
+            best = activity[ch].framesPerSec;
+        }
+    }
+    return busiest;
+}
+
+void ChannelScheduler::closeDwell(uint32_t now) {
+    ChannelActivity& a = activity[current];
+    uint32_t elapsed = now - dwellStart;
+    if (elapsed == 0) elapsed = 1;
+
+    uint32_t frameCount = frames[current] - framesSeen[current];
+    uint32_t discoveryCount = discoveries[current] - discoveriesSeen[current];
+    float fps = frameCount * 1000.0f / elapsed;
+    float dps = discoveryCount * 1000.0f / elapsed;
+
+    if (a.visits == 0) {
+        a.framesPerSec = fps;
+        a.discoveriesPerSec = dps;
+    } else {
+        a.framesPerSec += HOP_EWMA_ALPHA * (fps - a.framesPerSec);
+        a.discoveriesPerSec += HOP_EWMA_ALPHA * (dps - a.discoveriesPerSec);
+    }
+    a.lastVisit = now;
+    a.visits++;
+}
+
+float ChannelScheduler::score(uint8_t channel) const {
+    const ChannelActivity& a = activity[channel];
+    return 1.0f + a.framesPerSec / HOP_FRAME_SCALE + a.discoveriesPerSec * HOP_DISCOVERY_WEIGHT;
+}
+
+// Minimum dwell plus a share of the spare up to the maximum, in proportion
+// to how this channel scores against the busiest enabled one
+uint16_t ChannelScheduler::dwellFor(uint8_t channel) const {
+    float top = 1.0f;
+    uint16_t enabled = getEnabled();
+    for (uint8_t ch = 1; ch <= MAX_CHANNEL; ch++) {
+        if ((enabled & CHANNEL_MASK(ch)) && score(ch) > top) top = score(ch);
+    }
+    if (top <= 1.0f) return WIFI_HOP_MIN_DWELL;
+
+    float share = (score(channel) - 1.0f) / (top - 1.0f);
+    return WIFI_HOP_MIN_DWELL + (uint16_t)(share * (WIFI_HOP_MAX_DWELL - WIFI_HOP_MIN_DWELL));
+}
@@ -0,0 +1,78 @@
+/**
+ * ShitBird Firmware - Adaptive Channel Hop Scheduler
+ *
+ * Tracks frames/s and new-BSSID discoveries per 2.4 GHz channel, measured
+ * while dwelling there, and turns them into a hop plan: busy channels come
+ * round more often and get longer dwells, while every enabled channel is
+ * still revisited roughly every WIFI_HOP_MAX_REVISIT ms at worst.
+ *
+ * recordFrame()/recordDiscovery() are for the parser task, next() for the
+ * hop task. Each counter has a single writer, so no locking is needed.
+ */
+
+#ifndef SHITBIRD_CHANNEL_SCHEDULER_H
+#define SHITBIRD_CHANNEL_SCHEDULER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// Channel sets: bit n = channel n
+#define CHANNEL_MASK(ch)        ((uint16_t)(1 << (ch)))
+#define CHANNELS_ALL            0x3FFE  // 1-13
+#define CHANNELS_NON_OVERLAP    (CHANNEL_MASK(1) | CHANNEL_MASK(6) | CHANNEL_MASK(11))
+
+struct ChannelActivity {
+    float framesPerSec;      // Smoothed, while dwelling on the channel
+    float discoveriesPerSec; // New BSSIDs, smoothed
+    uint16_t dwellMs;        // Dwell the scheduler last gave it
+    uint32_t lastVisit;      // millis() when last left
+    uint32_t visits;
+};
+
+class ChannelScheduler {
+public:
+    static const uint8_t MAX_CHANNEL = 14;
+
+    ChannelScheduler();
+
+    // Parser task: frame or new BSSID heard on channel
+    void recordFrame(uint8_t channel) {
+        if (channel <= MAX_CHANNEL) frames[channel]++;
+    }
+    void recordDiscovery(uint8_t channel) {
+        if (channel <= MAX_CHANNEL) discoveries[channel]++;
+    }
+
+    // Hop task: closes the dwell on the current channel and picks the next.
+    // Returns the channel and sets dwellMs to how long to stay there.
+    uint8_t next(uint32_t now, uint16_t* dwellMs);
+
+    // Hop over exactly these channels
+    void pin(uint16_t mask);
+    // Leave these out of whatever is pinned
+    void exclude(uint16_t mask);
+    // Back to channels 1-13 with no exclusions; keeps the learned activity
+    void reset();
+
+    uint16_t getEnabled() const { return pinned & ~excluded; }
+    const ChannelActivity& getActivity(uint8_t channel) const { return activity[channel]; }
+    uint8_t getBusiest() const;
+
+private:
+    ChannelActivity activity[MAX_CHANNEL + 1];
+    volatile uint32_t frames[MAX_CHANNEL + 1];
+    volatile uint32_t discoveries[MAX_CHANNEL + 1];
+    uint32_t framesSeen[MAX_CHANNEL + 1];      // Counter values at the last close
+    uint32_t discoveriesSeen[MAX_CHANNEL + 1];
+
+    uint16_t pinned;
+    uint16_t excluded;
+    uint8_t current;         // 0 before the first hop
+    uint32_t dwellStart;
+
+    void closeDwell(uint32_t now);
+    float score(uint8_t channel) const;
+    uint16_t dwellFor(uint8_t channel) const;
+};
+
+#endif // SHITBIRD_CHANNEL_SCHEDULER_H
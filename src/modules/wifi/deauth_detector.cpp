@@ -0,0 +1,232 @@
+/**
+ * ShitBird Firmware - Deauth/Disassoc Flood Detector Implementation
+ */
+
+#include "deauth_detector.h"
+#include "wifi_module.h"
+#include "../../core/storage.h"
+
+#define LOG_OPEN    0x01
+#define LOG_CLOSE   0x02
+
+static const char* eventName(WidsEventType type) {
+    switch (type) {
+        case WidsEventType::BSSID_FLOOD: return "BSSID flood";
+        case WidsEventType::SOURCE_FLOOD: return "Source flood";
+        case WidsEventType::CHANNEL_FLOOD: return "Channel flood";
+        default: return "Flood";
+    }
+}
+
+// ============================================================================
+// Sliding window
+// ============================================================================
+
+// Zeroes the buckets between the newest one and sec; at most one window's worth
+void DeauthDetector::RateWindow::advance(uint32_t sec) {
+    if (sec == second) return;
+    uint32_t gap = sec - second;
+    if (gap >= WIDS_WINDOW_SECS) {
+        memset(buckets, 0, sizeof(buckets));
+        total = 0;
+    } else {
+        for (uint32_t s = second + 1; s != sec + 1; s++) {
+            uint16_t& b = buckets[s % WIDS_WINDOW_SECS];
+            total -= b;
+            b = 0;
+        }
+    }
+    second = sec;
+}
+
+void DeauthDetector::RateWindow::add(uint32_t sec) {
+    advance(sec);
+    uint16_t& b = buckets[sec % WIDS_WINDOW_SECS];
+    if (b < 0xFFFF) {
+        b++;
+        total++;
+    }
+}
+
+// ============================================================================
+// Detector
+// ============================================================================
+
+DeauthDetector::DeauthDetector() {
+    thresholds.perBssid = WIDS_BSSID_THRESHOLD;
+    thresholds.perSource = WIDS_SOURCE_THRESHOLD;
+    thresholds.perChannel = WIDS_CHANNEL_THRESHOLD;
+    reset();
+}
+
+void DeauthDetector::reset() {
+    portENTER_CRITICAL(&mux);
+    for (Counter* table : {bssids, sources}) {
+        for (size_t i = 0; i < WIDS_TRACK_SLOTS; i++) {
+            table[i] = Counter();
+            table[i].event = -1;
+        }
+    }
+    for (auto& c : channels) {
+        c = Counter();
+        c.event = -1;
+    }
+    for (auto& e : events) e = WidsEvent();
+    memset(pendingLog, 0, sizeof(pendingLog));
+    totalFrames = 0;
+    portEXIT_CRITICAL(&mux);
+}
+
+// The key's slot, taken over if its current owner has gone quiet; nullptr if
+// another address is still busy there
+DeauthDetector::Counter* DeauthDetector::slotFor(Counter* table, const MacAddr& key, uint32_t sec) {
+    Counter& c = table[key.hash() & (WIDS_TRACK_SLOTS - 1)];
+    if (c.key == key) return &c;
+
+    c.window.advance(sec);
+    if (c.window.total != 0 || c.event >= 0) return nullptr;
+
+    c.window = RateWindow();
+    c.window.second = sec;
+    c.key = key;
+    return &c;
+}
+
+void DeauthDetector::record(const MacAddr& bssid, const MacAddr& source, uint8_t subtype, uint16_t reason,
+                            uint8_t channel, int8_t rssi, uint32_t now) {
+    uint32_t sec = now / 1000;
+
+    portENTER_CRITICAL(&mux);
+    totalFrames++;
+
+    if (Counter* c = slotFor(bssids, bssid, sec)) {
+        count(*c, WidsEventType::BSSID_FLOOD, thresholds.perBssid, bssid, subtype, reason, channel, rssi, now);
+    }
+    if (source != bssid) {
+        if (Counter* c = slotFor(sources, source, sec)) {
+            count(*c, WidsEventType::SOURCE_FLOOD, thresholds.perSource, source, subtype, reason, channel, rssi, now);
+        }
+    }
+    if (channel <= MAX_CHANNEL) {
+        count(channels[channel], WidsEventType::CHANNEL_FLOOD, thresholds.perChannel, MacAddr(),
+              subtype, reason, channel, rssi, now);
+    }
+
+    portEXIT_CRITICAL(&mux);
+}
+
+void DeauthDetector::count(Counter& c, WidsEventType type, uint16_t threshold, const MacAddr& addr,
+                           uint8_t subtype, uint16_t reason, uint8_t channel, int8_t rssi, uint32_t now) {
+    c.window.add(now / 1000);
+
+    if (c.event < 0) {
+        if (threshold == 0 || c.window.total < threshold) return;
+        c.event = openEvent(type, addr, channel, now);
+        if (c.event < 0) return;
+        // The frames that crossed the threshold belong to the event
+        events[c.event].frames = c.window.total - 1;
+    }
+
+    WidsEvent& e = events[c.event];
+    e.frames++;
+    e.lastFrame = now;
+    e.subtype = subtype;
+    e.reason = reason;
+    e.channel = channel;
+    e.rssi = rssi;
+    if (c.window.total > e.peakRate) e.peakRate = c.window.total;
+}
+
+// Reuses the longest-closed slot; none while every event is still open
+int8_t DeauthDetector::openEvent(WidsEventType type, const MacAddr& addr, uint8_t channel, uint32_t now) {
+    int8_t index = -1;
+    for (uint8_t i = 0; i < WIDS_MAX_EVENTS; i++) {
+        if (!events[i].active && !(pendingLog[i] & LOG_CLOSE)) {
+            if (index < 0 || (int32_t)(events[i].lastFrame - events[index].lastFrame) < 0) index = i;
+        }
+    }
+    if (index < 0) return -1;
+
+    WidsEvent& e = events[index];
+    e = WidsEvent();
+    e.type = type;
+    e.addr = addr;
+    e.channel = channel;
+    e.started = now;
+    e.active = true;
+    pendingLog[index] = LOG_OPEN;
+    return index;
+}
+
+void DeauthDetector::poll(uint32_t now) {
+    WidsEvent toLog[WIDS_MAX_EVENTS];
+    uint8_t what[WIDS_MAX_EVENTS];
+    size_t n = 0;
+
+    portENTER_CRITICAL(&mux);
+    for (uint8_t i = 0; i < WIDS_MAX_EVENTS; i++) {
+        WidsEvent& e = events[i];
+        if (e.active && now - e.lastFrame >= WIDS_WINDOW_SECS * 1000UL) {
+            e.active = false;
+            pendingLog[i] |= LOG_CLOSE;
+            for (auto* table : {bssids, sources}) {
+                for (size_t s = 0; s < WIDS_TRACK_SLOTS; s++) {
+                    if (table[s].event == (int8_t)i) table[s].event = -1;
+                }
+            }
+            for (auto& c : channels) {
+                if (c.event == (int8_t)i) c.event = -1;
+            }
+        }
+        if (pendingLog[i]) {
+            toLog[n] = e;
+            what[n++] = pendingLog[i];
+            pendingLog[i] = 0;
+        }
+    }
+    portEXIT_CRITICAL(&mux);
+
+    // SD writes stay out of the parser task and outside the lock
+    for (size_t i = 0; i < n; i++) {
+        const WidsEvent& e = toLog[i];
+        char addr[18] = "-";
+        if (e.type != WidsEventType::CHANNEL_FLOOD) e.addr.format(addr);
+        const char* frame = (e.subtype == WIFI_MGMT_DISASSOC) ? "disassoc" : "deauth";
+
+        if (what[i] & LOG_OPEN) {
+            Serial.printf("[WIDS] %s %s ch%u\n", eventName(e.type), addr, e.channel);
+            Storage::logf("wids", "%s started: %s ch %u rssi %d %s reason %u",
+                          eventName(e.type), addr, e.channel, e.rssi, frame, e.reason);
+        }
+        if (what[i] & LOG_CLOSE) {
+            Storage::logf("wids", "%s ended: %s ch %u, %lu frames in %lus, peak %u/%us, last %s reason %u",
+                          eventName(e.type), addr, e.channel, (unsigned long)e.frames,
+                          (unsigned long)((e.lastFrame - e.started) / 1000), e.peakRate, WIDS_WINDOW_SECS,
+                          frame, e.reason);
+        }
+    }
+}
+
+size_t DeauthDetector::getEvents(WidsEvent* out, size_t max) const {
+    size_t n = 0;
+    portENTER_CRITICAL(&mux);
+    for (int pass = 0; pass < 2; pass++) {
+        for (uint8_t i = 0; i < WIDS_MAX_EVENTS && n < max; i++) {
+            const WidsEvent& e = events[i];
+            if (e.started == 0 && !e.active) continue;
+            if (e.active == (pass == 0)) out[n++] = e;
+        }
+    }
+    portEXIT_CRITICAL(&mux);
+    return n;
+}
+
+size_t DeauthDetector::getActiveCount() const {
+    size_t n = 0;
+    portENTER_CRITICAL(&mux);
+    for (const auto& e : events) {
+        if (e.active) n++;
+    }
+    portEXIT_CRITICAL(&mux);
+    return n;
+}
@@ -0,0 +1,107 @@
+/**
+ * ShitBird Firmware - Deauth/Disassoc Flood Detector (WIDS)
+ *
+ * Counts deauthentication and disassociation frames per target BSSID, per
+ * transmitter and per channel over a sliding window of one-second buckets.
+ * A counter crossing its threshold opens an event; the event closes once no
+ * matching frame has been seen for a full window.
+ *
+ * Counters live in small direct-mapped tables, so record() is O(1) however
+ * fast a flood arrives. An address that collides with a busy slot still
+ * counts towards its channel, which is what catches floods from randomized
+ * sources.
+ *
+ * record() is for the parser task; poll() and the getters for the main loop.
+ */
+
+#ifndef SHITBIRD_DEAUTH_DETECTOR_H
+#define SHITBIRD_DEAUTH_DETECTOR_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include "config.h"
+#include "../../core/mac_addr.h"
+
+enum class WidsEventType : uint8_t {
+    BSSID_FLOOD,    // Many frames naming one BSSID
+    SOURCE_FLOOD,   // Many frames from one transmitter
+    CHANNEL_FLOOD   // Many frames on one channel, any address
+};
+
+struct WidsEvent {
+    WidsEventType type;
+    MacAddr addr;          // BSSID or transmitter; zero for CHANNEL_FLOOD
+    uint8_t channel;
+    int8_t rssi;           // Of the latest frame
+    uint8_t subtype;       // WIFI_MGMT_DEAUTH or WIFI_MGMT_DISASSOC, latest frame
+    uint16_t reason;       // Reason code, latest frame
+    uint32_t started;      // millis()
+    uint32_t lastFrame;
+    uint32_t frames;       // Counted since the event opened
+    uint16_t peakRate;     // Highest frames-per-window seen
+    bool active;
+};
+
+struct WidsThresholds {
+    uint16_t perBssid;     // Frames per window
+    uint16_t perSource;
+    uint16_t perChannel;
+};
+
+class DeauthDetector {
+public:
+    static const uint8_t MAX_CHANNEL = 14;
+
+    DeauthDetector();
+
+    // Parser task: one deauth/disassoc frame
+    void record(const MacAddr& bssid, const MacAddr& source, uint8_t subtype, uint16_t reason,
+                uint8_t channel, int8_t rssi, uint32_t now);
+
+    // Main loop: closes quiet events and logs openings/closings to SD
+    void poll(uint32_t now);
+
+    void setThresholds(const WidsThresholds& t) { thresholds = t; }
+    WidsThresholds getThresholds() const { return thresholds; }
+
+    // Copies up to max events, active ones first; returns how many
+    size_t getEvents(WidsEvent* out, size_t max) const;
+    size_t getActiveCount() const;
+    uint32_t getTotalFrames() const { return totalFrames; }
+
+    void reset();
+
+private:
+    // Frames per second over the last WIDS_WINDOW_SECS seconds
+    struct RateWindow {
+        uint16_t buckets[WIDS_WINDOW_SECS];
+        uint32_t second;   // Second the newest bucket belongs to
+        uint32_t total;
+
+        void add(uint32_t sec);
+        void advance(uint32_t sec);
+    };
+
+    struct Counter {
+        MacAddr key;
+        RateWindow window;
+        int8_t event;      // Index into events while one is open, else -1
+    };
+
+    Counter bssids[WIDS_TRACK_SLOTS];
+    Counter sources[WIDS_TRACK_SLOTS];
+    Counter channels[MAX_CHANNEL + 1];
+    WidsEvent events[WIDS_MAX_EVENTS];
+    uint8_t pendingLog[WIDS_MAX_EVENTS];  // LOG_OPEN / LOG_CLOSE bits
+
+    WidsThresholds thresholds;
+    volatile uint32_t totalFrames;
+    mutable portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+
+    Counter* slotFor(Counter* table, const MacAddr& key, uint32_t sec);
+    void count(Counter& c, WidsEventType type, uint16_t threshold, const MacAddr& addr,
+               uint8_t subtype, uint16_t reason, uint8_t channel, int8_t rssi, uint32_t now);
+    int8_t openEvent(WidsEventType type, const MacAddr& addr, uint8_t channel, uint32_t now);
+};
+
+#endif // SHITBIRD_DEAUTH_DETECTOR_H
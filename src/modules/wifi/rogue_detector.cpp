@@ -0,0 +1,311 @@
+/**
+ * ShitBird Firmware - Rogue AP / Evil-Twin Detector Implementation
+ */
+
+#include "rogue_detector.h"
+#include "wifi_module.h"
+#include "../../core/storage.h"
+#include "../../core/oui_db.h"
+
+// Open < WEP < anything with a real key exchange
+static uint8_t securityRank(wifi_auth_mode_t auth) {
+    switch (auth) {
+        case WIFI_AUTH_OPEN: return 0;
+        case WIFI_AUTH_WEP: return 1;
+        default: return 2;
+    }
+}
+
+const char* RogueDetector::typeName(RogueAlertType type) {
+    switch (type) {
+        case RogueAlertType::VENDOR_MISMATCH: return "Vendor mismatch";
+        case RogueAlertType::SECURITY_MISMATCH: return "Weaker twin";
+        case RogueAlertType::ENCRYPTION_DOWNGRADE: return "Downgrade";
+        case RogueAlertType::INTERVAL_CHANGE: return "Interval change";
+        case RogueAlertType::CHANNEL_MOVE: return "Channel move";
+        default: return "Rogue AP";
+    }
+}
+
+void RogueDetector::describe(RogueAlertType type, uint32_t value, char* buf, size_t len) {
+    switch (type) {
+        case RogueAlertType::VENDOR_MISMATCH: {
+            const char* vendor = OuiDb::lookup(value);
+            if (vendor) snprintf(buf, len, "%s", vendor);
+            else snprintf(buf, len, "%06lX", (unsigned long)value);
+            break;
+        }
+        case RogueAlertType::SECURITY_MISMATCH:
+        case RogueAlertType::ENCRYPTION_DOWNGRADE:
+            snprintf(buf, len, "%s", WiFiModule::getEncryptionString((wifi_auth_mode_t)value).c_str());
+            break;
+        case RogueAlertType::INTERVAL_CHANGE:
+            snprintf(buf, len, "%luTU", (unsigned long)value);
+            break;
+        case RogueAlertType::CHANNEL_MOVE:
+            snprintf(buf, len, "ch%lu", (unsigned long)value);
+            break;
+    }
+}
+
+RogueDetector::RogueDetector() : profileCount(0) {
+    memset(index, NONE, sizeof(index));
+    reset();
+}
+
+void RogueDetector::clear() {
+    portENTER_CRITICAL(&mux);
+    for (auto& p : profiles) p = Profile();
+    memset(index, NONE, sizeof(index));
+    profileCount = 0;
+    portEXIT_CRITICAL(&mux);
+}
+
+void RogueDetector::reset() {
+    clear();
+    portENTER_CRITICAL(&mux);
+    for (auto& a : alerts) a = RogueAlert();
+    memset(pendingLog, 0, sizeof(pendingLog));
+    portEXIT_CRITICAL(&mux);
+}
+
+// ============================================================================
+// SSID index
+// ============================================================================
+
+size_t RogueDetector::lookup(SsidId id) const {
+    size_t pos = home(id);
+    while (index[pos] != NONE && profiles[index[pos]].ssid.getId() != id) {
+        pos = (pos + 1) & (INDEX_SIZE - 1);
+    }
+    return pos;
+}
+
+RogueDetector::Profile* RogueDetector::find(SsidId id) {
+    size_t pos = lookup(id);
+    return index[pos] == NONE ? nullptr : &profiles[index[pos]];
+}
+
+// nullptr once ROGUE_MAX_SSIDS are indexed; later SSIDs go unwatched
+RogueDetector::Profile* RogueDetector::insert(const Ssid& ssid) {
+    if (profileCount == ROGUE_MAX_SSIDS) return nullptr;
+
+    uint8_t slot = 0;
+    while (profiles[slot].used) slot++;
+
+    Profile& p = profiles[slot];
+    p = Profile();
+    p.ssid = ssid;
+    p.security = WIFI_AUTH_OPEN;
+    p.used = true;
+
+    index[lookup(ssid.getId())] = slot;
+    profileCount++;
+    return &p;
+}
+
+// Backward-shift deletion, as in MacTable
+void RogueDetector::removeAt(size_t pos) {
+    const size_t mask = INDEX_SIZE - 1;
+    size_t next = (pos + 1) & mask;
+    while (index[next] != NONE) {
+        size_t want = home(profiles[index[next]].ssid.getId());
+        if (((next - want) & mask) >= ((next - pos) & mask)) {
+            index[pos] = index[next];
+            pos = next;
+        }
+        next = (next + 1) & mask;
+    }
+    index[pos] = NONE;
+}
+
+// ============================================================================
+// Checks
+// ============================================================================
+
+void RogueDetector::addAP(const APInfo& ap, uint32_t now) {
+    if (ap.ssid.isEmpty()) return;
+
+    // Locally administered BSSIDs (a vendor's extra virtual APs, phone
+    // hotspots) carry no vendor to compare
+    bool hasVendor = !ap.bssid.isLocallyAdministered();
+    uint32_t oui = ap.bssid.oui();
+
+    portENTER_CRITICAL(&mux);
+    Profile* p = find(ap.ssid.getId());
+    if (!p) p = insert(ap.ssid);
+    if (!p) {
+        portEXIT_CRITICAL(&mux);
+        return;
+    }
+
+    bool knownVendor = false;
+    for (uint8_t i = 0; i < p->ouiCount; i++) {
+        if (p->ouis[i] == oui) knownVendor = true;
+    }
+
+    if (p->aps > 0) {
+        if (hasVendor && p->ouiCount > 0 && !knownVendor) {
+            raise(RogueAlertType::VENDOR_MISMATCH, ap, p->ouis[0], oui, now);
+        }
+        if (securityRank(ap.encryption) < securityRank(p->security)) {
+            raise(RogueAlertType::SECURITY_MISMATCH, ap, p->security, ap.encryption, now);
+        }
+    }
+
+    if (hasVendor && !knownVendor && p->ouiCount < ROGUE_MAX_OUIS) p->ouis[p->ouiCount++] = oui;
+    if (p->aps == 0 || securityRank(ap.encryption) > securityRank(p->security)) p->security = ap.encryption;
+    p->aps++;
+    portEXIT_CRITICAL(&mux);
+}
+
+void RogueDetector::checkBeacon(APInfo& ap, uint16_t interval, bool privacy, uint8_t dsChannel, uint32_t now) {
+    // APs found by an active scan have no interval until their first beacon
+    if (interval && !ap.beaconInterval) ap.beaconInterval = interval;
+
+    bool downgrade = !privacy && ap.encryption != WIFI_AUTH_OPEN;
+    bool intervalChanged = interval && interval != ap.beaconInterval;
+    bool moved = dsChannel && ap.channel && dsChannel != ap.channel;
+
+    // The every-beacon case: nothing to lock for
+    if (!downgrade && !intervalChanged && !moved) return;
+
+    portENTER_CRITICAL(&mux);
+    if (downgrade) raise(RogueAlertType::ENCRYPTION_DOWNGRADE, ap, ap.encryption, WIFI_AUTH_OPEN, now);
+    if (intervalChanged) raise(RogueAlertType::INTERVAL_CHANGE, ap, ap.beaconInterval, interval, now);
+    if (moved) raise(RogueAlertType::CHANNEL_MOVE, ap, ap.channel, dsChannel, now);
+    portEXIT_CRITICAL(&mux);
+
+    // Security keeps its first-seen value, so every open beacon from a
+    // cloned BSSID is counted rather than becoming the new normal
+    if (intervalChanged) ap.beaconInterval = interval;
+    if (moved) ap.channel = dsChannel;
+}
+
+void RogueDetector::removeAP(const APInfo& ap) {
+    if (ap.ssid.isEmpty()) return;
+
+    portENTER_CRITICAL(&mux);
+    size_t pos = lookup(ap.ssid.getId());
+    if (index[pos] != NONE) {
+        Profile& p = profiles[index[pos]];
+        if (p.aps > 0) p.aps--;
+        if (p.aps == 0) {
+            removeAt(pos);
+            p = Profile();
+            profileCount--;
+        }
+    }
+    portEXIT_CRITICAL(&mux);
+}
+
+// ============================================================================
+// Alerts
+// ============================================================================
+
+// Caller holds mux
+void RogueDetector::raise(RogueAlertType type, const APInfo& ap, uint32_t before, uint32_t after, uint32_t now) {
+    int8_t slot = -1;
+    for (uint8_t i = 0; i < ROGUE_MAX_ALERTS; i++) {
+        if (alerts[i].count && alerts[i].type == type && alerts[i].bssid == ap.bssid) {
+            slot = i;
+            break;
+        }
+    }
+
+    if (slot >= 0 && now - alerts[slot].last < ROGUE_REPEAT_MS) {
+        RogueAlert& a = alerts[slot];
+        if (a.count < 0xFFFF) a.count++;
+        a.last = now;
+        a.rssi = ap.rssi;
+        a.before = before;
+        a.after = after;
+        return;
+    }
+
+    // Otherwise a free slot, else the least recently raised already logged one
+    if (slot < 0) {
+        for (uint8_t i = 0; i < ROGUE_MAX_ALERTS; i++) {
+            if (pendingLog[i]) continue;
+            if (alerts[i].count == 0) {
+                slot = i;
+                break;
+            }
+            if (slot < 0 || (int32_t)(alerts[i].last - alerts[slot].last) < 0) slot = i;
+        }
+        if (slot < 0) return;
+    }
+
+    RogueAlert& a = alerts[slot];
+    a = RogueAlert();
+    a.type = type;
+    a.bssid = ap.bssid;
+    a.ssid = ap.ssid;
+    a.channel = ap.channel;
+    a.rssi = ap.rssi;
+    a.before = before;
+    a.after = after;
+    a.first = now;
+    a.last = now;
+    a.count = 1;
+    pendingLog[slot] = true;
+}
+
+void RogueDetector::poll() {
+    RogueAlert toLog[ROGUE_MAX_ALERTS];
+    size_t n = 0;
+
+    portENTER_CRITICAL(&mux);
+    for (uint8_t i = 0; i < ROGUE_MAX_ALERTS; i++) {
+        if (!pendingLog[i]) continue;
+        toLog[n++] = alerts[i];
+        pendingLog[i] = false;
+    }
+    portEXIT_CRITICAL(&mux);
+
+    // SD writes stay out of the parser task and outside the lock
+    for (size_t i = 0; i < n; i++) {
+        const RogueAlert& a = toLog[i];
+        char bssid[18];
+        char before[24];
+        char after[24];
+        a.bssid.format(bssid);
+        describe(a.type, a.before, before, sizeof(before));
+        describe(a.type, a.after, after, sizeof(after));
+
+        Serial.printf("[ROGUE] %s: %s \"%s\" %s -> %s\n", typeName(a.type), bssid, a.ssid.c_str(), before, after);
+        Storage::logf("rogue", "%s: %s \"%s\" ch %u rssi %d, expected %s, saw %s",
+                      typeName(a.type), bssid, a.ssid.c_str(), a.channel, a.rssi, before, after);
+    }
+}
+
+size_t RogueDetector::getAlerts(RogueAlert* out, size_t max) const {
+    uint8_t order[ROGUE_MAX_ALERTS];
+    size_t used = 0;
+    size_t n = 0;
+
+    portENTER_CRITICAL(&mux);
+    // Insertion sort by last raised, newest first; there are only a handful
+    for (uint8_t i = 0; i < ROGUE_MAX_ALERTS; i++) {
+        if (alerts[i].count == 0) continue;
+        size_t j = used++;
+        while (j > 0 && (int32_t)(alerts[order[j - 1]].last - alerts[i].last) < 0) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+    for (; n < used && n < max; n++) out[n] = alerts[order[n]];
+    portEXIT_CRITICAL(&mux);
+    return n;
+}
+
+size_t RogueDetector::getAlertCount() const {
+    size_t n = 0;
+    portENTER_CRITICAL(&mux);
+    for (const auto& a : alerts) {
+        if (a.count) n++;
+    }
+    portEXIT_CRITICAL(&mux);
+    return n;
+}
@@ -0,0 +1,115 @@
+/**
+ * ShitBird Firmware - Rogue AP / Evil-Twin Detector
+ *
+ * Keeps a profile per advertised SSID, found through an open-addressing
+ * index on the pooled SSID id: the vendor OUIs of the BSSIDs sending it and
+ * the strongest security any of them offers. A BSSID joining an SSID from
+ * another vendor, or with weaker security than its peers, raises an alert.
+ * Each known AP's later beacons are checked against what it first sent: a
+ * cleared privacy bit, a new beacon interval or a new DS channel.
+ *
+ * Everything happens as beacons are parsed, with no pass over the AP table.
+ * Repeats of an alert within ROGUE_REPEAT_MS fold into it, so a twin that
+ * clones a BSSID and keeps flapping its channel is one alert with a count.
+ *
+ * addAP()/checkBeacon() are for the parser task and the scan merge, both
+ * under WiFiModule's table lock; removeAP(), poll() and the getters for the
+ * main loop.
+ */
+
+#ifndef SHITBIRD_ROGUE_DETECTOR_H
+#define SHITBIRD_ROGUE_DETECTOR_H
+
+#include <Arduino.h>
+#include <esp_wifi.h>
+#include <freertos/FreeRTOS.h>
+#include "config.h"
+#include "ssid_pool.h"
+#include "../../core/mac_addr.h"
+
+struct APInfo;
+
+enum class RogueAlertType : uint8_t {
+    VENDOR_MISMATCH,       // SSID already sent by a BSSID with another OUI
+    SECURITY_MISMATCH,     // New BSSID offers the SSID with weaker security
+    ENCRYPTION_DOWNGRADE,  // Known AP beaconed with the privacy bit clear
+    INTERVAL_CHANGE,       // Known AP's beacon interval changed
+    CHANNEL_MOVE           // Known AP's DS channel changed
+};
+
+struct RogueAlert {
+    RogueAlertType type;
+    MacAddr bssid;         // The AP that broke the pattern
+    Ssid ssid;
+    uint8_t channel;
+    int8_t rssi;           // Of the latest beacon
+    uint32_t before;       // Expected OUI, auth mode, interval (TU) or channel
+    uint32_t after;        // What the AP showed instead
+    uint32_t first;        // millis()
+    uint32_t last;
+    uint16_t count;        // Occurrences folded into this alert
+};
+
+class RogueDetector {
+public:
+    RogueDetector();
+
+    // A BSSID seen for the first time, or a hidden one whose SSID has just
+    // been revealed; compared with the others advertising the same SSID
+    void addAP(const APInfo& ap, uint32_t now);
+
+    // A later beacon from a known AP. 0 means the field wasn't present. The
+    // AP's interval and channel follow the beacon once the change is flagged.
+    void checkBeacon(APInfo& ap, uint16_t interval, bool privacy, uint8_t dsChannel, uint32_t now);
+
+    // The AP is leaving the table; its SSID's profile goes with the last one
+    void removeAP(const APInfo& ap);
+
+    // Main loop: logs new alerts to SD
+    void poll();
+
+    // Copies up to max alerts, most recent first; returns how many
+    size_t getAlerts(RogueAlert* out, size_t max) const;
+    size_t getAlertCount() const;
+    size_t getSsidCount() const { return profileCount; }
+
+    // clear() forgets the SSID profiles (the AP table was cleared);
+    // reset() also drops the alerts
+    void clear();
+    void reset();
+
+    // Short display forms of an alert and of its before/after values
+    static const char* typeName(RogueAlertType type);
+    static void describe(RogueAlertType type, uint32_t value, char* buf, size_t len);
+
+private:
+    static const uint8_t NONE = 0xFF;
+    static const size_t INDEX_SIZE = ROGUE_MAX_SSIDS * 2;
+
+    struct Profile {
+        Ssid ssid;          // Holds the pool id while it's the key
+        uint32_t ouis[ROGUE_MAX_OUIS];
+        uint8_t ouiCount;
+        wifi_auth_mode_t security;  // Best-secured BSSID's auth mode
+        uint16_t aps;       // BSSIDs currently advertising it
+        bool used;
+    };
+
+    Profile profiles[ROGUE_MAX_SSIDS];
+    uint8_t index[INDEX_SIZE];   // Slot numbers, probed linearly from the id's hash
+    size_t profileCount;
+
+    RogueAlert alerts[ROGUE_MAX_ALERTS];
+    bool pendingLog[ROGUE_MAX_ALERTS];
+    mutable portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+
+    static size_t home(SsidId id) { return (id * 0x9E3779B1u >> 16) & (INDEX_SIZE - 1); }
+    size_t lookup(SsidId id) const;   // Index position holding id, or where it would go
+    Profile* find(SsidId id);
+    Profile* insert(const Ssid& ssid);
+    void removeAt(size_t pos);
+
+    void raise(RogueAlertType type, const APInfo& ap, uint32_t before, uint32_t after, uint32_t now);
+};
+
+#endif // SHITBIRD_ROGUE_DETECTOR_H
@@ -0,0 +1,153 @@
+/**
+ * ShitBird Firmware - Interned SSID Pool Implementation
+ */
+
+#include "ssid_pool.h"
+
+bool SsidPool::ready = false;
+uint16_t SsidPool::capacity = 0;
+SsidPool::Entry* SsidPool::entries = nullptr;
+char* SsidPool::text = nullptr;
+uint16_t* SsidPool::index = nullptr;
+uint16_t SsidPool::indexMask = 0;
+uint16_t* SsidPool::freeIds = nullptr;
+uint16_t SsidPool::freeCount = 0;
+SsidPoolStats SsidPool::stats = {};
+portMUX_TYPE SsidPool::mux = portMUX_INITIALIZER_UNLOCKED;
+
+static uint32_t ssidHash(const uint8_t* data, uint8_t len) {
+    uint32_t h = 2166136261u;  // FNV-1a
+    for (uint8_t i = 0; i < len; i++) {
+        h ^= data[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+bool SsidPool::init() {
+    if (ready) return true;
+
+    uint16_t cap = WIFI_SSID_POOL_SIZE;
+    uint32_t buckets = 16;
+    while (buckets < (uint32_t)cap * 2) buckets <<= 1;
+
+    // One block for everything, so the pool is a single allocation for life
+    size_t entryBytes = (cap + 1) * sizeof(Entry);
+    size_t indexBytes = buckets * sizeof(uint16_t);
+    size_t freeBytes = cap * sizeof(uint16_t);
+    size_t textBytes = (cap + 1) * SSID_POOL_CELL;
+    size_t total = entryBytes + indexBytes + freeBytes + textBytes;
+
+    uint8_t* block = (uint8_t*)(psramFound() ? ps_malloc(total) : malloc(total));
+    if (!block) {
+        Serial.println("[WIFI] Failed to allocate SSID pool");
+        return false;
+    }
+    memset(block, 0, total);
+
+    entries = (Entry*)block;
+    index = (uint16_t*)(block + entryBytes);
+    freeIds = (uint16_t*)(block + entryBytes + indexBytes);
+    text = (char*)(block + entryBytes + indexBytes + freeBytes);
+
+    // Hand out low ids first
+    for (uint16_t i = 0; i < cap; i++) freeIds[i] = cap - i;
+    freeCount = cap;
+    capacity = cap;
+    indexMask = buckets - 1;
+    stats.capacity = cap;
+
+    ready = true;
+    return true;
+}
+
+Ssid SsidPool::intern(const uint8_t* data, uint8_t len) {
+    if (len == 0 || len > 32) return Ssid();
+    if (!ready && !init()) return Ssid();
+
+    uint32_t hash = ssidHash(data, len);
+
+    portENTER_CRITICAL(&mux);
+
+    uint32_t pos = hash & indexMask;
+    while (index[pos] != SSID_NONE) {
+        SsidId id = index[pos];
+        const Entry& e = entries[id];
+        if (e.hash == hash && e.len == len && memcmp(str(id), data, len) == 0) {
+            entries[id].refs++;
+            stats.interned++;
+            portEXIT_CRITICAL(&mux);
+            return Ssid(id);
+        }
+        pos = (pos + 1) & indexMask;
+    }
+
+    if (freeCount == 0) {
+        stats.overflows++;
+        portEXIT_CRITICAL(&mux);
+        return Ssid();
+    }
+
+    SsidId id = freeIds[--freeCount];
+    entries[id].hash = hash;
+    entries[id].refs = 1;
+    entries[id].len = len;
+    memcpy(&text[id * SSID_POOL_CELL], data, len);
+    text[id * SSID_POOL_CELL + len] = '\0';
+    index[pos] = id;
+    stats.entries++;
+    stats.interned++;
+
+    portEXIT_CRITICAL(&mux);
+    return Ssid(id);
+}
+
+Ssid SsidPool::intern(const char* str) {
+    size_t len = str ? strlen(str) : 0;
+    return intern((const uint8_t*)str, len > 32 ? 0 : (uint8_t)len);
+}
+
+SsidPoolStats SsidPool::getStats() {
+    portENTER_CRITICAL(&mux);
+    SsidPoolStats s = stats;
+    portEXIT_CRITICAL(&mux);
+    return s;
+}
+
+void SsidPool::retain(SsidId id) {
+    if (id == SSID_NONE) return;
+    portENTER_CRITICAL(&mux);
+    entries[id].refs++;
+    portEXIT_CRITICAL(&mux);
+}
+
+void SsidPool::release(SsidId id) {
+    if (id == SSID_NONE) return;
+    portENTER_CRITICAL(&mux);
+    if (--entries[id].refs == 0) {
+        removeFromIndex(id);
+        freeIds[freeCount++] = id;
+        stats.entries--;
+    }
+    portEXIT_CRITICAL(&mux);
+}
+
+// Backward-shift deletion, as in MacTable; caller holds the lock
+void SsidPool::removeFromIndex(SsidId id) {
+    uint32_t pos = entries[id].hash & indexMask;
+    while (index[pos] != id) {
+        if (index[pos] == SSID_NONE) return;
+        pos = (pos + 1) & indexMask;
+    }
+
+    uint32_t next = (pos + 1) & indexMask;
+    while (index[next] != SSID_NONE) {
+        uint32_t home = entries[index[next]].hash & indexMask;
+        if (((next - home) & indexMask) >= ((next - pos) & indexMask)) {
+            index[pos] = index[next];
+            pos = next;
+        }
+        next = (next + 1) & indexMask;
+    }
+    index[pos] = SSID_NONE;
+}
@@ -0,0 +1,147 @@
+/**
+ * ShitBird Firmware - Interned SSID Pool
+ *
+ * Each distinct SSID is stored once, in a fixed arena of 33-byte cells (PSRAM
+ * when available), and referred to by a 16-bit id. APs and clients hold Ssid
+ * handles, which count references; a cell is recycled when the last handle
+ * to it goes away. The arena never grows or shrinks after the first intern,
+ * so a long recon session no longer fragments the heap with SSID copies.
+ */
+
+#ifndef SHITBIRD_SSID_POOL_H
+#define SHITBIRD_SSID_POOL_H
+
+#include <Arduino.h>
+#include <utility>
+#include <freertos/FreeRTOS.h>
+#include "config.h"
+
+#define SSID_POOL_CELL  33  // 32-byte SSID + NUL
+
+typedef uint16_t SsidId;
+static const SsidId SSID_NONE = 0;
+
+struct SsidPoolStats {
+    uint16_t entries;    // Distinct SSIDs held
+    uint16_t capacity;
+    uint32_t interned;   // intern() calls that returned an SSID
+    uint32_t overflows;  // intern() calls refused because the pool was full
+};
+
+class Ssid;
+
+class SsidPool {
+public:
+    // Allocates the arena; intern() does this on first use
+    static bool init();
+
+    // Handle to the pooled copy of data[0, len); empty if len is 0 or > 32
+    // or the pool is full
+    static Ssid intern(const uint8_t* data, uint8_t len);
+    static Ssid intern(const char* str);
+
+    static SsidPoolStats getStats();
+
+private:
+    friend class Ssid;
+
+    struct Entry {
+        uint32_t hash;
+        uint16_t refs;
+        uint8_t len;
+    };
+
+    static bool ready;
+    static uint16_t capacity;
+    static Entry* entries;      // Indexed by id; 0 unused
+    static char* text;          // SSID_POOL_CELL bytes per id, NUL-terminated
+    static uint16_t* index;     // Power-of-two bucket array of ids
+    static uint16_t indexMask;
+    static uint16_t* freeIds;
+    static uint16_t freeCount;
+    static SsidPoolStats stats;
+    static portMUX_TYPE mux;
+
+    static void retain(SsidId id);
+    static void release(SsidId id);
+    static void removeFromIndex(SsidId id);
+    static const char* str(SsidId id) { return id ? &text[id * SSID_POOL_CELL] : ""; }
+    static uint8_t length(SsidId id) { return id ? entries[id].len : 0; }
+};
+
+// Counted reference to a pooled SSID; an empty Ssid is an unknown or hidden one
+class Ssid {
+public:
+    Ssid() : id(SSID_NONE) {}
+    Ssid(const Ssid& other) : id(other.id) { SsidPool::retain(id); }
+    Ssid(Ssid&& other) : id(other.id) { other.id = SSID_NONE; }
+    ~Ssid() { SsidPool::release(id); }
+
+    Ssid& operator=(const Ssid& other) {
+        SsidPool::retain(other.id);
+        SsidPool::release(id);
+        id = other.id;
+        return *this;
+    }
+    Ssid& operator=(Ssid&& other) {
+        if (this != &other) {
+            SsidPool::release(id);
+            id = other.id;
+            other.id = SSID_NONE;
+        }
+        return *this;
+    }
+
+    // Valid while this handle lives
+    const char* c_str() const { return SsidPool::str(id); }
+    uint8_t length() const { return SsidPool::length(id); }
+    bool isEmpty() const { return id == SSID_NONE; }
+    SsidId getId() const { return id; }
+    String toString() const { return String(c_str()); }
+
+    // Same text, same id
+    bool operator==(const Ssid& other) const { return id == other.id; }
+    bool operator!=(const Ssid& other) const { return id != other.id; }
+
+private:
+    friend class SsidPool;
+    explicit Ssid(SsidId id) : id(id) {}  // Takes over a reference
+    SsidId id;
+};
+
+// Small inline set of SSIDs (a client's probe list). When full, the oldest
+// entry makes room for the newest.
+class SsidSet {
+public:
+    SsidSet() : count(0) {}
+
+    // False if already present
+    bool add(const Ssid& ssid) {
+        if (ssid.isEmpty() || contains(ssid)) return false;
+        if (count == WIFI_MAX_PROBED_SSIDS) {
+            for (uint8_t i = 1; i < count; i++) items[i - 1] = std::move(items[i]);
+            count--;
+        }
+        items[count++] = ssid;
+        return true;
+    }
+
+    bool contains(const Ssid& ssid) const {
+        for (uint8_t i = 0; i < count; i++) {
+            if (items[i] == ssid) return true;
+        }
+        return false;
+    }
+
+    uint8_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const Ssid& operator[](uint8_t i) const { return items[i]; }
+    const Ssid* begin() const { return items; }
+    const Ssid* end() const { return items + count; }
+
+private:
+    Ssid items[WIFI_MAX_PROBED_SSIDS];
+    uint8_t count;
+};
+
+#endif // SHITBIRD_SSID_POOL_H
@@ -0,0 +1,213 @@
+/**
+ * ShitBird Firmware - 802.11 Information Element Decoding
+ */
+
+#include "wifi_ie.h"
+
+namespace {
+
+const uint8_t OUI_IEEE[3] = {0x00, 0x0F, 0xAC};
+const uint8_t OUI_MICROSOFT[3] = {0x00, 0x50, 0xF2};
+
+// WPS attribute types (big-endian TLVs)
+const uint16_t WPS_ATTR_STATE = 0x1044;
+const uint16_t WPS_ATTR_AP_LOCKED = 0x1057;
+
+uint16_t le16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+uint16_t be16(const uint8_t* p) { return (p[0] << 8) | p[1]; }
+
+uint8_t cipherBit(const uint8_t* suite, const uint8_t* oui) {
+    if (memcmp(suite, oui, 3) != 0) return WiFiIE::CIPHER_OTHER;
+    switch (suite[3]) {
+        case 1: case 5: return WiFiIE::CIPHER_WEP;
+        case 2:  return WiFiIE::CIPHER_TKIP;
+        case 4:  return WiFiIE::CIPHER_CCMP;
+        case 8:  return WiFiIE::CIPHER_GCMP;
+        case 9:  return WiFiIE::CIPHER_GCMP256;
+        case 10: return WiFiIE::CIPHER_CCMP256;
+        default: return WiFiIE::CIPHER_OTHER;
+    }
+}
+
+uint16_t akmBit(const uint8_t* suite, const uint8_t* oui) {
+    if (memcmp(suite, oui, 3) != 0) return WiFiIE::AKM_OTHER;
+    switch (suite[3]) {
+        case 1:  return WiFiIE::AKM_8021X;
+        case 2:  return WiFiIE::AKM_PSK;
+        case 3:  return WiFiIE::AKM_FT_8021X;
+        case 4:  return WiFiIE::AKM_FT_PSK;
+        case 5:  return WiFiIE::AKM_8021X_SHA256;
+        case 6:  return WiFiIE::AKM_PSK_SHA256;
+        case 8:  case 24: return WiFiIE::AKM_SAE;
+        case 9:  case 25: return WiFiIE::AKM_FT_SAE;
+        case 11: case 12: return WiFiIE::AKM_SUITE_B;
+        case 18: return WiFiIE::AKM_OWE;
+        default: return WiFiIE::AKM_OTHER;
+    }
+}
+
+// Shared layout of the RSN element and the WPA vendor element after its
+// version: group suite, pairwise list, AKM list, then (RSN only) capabilities.
+// Omitted trailing fields take the defaults from 802.11-2020 9.4.2.24.
+void decodeSuites(const uint8_t* p, int len, const uint8_t* oui, WiFiIE::Summary& out, bool rsn) {
+    const uint8_t* end = p + len;
+
+    if (end - p < 4) {
+        out.groupCipher |= WiFiIE::CIPHER_CCMP;
+        out.pairwiseCiphers |= WiFiIE::CIPHER_CCMP;
+        out.akms |= WiFiIE::AKM_8021X;
+        return;
+    }
+    out.groupCipher |= cipherBit(p, oui);
+    p += 4;
+
+    if (end - p < 2) {
+        out.pairwiseCiphers |= WiFiIE::CIPHER_CCMP;
+        out.akms |= WiFiIE::AKM_8021X;
+        return;
+    }
+    uint16_t count = le16(p);
+    p += 2;
+    for (uint16_t i = 0; i < count && end - p >= 4; i++, p += 4) {
+        out.pairwiseCiphers |= cipherBit(p, oui);
+    }
+
+    if (end - p < 2) {
+        out.akms |= WiFiIE::AKM_8021X;
+        return;
+    }
+    count = le16(p);
+    p += 2;
+    for (uint16_t i = 0; i < count && end - p >= 4; i++, p += 4) {
+        out.akms |= akmBit(p, oui);
+    }
+
+    if (rsn && end - p >= 2) {
+        uint16_t caps = le16(p);
+        out.pmfRequired = caps & 0x0040;
+        out.pmfCapable = caps & 0x0080;
+    }
+}
+
+void decodeWPS(const uint8_t* p, int len, WiFiIE::Summary& out) {
+    out.hasWPS = true;
+    const uint8_t* end = p + len;
+    while (end - p >= 4) {
+        uint16_t type = be16(p);
+        uint16_t attrLen = be16(p + 2);
+        p += 4;
+        if (attrLen > end - p) break;
+
+        if (type == WPS_ATTR_STATE && attrLen >= 1) {
+            out.wpsConfigured = (p[0] == 2);
+        } else if (type == WPS_ATTR_AP_LOCKED && attrLen >= 1) {
+            out.wpsLocked = (p[0] != 0);
+        }
+        p += attrLen;
+    }
+}
+
+void decodeVendor(const WiFiIE::Element& ie, WiFiIE::Summary& out) {
+    if (ie.len < 4 || memcmp(ie.data, OUI_MICROSOFT, 3) != 0) return;
+
+    switch (ie.data[3]) {
+        case 1:  // WPA: OUI, type, 2-byte version, then RSN-style suites
+            if (ie.len >= 6) {
+                out.hasWPA = true;
+                decodeSuites(ie.data + 6, ie.len - 6, OUI_MICROSOFT, out, false);
+            }
+            break;
+        case 4:
+            decodeWPS(ie.data + 4, ie.len - 4, out);
+            break;
+    }
+}
+
+} // namespace
+
+bool WiFiIE::decode(const uint8_t* data, int len, Summary& out) {
+    memset(&out, 0, sizeof(out));
+
+    Iterator it(data, len);
+    Element ie;
+    while (it.next(ie)) {
+        switch (ie.id) {
+            case ID_SSID:
+                if (!out.hasSsid && ie.len <= 32) {
+                    out.ssid = ie.data;
+                    out.ssidLen = ie.len;
+                    out.hasSsid = true;
+                }
+                break;
+
+            case ID_DS_PARAMS:
+                if (ie.len >= 1) out.dsChannel = ie.data[0];
+                break;
+
+            case ID_COUNTRY:
+                if (ie.len >= 2) {
+                    out.country[0] = ie.data[0];
+                    out.country[1] = ie.data[1];
+                }
+                break;
+
+            case ID_HT_CAP:
+                out.phy |= PHY_HT;
+                // Supported MCS set starts at byte 3; one rx bitmask byte per stream
+                if (ie.len >= 7) {
+                    for (int i = 0; i < 4; i++) {
+                        if (ie.data[3 + i]) out.spatialStreams = i + 1;
+                    }
+                }
+                break;
+
+            case ID_HT_OPERATION:
+                if (ie.len >= 1) out.htPrimaryChannel = ie.data[0];
+                break;
+
+            case ID_RSN:
+                // 2-byte version first
+                if (ie.len >= 2) {
+                    out.hasRSN = true;
+                    decodeSuites(ie.data + 2, ie.len - 2, OUI_IEEE, out, true);
+                }
+                break;
+
+            case ID_VHT_CAP:
+            case ID_VHT_OPERATION:
+                out.phy |= PHY_VHT;
+                break;
+
+            case ID_VENDOR:
+                decodeVendor(ie, out);
+                break;
+
+            case ID_EXTENSION:
+                if (ie.extId == EXT_HE_CAP || ie.extId == EXT_HE_OPERATION) {
+                    out.phy |= PHY_HE;
+                }
+                break;
+        }
+    }
+
+    return !it.malformed();
+}
+
+wifi_auth_mode_t WiFiIE::authMode(const Summary& ies, bool privacy) {
+    if (ies.hasRSN) {
+        bool sae = ies.akms & (AKM_SAE | AKM_FT_SAE);
+        bool psk = ies.akms & (AKM_PSK | AKM_FT_PSK | AKM_PSK_SHA256);
+        bool eap = ies.akms & (AKM_8021X | AKM_FT_8021X | AKM_8021X_SHA256 | AKM_SUITE_B);
+
+        if (sae && psk) return WIFI_AUTH_WPA2_WPA3_PSK;
+        if (sae) return WIFI_AUTH_WPA3_PSK;
+        if (eap) return WIFI_AUTH_WPA2_ENTERPRISE;
+        if (psk && ies.hasWPA) return WIFI_AUTH_WPA_WPA2_PSK;
+        if (psk) return WIFI_AUTH_WPA2_PSK;
+        // OWE and unknown AKMs: encrypted, closest IDF 4.4 mode
+        return WIFI_AUTH_WPA2_PSK;
+    }
+    if (ies.hasWPA) return WIFI_AUTH_WPA_PSK;
+    if (privacy) return WIFI_AUTH_WEP;
+    return WIFI_AUTH_OPEN;
+}
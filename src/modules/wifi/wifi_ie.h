@@ -0,0 +1,142 @@
+/**
+ * ShitBird Firmware - 802.11 Information Elements
+ *
+ * Bounds-checked walk over the tagged parameters of management frames and a
+ * decoder for the elements monitor mode cares about. Nothing is copied: every
+ * pointer refers into the frame being parsed.
+ */
+
+#ifndef SHITBIRD_WIFI_IE_H
+#define SHITBIRD_WIFI_IE_H
+
+#include <Arduino.h>
+#include <esp_wifi_types.h>
+
+namespace WiFiIE {
+    // Element IDs
+    const uint8_t ID_SSID          = 0;
+    const uint8_t ID_DS_PARAMS     = 3;
+    const uint8_t ID_COUNTRY       = 7;
+    const uint8_t ID_HT_CAP        = 45;
+    const uint8_t ID_RSN           = 48;
+    const uint8_t ID_HT_OPERATION  = 61;
+    const uint8_t ID_VHT_CAP       = 191;
+    const uint8_t ID_VHT_OPERATION = 192;
+    const uint8_t ID_VENDOR        = 221;
+    const uint8_t ID_EXTENSION     = 255;
+
+    // Extension element IDs (ID_EXTENSION)
+    const uint8_t EXT_HE_CAP       = 35;
+    const uint8_t EXT_HE_OPERATION = 36;
+
+    // Cipher suites, as a bitmask
+    const uint8_t CIPHER_WEP     = 0x01;
+    const uint8_t CIPHER_TKIP    = 0x02;
+    const uint8_t CIPHER_CCMP    = 0x04;
+    const uint8_t CIPHER_GCMP    = 0x08;
+    const uint8_t CIPHER_CCMP256 = 0x10;
+    const uint8_t CIPHER_GCMP256 = 0x20;
+    const uint8_t CIPHER_OTHER   = 0x80;
+
+    // AKM suites, as a bitmask
+    const uint16_t AKM_8021X        = 0x0001;
+    const uint16_t AKM_PSK          = 0x0002;
+    const uint16_t AKM_FT_8021X     = 0x0004;
+    const uint16_t AKM_FT_PSK       = 0x0008;
+    const uint16_t AKM_8021X_SHA256 = 0x0010;
+    const uint16_t AKM_PSK_SHA256   = 0x0020;
+    const uint16_t AKM_SAE          = 0x0040;
+    const uint16_t AKM_FT_SAE       = 0x0080;
+    const uint16_t AKM_SUITE_B      = 0x0100;
+    const uint16_t AKM_OWE          = 0x0200;
+    const uint16_t AKM_OTHER        = 0x8000;
+
+    // PHY generations advertised
+    const uint8_t PHY_HT  = 0x01;  // 802.11n
+    const uint8_t PHY_VHT = 0x02;  // 802.11ac
+    const uint8_t PHY_HE  = 0x04;  // 802.11ax
+
+    struct Element {
+        uint8_t id;
+        uint8_t extId;        // Only for ID_EXTENSION
+        uint8_t len;          // Body length (excluding extId)
+        const uint8_t* data;  // Body (after extId)
+    };
+
+    class Iterator {
+    public:
+        Iterator(const uint8_t* data, int len)
+            : pos(data), end(data + (len > 0 ? len : 0)), overrun(false) {}
+
+        // False once the elements run out or one would read past the buffer
+        bool next(Element& ie) {
+            if (end - pos < 2) return false;
+            uint8_t id = pos[0];
+            uint8_t len = pos[1];
+            if (len > end - pos - 2) {
+                overrun = true;
+                return false;
+            }
+            ie.id = id;
+            ie.data = pos + 2;
+            ie.len = len;
+            ie.extId = 0;
+            if (id == ID_EXTENSION && len > 0) {
+                ie.extId = ie.data[0];
+                ie.data++;
+                ie.len--;
+            }
+            pos += 2 + len;
+            return true;
+        }
+
+        // Stopped on an element whose length overran the frame
+        bool malformed() const { return overrun; }
+
+    private:
+        const uint8_t* pos;
+        const uint8_t* end;
+        bool overrun;
+    };
+
+    // What the elements of one beacon/probe say about the sender
+    struct Summary {
+        const uint8_t* ssid;  // Points into the frame, not terminated
+        uint8_t ssidLen;
+        bool hasSsid;
+        uint8_t dsChannel;    // 0 if no DS Parameter Set
+        uint8_t htPrimaryChannel;
+
+        bool hasRSN;
+        bool hasWPA;          // Legacy WPA vendor element
+        uint16_t akms;
+        uint8_t pairwiseCiphers;
+        uint8_t groupCipher;
+        bool pmfCapable;
+        bool pmfRequired;
+
+        bool hasWPS;
+        bool wpsConfigured;
+        bool wpsLocked;
+
+        uint8_t phy;
+        uint8_t spatialStreams;  // From the HT MCS set
+        char country[3];
+
+        // True channel: DS Parameter Set, then HT Operation, then rx channel
+        uint8_t channel(uint8_t rxChannel) const {
+            if (dsChannel) return dsChannel;
+            if (htPrimaryChannel) return htPrimaryChannel;
+            return rxChannel;
+        }
+    };
+
+    // Decodes every element in [data, data + len). Returns false if the list
+    // was malformed; whatever preceded the bad element is still filled in.
+    bool decode(const uint8_t* data, int len, Summary& out);
+
+    // ESP-IDF auth mode for an AP; privacy is capability bit 4
+    wifi_auth_mode_t authMode(const Summary& ies, bool privacy);
+}
+
+#endif // SHITBIRD_WIFI_IE_H
@@ -5,6 +5,10 @@
 #include "wifi_module.h"
 #include "../../core/system.h"
 #include "../../core/storage.h"
+#include "../../core/task_registry.h"
+#include "../../core/capture_session.h"
+#include "../../core/expiry_wheel.h"
+#include "../../core/radio_scheduler.h"
 #include "../../ui/ui_manager.h"
 #include <esp_wifi.h>
 #include <esp_wifi_types.h>
@@ -12,10 +16,12 @@
 // Static member initialization
 bool WiFiModule::initialized = false;
 WiFiOpMode WiFiModule::currentMode = WiFiOpMode::IDLE;
+wifi_scan_config_t WiFiModule::scanConfig = {};
+bool WiFiModule::scanContinuous = false;
+volatile bool WiFiModule::scanDone = false;
+uint32_t WiFiModule::scanSweeps = 0;
 WiFiAttackType WiFiModule::currentAttack = WiFiAttackType::NONE;
 
-std::vector<APInfo> WiFiModule::accessPoints;
-std::vector<ClientInfo> WiFiModule::clients;
 std::vector<WiFiPacket> WiFiModule::capturedPackets;
 std::vector<CapturedCredential> WiFiModule::credentials;
 std::vector<String> WiFiModule::beaconSSIDs;
@@ -32,12 +38,21 @@ uint32_t WiFiModule::deauthCount = 0;
 uint32_t WiFiModule::beaconCount = 0;
 uint32_t WiFiModule::packetCount = 0;
 
-String WiFiModule::targetBSSID = "";
-String WiFiModule::targetClientMAC = "";
+MacAddr WiFiModule::targetBSSID;
+MacAddr WiFiModule::targetClientMAC;
 String WiFiModule::pcapFilename = "";
+PcapWriter WiFiModule::pcapWriter;
 
 TaskHandle_t WiFiModule::attackTaskHandle = nullptr;
 TaskHandle_t WiFiModule::channelHopTaskHandle = nullptr;
+ChannelScheduler WiFiModule::channelScheduler;
+TaskHandle_t WiFiModule::parserTaskHandle = nullptr;
+
+SpscRing<WiFiRxFrame, WIFI_RX_RING_SLOTS> WiFiModule::rxRing;
+volatile uint32_t WiFiModule::rxReceived = 0;
+volatile uint32_t WiFiModule::rxDropped = 0;
+volatile uint32_t WiFiModule::rxTruncated = 0;
+uint32_t WiFiModule::rxHighWater = 0;
 
 // Rickroll SSIDs
 const char* RICKROLL_SSIDS[] = {
@@ -62,9 +77,86 @@ void WiFiModule::init() {
 
     Serial.println("[WIFI] Initializing...");
 
+    SsidPool::init();
+    if (!tableLock) tableLock = xSemaphoreCreateMutex();
+    // Once PSRAM is up; a re-init keeps what was tracked
+    if (!accessPoints.capacity()) {
+        setTableBudget(WIFI_AP_TABLE_BYTES, WIFI_CLIENT_TABLE_BYTES);
+        Serial.printf("[WIFI] Tracking up to %u APs, %u clients\n",
+                      (unsigned)accessPoints.capacity(), (unsigned)clients.capacity());
+    }
+
+    // Tables are keyed by handle, so a timer left over from an erased entry
+    // can't expire a new one that reused the MAC. Expiry runs on the main
+    // loop while the parser task inserts, hence the lock.
+    ExpiryWheel::registerTable(ExpiryTable::WIFI_AP, WIFI_AP_TTL,
+        [](uint64_t key, uint32_t& lastSeen) {
+            lockTables();
+            const APInfo* ap = accessPoints.get((MacHandle)key);
+            if (ap) lastSeen = ap->lastSeen;
+            unlockTables();
+            return ap != nullptr;
+        },
+        [](uint64_t key, uint32_t staleBefore) {
+            lockTables();
+            APInfo* ap = accessPoints.get((MacHandle)key);
+            bool stale = ap && (int32_t)(ap->lastSeen - staleBefore) <= 0;
+            if (stale) {
+                rogueDetector.removeAP(*ap);
+                accessPoints.erase(ap->bssid);
+            }
+            unlockTables();
+            return stale;
+        });
+
+    ExpiryWheel::registerTable(ExpiryTable::WIFI_CLIENT, WIFI_CLIENT_TTL,
+        [](uint64_t key, uint32_t& lastSeen) {
+            lockTables();
+            const ClientInfo* client = clients.get((MacHandle)key);
+            if (client) lastSeen = client->lastSeen;
+            unlockTables();
+            return client != nullptr;
+        },
+        [](uint64_t key, uint32_t staleBefore) {
+            lockTables();
+            ClientInfo* client = clients.get((MacHandle)key);
+            bool stale = client && (int32_t)(client->lastSeen - staleBefore) <= 0;
+            if (stale) clients.erase(client->mac);
+            unlockTables();
+            return stale;
+        });
+
+    ExpiryWheel::registerTable(ExpiryTable::WIFI_ASSOC, WIFI_ASSOC_TTL,
+        [](uint64_t key, uint32_t& lastSeen) {
+            lockTables();
+            const AssocEdge* edge = associations.get((MacHandle)key);
+            if (edge) lastSeen = edge->lastSeen;
+            unlockTables();
+            return edge != nullptr;
+        },
+        [](uint64_t key, uint32_t staleBefore) {
+            lockTables();
+            const AssocEdge* edge = associations.get((MacHandle)key);
+            bool stale = edge && (int32_t)(edge->lastSeen - staleBefore) <= 0;
+            if (stale) {
+                MacAddr bssid = edge->bssid;
+                associations.erase(edge->client, bssid);
+                syncClientCount(bssid);
+            }
+            unlockTables();
+            return stale;
+        });
+
     // Initialize WiFi in station mode first
     WiFi.mode(WIFI_STA);
     WiFi.disconnect();
+    TaskRegistry::adopt(xTaskGetHandle("wifi"), TaskRole::SYSTEM);
+
+    // WIFI_EVENT_SCAN_DONE, after the Arduino core has fetched the records;
+    // the merge itself waits for update()
+    WiFi.onEvent([](arduino_event_id_t, arduino_event_info_t) {
+        scanDone = true;
+    }, ARDUINO_EVENT_WIFI_SCAN_DONE);
 
     // Get MAC address
     uint8_t mac[6];
@@ -80,21 +172,20 @@ void WiFiModule::init() {
 void WiFiModule::update() {
     if (!initialized) return;
 
-    // Update WiFi statistics
-    // Prune old entries (not seen in 120 seconds)
-    uint32_t now = millis();
+    // Stale APs and clients are aged out by ExpiryWheel (WIFI_AP_TTL, WIFI_CLIENT_TTL)
 
-    accessPoints.erase(
-        std::remove_if(accessPoints.begin(), accessPoints.end(),
-            [now](const APInfo& ap) { return (now - ap.lastSeen) > 120000; }),
-        accessPoints.end()
-    );
+    // A sweep finished: fold it into the AP table, then start the next
+    if (scanDone) {
+        scanDone = false;
+        mergeScanResults();
+        if (currentMode == WiFiOpMode::SCANNING && scanContinuous) {
+            esp_wifi_scan_start(&scanConfig, false);
+        }
+    }
 
-    clients.erase(
-        std::remove_if(clients.begin(), clients.end(),
-            [now](const ClientInfo& c) { return (now - c.lastSeen) > 120000; }),
-        clients.end()
-    );
+    // Close quiet WIDS events and log to SD from here, not the parser task
+    deauthDetector.poll(millis());
+    rogueDetector.poll();
 }
 
 void WiFiModule::deinit() {
@@ -106,6 +197,7 @@ void WiFiModule::deinit() {
     stopMonitor();
     stopPcapCapture();
 
+    TaskRegistry::forget(xTaskGetHandle("wifi"));
     WiFi.mode(WIFI_OFF);
     initialized = false;
 }
@@ -114,7 +206,7 @@ void WiFiModule::deinit() {
 // Scanning
 // ============================================================================
 
-void WiFiModule::startScan(bool passive) {
+void WiFiModule::startScan(bool passive, bool continuous) {
     if (currentMode != WiFiOpMode::IDLE) {
         stopScan();
     }
@@ -124,7 +216,7 @@ void WiFiModule::startScan(bool passive) {
     g_systemState.currentMode = OperationMode::WIFI_SCAN;
 
     // Use ESP-IDF scan for more control
-    wifi_scan_config_t scanConfig = {
+    scanConfig = {
         .ssid = nullptr,
         .bssid = nullptr,
         .channel = 0,
@@ -135,7 +227,12 @@ void WiFiModule::startScan(bool passive) {
             .passive = 300
         }
     };
+    scanContinuous = continuous;
+    scanSweeps = 0;
 
+    // Drop a previous scan's leftovers so the first merge is this sweep's
+    WiFi.scanDelete();
+    scanDone = false;
     esp_wifi_scan_start(&scanConfig, false);
 
     // Also enable monitor mode for client detection
@@ -149,7 +246,7 @@ void WiFiModule::stopScan() {
     if (currentMode != WiFiOpMode::SCANNING) return;
 
     Serial.println("[WIFI] Stopping scan...");
-    esp_wifi_scan_stop();
+    esp_wifi_scan_stop();  // Posts SCAN_DONE; update() merges what it got
     stopChannelHop();
     stopMonitor();
 
@@ -158,70 +255,83 @@ void WiFiModule::stopScan() {
         g_systemState.currentMode = OperationMode::IDLE;
     }
 
-    // Get scan results
-    uint16_t apCount = 0;
-    esp_wifi_scan_get_ap_num(&apCount);
-
-    if (apCount > 0) {
-        wifi_ap_record_t* apRecords = new wifi_ap_record_t[apCount];
-        esp_wifi_scan_get_ap_records(&apCount, apRecords);
-
-        for (int i = 0; i < apCount; i++) {
-            APInfo ap;
-            ap.ssid = (char*)apRecords[i].ssid;
-            ap.bssid = macToString(apRecords[i].bssid);
-            ap.rssi = apRecords[i].rssi;
-            ap.channel = apRecords[i].primary;
-            ap.encryption = apRecords[i].authmode;
-            ap.isHidden = (ap.ssid.length() == 0);
-            ap.lastSeen = millis();
-            ap.selected = false;
-
-            ap.hasWPA = (apRecords[i].authmode == WIFI_AUTH_WPA_PSK ||
-                        apRecords[i].authmode == WIFI_AUTH_WPA_WPA2_PSK);
-            ap.hasWPA2 = (apRecords[i].authmode == WIFI_AUTH_WPA2_PSK ||
-                         apRecords[i].authmode == WIFI_AUTH_WPA_WPA2_PSK ||
-                         apRecords[i].authmode == WIFI_AUTH_WPA2_ENTERPRISE);
-            ap.hasWPA3 = (apRecords[i].authmode == WIFI_AUTH_WPA3_PSK);
-
-            // Check if already exists
-            bool found = false;
-            for (auto& existing : accessPoints) {
-                if (existing.bssid == ap.bssid) {
-                    existing = ap;  // Update
-                    found = true;
-                    break;
-                }
-            }
-            if (!found) {
-                accessPoints.push_back(ap);
-            }
+    Storage::logf("wifi", "Scan stopped after %lu sweeps, %d APs, %d clients",
+                  (unsigned long)scanSweeps, accessPoints.size(), clients.size());
+}
+
+// One pass over the sweep's records, straight from the Arduino core's copy:
+// each BSSID is a hash lookup, and nothing is allocated here. Monitor mode
+// stays on through a scan, so the parser task is writing the table too.
+void WiFiModule::mergeScanResults() {
+    int16_t count = WiFi.scanComplete();
+    if (count <= 0) {
+        WiFi.scanDelete();
+        return;
+    }
+
+    uint32_t now = millis();
+    int added = 0;
+    lockTables();
+    for (int16_t i = 0; i < count; i++) {
+        const wifi_ap_record_t* rec = (const wifi_ap_record_t*)WiFi.getScanInfoByIndex(i);
+        if (!rec) continue;
+
+        MacAddr bssid = MacAddr::fromBytes(rec->bssid);
+        Ssid ssid = SsidPool::intern((const char*)rec->ssid);
+
+        // Insert, or refresh what the scan knows without discarding
+        // what monitor mode decoded from the AP's beacons
+        if (accessPoints.full() && !accessPoints.find(bssid) && !evictAP(now)) continue;
+        bool created;
+        APInfo* entry = accessPoints.insert(bssid, &created);
+        if (!entry) continue;
+        if (created) {
+            *entry = APInfo();
+            entry->ssid = ssid;
+            entry->bssid = bssid;
+            entry->isHidden = ssid.isEmpty();
+            entry->selected = false;
+            entry->hasWPA = (rec->authmode == WIFI_AUTH_WPA_PSK ||
+                             rec->authmode == WIFI_AUTH_WPA_WPA2_PSK);
+            entry->hasWPA2 = (rec->authmode == WIFI_AUTH_WPA2_PSK ||
+                              rec->authmode == WIFI_AUTH_WPA_WPA2_PSK ||
+                              rec->authmode == WIFI_AUTH_WPA2_ENTERPRISE);
+            entry->hasWPA3 = (rec->authmode == WIFI_AUTH_WPA3_PSK);
+            entry->clientCount = associations.clientCount(bssid);
+        } else if (!ssid.isEmpty() && entry->ssid != ssid) {
+            rogueDetector.removeAP(*entry);
+            entry->ssid = ssid;
+            entry->isHidden = false;
+            rogueDetector.addAP(*entry, now);
         }
 
-        delete[] apRecords;
+        entry->rssi = rec->rssi;
+        entry->lastSeen = now;
+
+        // A known AP's channel and security are what the rogue checks
+        // compare against, so the scan is checked like a beacon rather
+        // than overwriting them
+        if (created) {
+            entry->channel = rec->primary;
+            entry->encryption = rec->authmode;
+            rogueDetector.addAP(*entry, now);
+            ExpiryWheel::schedule(ExpiryTable::WIFI_AP, accessPoints.findHandle(bssid), now);
+            added++;
+        } else {
+            rogueDetector.checkBeacon(*entry, 0, rec->authmode != WIFI_AUTH_OPEN, rec->primary, now);
+        }
     }
+    unlockTables();
+    WiFi.scanDelete();
 
-    Storage::logf("wifi", "Scan complete, found %d APs, %d clients",
-                  accessPoints.size(), clients.size());
+    scanSweeps++;
+    Serial.printf("[WIFI] Scan sweep %lu: %d APs, %d new\n", (unsigned long)scanSweeps, count, added);
 }
 
 bool WiFiModule::isScanning() {
     return currentMode == WiFiOpMode::SCANNING;
 }
 
-std::vector<APInfo>& WiFiModule::getAccessPoints() {
-    return accessPoints;
-}
-
-std::vector<ClientInfo>& WiFiModule::getClients() {
-    return clients;
-}
-
-void WiFiModule::clearResults() {
-    accessPoints.clear();
-    clients.clear();
-}
-
 // ============================================================================
 // Channel Management
 // ============================================================================
@@ -230,6 +340,7 @@ void WiFiModule::setChannel(uint8_t channel) {
     if (channel < 1 || channel > 14) return;
     currentChannel = channel;
     esp_wifi_set_channel(channel, WIFI_SECOND_CHAN_NONE);
+    if (monitoring) airtime.tune(channel, millis());
 }
 
 uint8_t WiFiModule::getChannel() {
@@ -240,35 +351,39 @@ void WiFiModule::startChannelHop() {
     if (channelHopping) return;
 
     channelHopping = true;
-    xTaskCreatePinnedToCore(
-        channelHopTask,
-        "WiFi_ChanHop",
-        2048,
-        nullptr,
-        1,
-        &channelHopTaskHandle,
-        0
-    );
+    TaskRegistry::spawn(channelHopTask, "WiFi_ChanHop", 2048, nullptr, TaskRole::RADIO, &channelHopTaskHandle);
 }
 
 void WiFiModule::stopChannelHop() {
     if (!channelHopping) return;
 
     channelHopping = false;
-    if (channelHopTaskHandle) {
-        vTaskDelete(channelHopTaskHandle);
-        channelHopTaskHandle = nullptr;
-    }
+    TaskRegistry::kill(channelHopTaskHandle);
+}
+
+bool WiFiModule::isChannelHopping() {
+    return channelHopping;
+}
+
+ChannelScheduler& WiFiModule::getChannelScheduler() {
+    return channelScheduler;
 }
 
+// Dwell times come from the traffic the parser task has counted per channel,
+// and only time RadioScheduler gives WiFi counts towards them
 void WiFiModule::channelHopTask(void* param) {
     while (channelHopping) {
-        for (uint8_t ch = 1; ch <= 13 && channelHopping; ch++) {
-            setChannel(ch);
-            vTaskDelay(pdMS_TO_TICKS(WIFI_CHANNEL_HOP_TIME));
+        uint16_t dwellMs;
+        uint8_t ch = channelScheduler.next(millis(), &dwellMs);
+        if (ch != currentChannel) setChannel(ch);
+
+        uint32_t until = RadioScheduler::wifiAirtime(millis()) + dwellMs;
+        uint32_t airtime;
+        while (channelHopping && (int32_t)(until - (airtime = RadioScheduler::wifiAirtime(millis()))) > 0) {
+            vTaskDelay(pdMS_TO_TICKS(until - airtime));
         }
     }
-    vTaskDelete(nullptr);
+    TaskRegistry::exit();
 }
 
 // ============================================================================
@@ -276,11 +391,23 @@ void WiFiModule::channelHopTask(void* param) {
 // ============================================================================
 
 void WiFiModule::startMonitor() {
-    if (monitoring) return;
+    // A parser still running would share the single-consumer ring
+    if (monitoring || parserTaskHandle) return;
 
     Serial.println("[WIFI] Starting monitor mode...");
 
     esp_wifi_set_promiscuous(false);
+
+    rxRing.reset();
+    rxReceived = 0;
+    rxDropped = 0;
+    rxTruncated = 0;
+    rxHighWater = 0;
+    monitoring = true;
+    airtime.tune(currentChannel, millis());
+
+    TaskRegistry::spawn(parserTask, "WiFi_Parser", 4096, nullptr, TaskRole::PARSER, &parserTaskHandle);
+
     esp_wifi_set_promiscuous_rx_cb(promiscuousCallback);
     esp_wifi_set_promiscuous(true);
 
@@ -289,8 +416,6 @@ void WiFiModule::startMonitor() {
         .filter_mask = WIFI_PROMIS_FILTER_MASK_MGMT | WIFI_PROMIS_FILTER_MASK_DATA
     };
     esp_wifi_set_promiscuous_filter(&filter);
-
-    monitoring = true;
 }
 
 void WiFiModule::stopMonitor() {
@@ -299,168 +424,123 @@ void WiFiModule::stopMonitor() {
     Serial.println("[WIFI] Stopping monitor mode...");
     esp_wifi_set_promiscuous(false);
     monitoring = false;
+    airtime.tune(0, millis());
+
+    // Let the parser finish its current frame and exit on its own. It can
+    // be waiting on tableLock behind a scan merge, so wait for it however
+    // long that takes: a restart must not find it still running.
+    if (parserTaskHandle) {
+        xTaskNotifyGive(parserTaskHandle);
+        while (parserTaskHandle) {
+            vTaskDelay(pdMS_TO_TICKS(10));
+        }
+    }
+
+    if (rxDropped > 0) {
+        Storage::logf("wifi", "Monitor stopped: %lu frames, %lu dropped, ring peak %lu/%d",
+                      (unsigned long)rxReceived, (unsigned long)rxDropped,
+                      (unsigned long)rxHighWater, WIFI_RX_RING_SLOTS);
+    }
 }
 
 bool WiFiModule::isMonitoring() {
     return monitoring;
 }
 
+WiFiRxStats WiFiModule::getRxStats() {
+    WiFiRxStats stats;
+    stats.received = rxReceived;
+    stats.dropped = rxDropped;
+    stats.truncated = rxTruncated;
+    stats.highWater = rxHighWater;
+    return stats;
+}
+
+// Runs in the WiFi driver task: copy into the ring and get out
 void WiFiModule::promiscuousCallback(void* buf, wifi_promiscuous_pkt_type_t type) {
     if (!monitoring) return;
 
     const wifi_promiscuous_pkt_t* pkt = (wifi_promiscuous_pkt_t*)buf;
-    const uint8_t* payload = pkt->payload;
-    int len = pkt->rx_ctrl.sig_len;
+    rxReceived++;
 
-    packetCount++;
-
-    // Write to PCAP if capturing
-    if (pcapCapturing && !pcapFilename.isEmpty()) {
-        writePcapPacket(pkt);
+    WiFiRxFrame* slot = rxRing.acquire();
+    if (!slot) {
+        rxDropped++;
+        return;
     }
 
-    // Parse frame
-    if (type == WIFI_PKT_MGMT) {
-        parseManagementFrame(pkt);
+    // Data frame bodies are only needed when something is recording them
+    uint16_t snapLen = WIFI_RX_SNAPLEN;
+    if (type == WIFI_PKT_DATA && !pcapCapturing && !handshakeCapturing && !CaptureSession::isActive()) {
+        snapLen = WIFI_RX_HEADER_SNAPLEN;
     }
-}
-
-void WiFiModule::parseManagementFrame(const wifi_promiscuous_pkt_t* pkt) {
-    const uint8_t* payload = pkt->payload;
-    int len = pkt->rx_ctrl.sig_len;
-    int rssi = pkt->rx_ctrl.rssi;
-    uint8_t channel = pkt->rx_ctrl.channel;
-
-    if (len < 24) return;
-
-    uint8_t frameType = payload[0] & 0xFC;
 
-    switch (frameType) {
-        case WIFI_MGMT_BEACON:
-            parseBeacon(payload, len, rssi, channel);
-            break;
-        case WIFI_MGMT_PROBE_RESP:
-            parseProbeResponse(payload, len, rssi);
-            break;
-        case WIFI_MGMT_PROBE_REQ:
-            parseProbeRequest(payload, len, rssi);
-            break;
-        case WIFI_MGMT_DEAUTH:
-        case WIFI_MGMT_DISASSOC:
-            parseDeauth(payload, len);
-            break;
+    uint16_t len = pkt->rx_ctrl.sig_len;
+    if (len > snapLen) {
+        if (snapLen == WIFI_RX_SNAPLEN) rxTruncated++;
+        len = snapLen;
     }
-}
 
-void WiFiModule::parseBeacon(const uint8_t* payload, int len, int rssi, uint8_t channel) {
-    // Extract BSSID (bytes 16-21)
-    String bssid = macToString(&payload[16]);
+    slot->type = type;
+    slot->origLen = pkt->rx_ctrl.sig_len;
+    slot->rx_ctrl = pkt->rx_ctrl;
+    slot->rx_ctrl.sig_len = len;
+    memcpy(slot->payload, pkt->payload, len);
+    rxRing.publish();
 
-    // Check if we already have this AP
-    for (auto& ap : accessPoints) {
-        if (ap.bssid == bssid) {
-            ap.lastSeen = millis();
-            ap.rssi = rssi;
-            return;
-        }
+    if (parserTaskHandle) {
+        xTaskNotifyGive(parserTaskHandle);
     }
+}
 
-    // New AP - parse SSID from tagged parameters
-    int tagStart = 36;  // After fixed parameters
-    String ssid = "";
+void WiFiModule::parserTask(void* param) {
+    while (monitoring) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
 
-    while (tagStart < len - 2) {
-        uint8_t tagNumber = payload[tagStart];
-        uint8_t tagLength = payload[tagStart + 1];
+        uint32_t pending = rxRing.size();
+        if (pending > rxHighWater) rxHighWater = pending;
 
-        if (tagStart + 2 + tagLength > len) break;
+        int batch = 0;
+        const WiFiRxFrame* frame;
+        while (monitoring && (frame = rxRing.front()) != nullptr) {
+            processFrame(*frame);
+            rxRing.pop();
 
-        if (tagNumber == 0) {  // SSID
-            ssid = String((char*)&payload[tagStart + 2], tagLength);
-            break;
+            if (++batch >= WIFI_RX_BATCH) {
+                batch = 0;
+                taskYIELD();
+            }
         }
-
-        tagStart += 2 + tagLength;
     }
 
-    APInfo ap;
-    ap.ssid = ssid;
-    ap.bssid = bssid;
-    ap.rssi = rssi;
-    ap.channel = channel;
-    ap.encryption = WIFI_AUTH_OPEN;  // Will be updated by scan
-    ap.isHidden = (ssid.length() == 0);
-    ap.lastSeen = millis();
-    ap.selected = false;
-
-    accessPoints.push_back(ap);
+    parserTaskHandle = nullptr;
+    TaskRegistry::exit();
 }
 
-void WiFiModule::parseProbeResponse(const uint8_t* payload, int len, int rssi) {
-    // Similar to beacon parsing
-    parseBeacon(payload, len, rssi, currentChannel);
-}
-
-void WiFiModule::parseProbeRequest(const uint8_t* payload, int len, int rssi) {
-    if (len < 24) return;
-
-    // Source MAC (transmitter)
-    String clientMac = macToString(&payload[10]);
+void WiFiModule::processFrame(const WiFiRxFrame& frame) {
+    packetCount++;
 
-    // Find or create client entry
-    ClientInfo* client = nullptr;
-    for (auto& c : clients) {
-        if (c.mac == clientMac) {
-            client = &c;
-            break;
-        }
+    // Write to PCAP if capturing
+    if (pcapCapturing) {
+        writePcapPacket(frame);
     }
-
-    if (!client) {
-        ClientInfo newClient;
-        newClient.mac = clientMac;
-        newClient.rssi = rssi;
-        newClient.lastSeen = millis();
-        newClient.probeCount = 0;
-        newClient.selected = false;
-        clients.push_back(newClient);
-        client = &clients.back();
-    }
-
-    client->rssi = rssi;
-    client->lastSeen = millis();
-    client->probeCount++;
-
-    // Extract probed SSID
-    int tagStart = 24;
-    while (tagStart < len - 2) {
-        uint8_t tagNumber = payload[tagStart];
-        uint8_t tagLength = payload[tagStart + 1];
-
-        if (tagStart + 2 + tagLength > len) break;
-
-        if (tagNumber == 0 && tagLength > 0) {  // SSID
-            String ssid((char*)&payload[tagStart + 2], tagLength);
-            bool found = false;
-            for (const auto& s : client->probedSSIDs) {
-                if (s == ssid) {
-                    found = true;
-                    break;
-                }
-            }
-            if (!found && ssid.length() > 0) {
-                client->probedSSIDs.push_back(ssid);
-            }
-            break;
-        }
-
-        tagStart += 2 + tagLength;
+    if (CaptureSession::isActive()) {
+        CaptureSession::writeWiFi(frame.rx_ctrl, frame.payload, frame.origLen);
     }
-}
 
-void WiFiModule::parseDeauth(const uint8_t* payload, int len) {
-    // Log deauth detection for detection mode
-    g_systemState.deauthsSent++;  // Reusing counter for detected deauths
+    // Parse frame; a new AP counts as a discovery for the hop scheduler
+    uint8_t channel = frame.rx_ctrl.channel;
+    channelScheduler.recordFrame(channel);
+    airtime.recordFrame(frame.rx_ctrl, frame.origLen, millis());
+    lockTables();
+    if (frame.type == WIFI_PKT_MGMT) {
+        size_t knownAPs = accessPoints.size();
+        parseManagementFrame(frame.pkt());
+        if (accessPoints.size() > knownAPs) channelScheduler.recordDiscovery(channel);
+    } else if (frame.type == WIFI_PKT_DATA) {
+        parseDataFrame(frame.pkt());
+    }
+    unlockTables();
 }
 
 void WiFiModule::parseEAPOL(const uint8_t* payload, int len) {
@@ -479,44 +559,39 @@ void WiFiModule::parseEAPOL(const uint8_t* payload, int len) {
 // Deauth Attacks
 // ============================================================================
 
-void WiFiModule::startDeauthFlood(const String& bssid) {
+void WiFiModule::startDeauthFlood(const MacAddr& bssid) {
     if (deauthing) stopDeauth();
 
-    Serial.printf("[WIFI] Starting deauth flood on %s\n", bssid.c_str());
+    char bssidStr[18];
+    bssid.format(bssidStr);
+    Serial.printf("[WIFI] Starting deauth flood on %s\n", bssidStr);
 
     targetBSSID = bssid;
-    targetClientMAC = "FF:FF:FF:FF:FF:FF";  // Broadcast
+    targetClientMAC = MacAddr::broadcast();
     deauthing = true;
     deauthCount = 0;
     currentAttack = WiFiAttackType::DEAUTH_FLOOD;
     g_systemState.currentMode = OperationMode::WIFI_ATTACK;
 
     // Find channel for target AP
-    for (const auto& ap : accessPoints) {
-        if (ap.bssid == bssid) {
-            setChannel(ap.channel);
-            break;
-        }
-    }
+    uint8_t channel = 0;
+    lockTables();
+    if (const APInfo* ap = accessPoints.find(bssid)) channel = ap->channel;
+    unlockTables();
+    if (channel) setChannel(channel);
 
-    xTaskCreatePinnedToCore(
-        deauthTask,
-        "WiFi_Deauth",
-        4096,
-        nullptr,
-        2,
-        &attackTaskHandle,
-        1
-    );
+    TaskRegistry::spawn(deauthTask, "WiFi_Deauth", 4096, nullptr, TaskRole::ATTACK, &attackTaskHandle);
 
-    Storage::logf("wifi", "Deauth flood started on %s", bssid.c_str());
+    Storage::logf("wifi", "Deauth flood started on %s", bssidStr);
 }
 
-void WiFiModule::startDeauthTargeted(const String& bssid, const String& clientMac) {
+void WiFiModule::startDeauthTargeted(const MacAddr& bssid, const MacAddr& clientMac) {
     if (deauthing) stopDeauth();
 
-    Serial.printf("[WIFI] Starting targeted deauth: %s -> %s\n",
-                  bssid.c_str(), clientMac.c_str());
+    char bssidStr[18], clientStr[18];
+    bssid.format(bssidStr);
+    clientMac.format(clientStr);
+    Serial.printf("[WIFI] Starting targeted deauth: %s -> %s\n", bssidStr, clientStr);
 
     targetBSSID = bssid;
     targetClientMAC = clientMac;
@@ -525,34 +600,21 @@ void WiFiModule::startDeauthTargeted(const String& bssid, const String& clientMa
     currentAttack = WiFiAttackType::DEAUTH_TARGETED;
     g_systemState.currentMode = OperationMode::WIFI_ATTACK;
 
-    for (const auto& ap : accessPoints) {
-        if (ap.bssid == bssid) {
-            setChannel(ap.channel);
-            break;
-        }
-    }
+    uint8_t channel = 0;
+    lockTables();
+    if (const APInfo* ap = accessPoints.find(bssid)) channel = ap->channel;
+    unlockTables();
+    if (channel) setChannel(channel);
 
-    xTaskCreatePinnedToCore(
-        deauthTask,
-        "WiFi_Deauth",
-        4096,
-        nullptr,
-        2,
-        &attackTaskHandle,
-        1
-    );
+    TaskRegistry::spawn(deauthTask, "WiFi_Deauth", 4096, nullptr, TaskRole::ATTACK, &attackTaskHandle);
 
-    Storage::logf("wifi", "Targeted deauth: %s -> %s", bssid.c_str(), clientMac.c_str());
+    Storage::logf("wifi", "Targeted deauth: %s -> %s", bssidStr, clientStr);
 }
 
 void WiFiModule::startDeauthAll() {
-    // Deauth all selected targets
-    for (auto& ap : accessPoints) {
-        if (ap.selected) {
-            startDeauthFlood(ap.bssid);
-            return;  // One at a time for now
-        }
-    }
+    // Deauth all selected targets; one at a time for now
+    std::vector<MacAddr> selected = getSelectedAPs();
+    if (!selected.empty()) startDeauthFlood(selected[0]);
 }
 
 void WiFiModule::stopDeauth() {
@@ -561,10 +623,7 @@ void WiFiModule::stopDeauth() {
     Serial.println("[WIFI] Stopping deauth");
     deauthing = false;
 
-    if (attackTaskHandle) {
-        vTaskDelete(attackTaskHandle);
-        attackTaskHandle = nullptr;
-    }
+    TaskRegistry::kill(attackTaskHandle);
 
     currentAttack = WiFiAttackType::NONE;
     if (g_systemState.currentMode == OperationMode::WIFI_ATTACK) {
@@ -584,15 +643,15 @@ uint32_t WiFiModule::getDeauthCount() {
 
 void WiFiModule::deauthTask(void* param) {
     uint8_t apMac[6], clientMac[6];
-    stringToMac(targetBSSID, apMac);
-    stringToMac(targetClientMAC, clientMac);
+    targetBSSID.toBytes(apMac);
+    targetClientMAC.toBytes(clientMac);
 
     while (deauthing) {
         // Send deauth from AP to client
         sendDeauthPacket(apMac, clientMac, DEAUTH_REASON_UNSPECIFIED);
 
         // Send deauth from client to AP (if not broadcast)
-        if (targetClientMAC != "FF:FF:FF:FF:FF:FF") {
+        if (!targetClientMAC.isBroadcast()) {
             sendDeauthPacket(clientMac, apMac, DEAUTH_REASON_LEAVING);
         }
 
@@ -602,7 +661,7 @@ void WiFiModule::deauthTask(void* param) {
         vTaskDelay(pdMS_TO_TICKS(g_systemState.settings.wifi.deauthInterval));
     }
 
-    vTaskDelete(nullptr);
+    TaskRegistry::exit();
 }
 
 void WiFiModule::sendDeauthPacket(const uint8_t* ap, const uint8_t* client, uint16_t reason) {
@@ -644,15 +703,7 @@ void WiFiModule::startBeaconSpam(const std::vector<String>& ssids) {
     beaconCount = 0;
     currentAttack = WiFiAttackType::BEACON_SPAM_LIST;
 
-    xTaskCreatePinnedToCore(
-        beaconTask,
-        "WiFi_Beacon",
-        4096,
-        nullptr,
-        1,
-        &attackTaskHandle,
-        1
-    );
+    TaskRegistry::spawn(beaconTask, "WiFi_Beacon", 4096, nullptr, TaskRole::ATTACK, &attackTaskHandle);
 
     Storage::logf("wifi", "Beacon spam started, %d SSIDs", ssids.size());
 }
@@ -677,11 +728,13 @@ void WiFiModule::startBeaconSpamRandom(uint8_t count) {
 void WiFiModule::startBeaconClone() {
     std::vector<String> ssids;
 
+    lockTables();
     for (const auto& ap : accessPoints) {
         if (!ap.isHidden) {
-            ssids.push_back(ap.ssid);
+            ssids.push_back(ap.ssid.toString());
         }
     }
+    unlockTables();
 
     if (ssids.empty()) {
         Serial.println("[WIFI] No APs to clone");
@@ -708,10 +761,7 @@ void WiFiModule::stopBeaconSpam() {
     Serial.println("[WIFI] Stopping beacon spam");
     beaconSpamming = false;
 
-    if (attackTaskHandle) {
-        vTaskDelete(attackTaskHandle);
-        attackTaskHandle = nullptr;
-    }
+    TaskRegistry::kill(attackTaskHandle);
 
     currentAttack = WiFiAttackType::NONE;
     Storage::logf("wifi", "Beacon spam stopped, sent %d beacons", beaconCount);
@@ -751,7 +801,7 @@ void WiFiModule::beaconTask(void* param) {
         }
     }
 
-    vTaskDelete(nullptr);
+    TaskRegistry::exit();
 }
 
 void WiFiModule::sendBeaconPacket(const BeaconInfo& beacon) {
@@ -828,8 +878,8 @@ void WiFiModule::startPcapCapture(const char* filename) {
 
     String path = String(PATH_PCAP) + "/" + filename;
 
-    // Create PCAP file with header
-    if (!Storage::createPcapFile(path.c_str(), PCAP_LINKTYPE_IEEE802_11)) {
+    // Create PCAP file with header; the writer task owns it from here
+    if (!pcapWriter.open(path.c_str(), PCAP_LINKTYPE_IEEE802_11)) {
         Serial.println("[WIFI] Failed to create PCAP file");
         return;
     }
@@ -846,10 +896,14 @@ void WiFiModule::stopPcapCapture() {
     if (!pcapCapturing) return;
 
     pcapCapturing = false;
+    PcapWriterStats stats = pcapWriter.getStats();
+    pcapWriter.close();
     pcapFilename = "";
 
     Serial.printf("[WIFI] PCAP capture stopped, %d packets\n", packetCount);
-    Storage::logf("wifi", "PCAP stopped: %d packets", packetCount);
+    Storage::logf("wifi", "PCAP stopped: %lu packets, %lu dropped, %lu B/s, worst write %lu us",
+                  (unsigned long)stats.packets, (unsigned long)stats.dropped,
+                  (unsigned long)stats.bytesPerSec, (unsigned long)stats.maxWriteUs);
 }
 
 bool WiFiModule::isPcapCapturing() {
@@ -860,94 +914,77 @@ uint32_t WiFiModule::getPcapPacketCount() {
     return packetCount;
 }
 
-void WiFiModule::writePcapPacket(const wifi_promiscuous_pkt_t* pkt) {
-    if (!pcapCapturing || pcapFilename.isEmpty()) return;
-
-    Storage::writePcapPacket(pcapFilename.c_str(), pkt->payload, pkt->rx_ctrl.sig_len);
+PcapWriterStats WiFiModule::getPcapStats() {
+    return pcapWriter.getStats();
 }
 
-// ============================================================================
-// Utility Functions
-// ============================================================================
-
-String WiFiModule::macToString(const uint8_t* mac) {
-    char str[18];
-    snprintf(str, sizeof(str), "%02X:%02X:%02X:%02X:%02X:%02X",
-             mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
-    return String(str);
-}
-
-void WiFiModule::stringToMac(const String& str, uint8_t* mac) {
-    sscanf(str.c_str(), "%hhX:%hhX:%hhX:%hhX:%hhX:%hhX",
-           &mac[0], &mac[1], &mac[2], &mac[3], &mac[4], &mac[5]);
-}
-
-String WiFiModule::getEncryptionString(wifi_auth_mode_t auth) {
-    switch (auth) {
-        case WIFI_AUTH_OPEN: return "Open";
-        case WIFI_AUTH_WEP: return "WEP";
-        case WIFI_AUTH_WPA_PSK: return "WPA";
-        case WIFI_AUTH_WPA2_PSK: return "WPA2";
-        case WIFI_AUTH_WPA_WPA2_PSK: return "WPA/WPA2";
-        case WIFI_AUTH_WPA2_ENTERPRISE: return "WPA2-ENT";
-        case WIFI_AUTH_WPA3_PSK: return "WPA3";
-        default: return "Unknown";
-    }
-}
+void WiFiModule::writePcapPacket(const WiFiRxFrame& frame) {
+    if (!pcapCapturing) return;
 
-String WiFiModule::getVendor(const String& mac) {
-    // TODO: Implement OUI lookup
-    return "Unknown";
+    pcapWriter.writePacket(frame.payload, frame.rx_ctrl.sig_len, frame.origLen);
 }
 
 // ============================================================================
 // Target Selection
 // ============================================================================
 
-void WiFiModule::selectAP(int index, bool selected) {
-    if (index >= 0 && index < accessPoints.size()) {
-        accessPoints[index].selected = selected;
+void WiFiModule::selectAP(MacHandle handle, bool selected) {
+    lockTables();
+    if (APInfo* ap = accessPoints.get(handle)) {
+        ap->selected = selected;
     }
+    unlockTables();
 }
 
-void WiFiModule::selectClient(int index, bool selected) {
-    if (index >= 0 && index < clients.size()) {
-        clients[index].selected = selected;
+void WiFiModule::selectClient(MacHandle handle, bool selected) {
+    lockTables();
+    if (ClientInfo* c = clients.get(handle)) {
+        c->selected = selected;
     }
+    unlockTables();
 }
 
 void WiFiModule::selectAllAPs(bool selected) {
+    lockTables();
     for (auto& ap : accessPoints) {
         ap.selected = selected;
     }
+    unlockTables();
 }
 
 void WiFiModule::clearSelection() {
+    lockTables();
     for (auto& ap : accessPoints) {
         ap.selected = false;
     }
     for (auto& c : clients) {
         c.selected = false;
     }
+    unlockTables();
 }
 
-std::vector<APInfo*> WiFiModule::getSelectedAPs() {
-    std::vector<APInfo*> selected;
-    for (auto& ap : accessPoints) {
+// Addresses, not entries: the parser and expiry move entries once the lock is gone
+std::vector<MacAddr> WiFiModule::getSelectedAPs() {
+    std::vector<MacAddr> selected;
+    lockTables();
+    for (const auto& ap : accessPoints) {
         if (ap.selected) {
-            selected.push_back(&ap);
+            selected.push_back(ap.bssid);
         }
     }
+    unlockTables();
     return selected;
 }
 
-std::vector<ClientInfo*> WiFiModule::getSelectedClients() {
-    std::vector<ClientInfo*> selected;
-    for (auto& c : clients) {
+std::vector<MacAddr> WiFiModule::getSelectedClients() {
+    std::vector<MacAddr> selected;
+    lockTables();
+    for (const auto& c : clients) {
         if (c.selected) {
-            selected.push_back(&c);
+            selected.push_back(c.mac);
         }
     }
+    unlockTables();
     return selected;
 }
 
@@ -968,17 +1005,62 @@ void WiFiModule::buildMenu(void* menuPtr) {
     }));
 
     menu->addItem(MenuItem("View APs", []() {
-        auto& aps = WiFiModule::getAccessPoints();
-        String msg = String(aps.size()) + " networks found";
+        WiFiModule::lockTables();
+        size_t found = WiFiModule::getAccessPoints().size();
+        WiFiModule::unlockTables();
+        String msg = String(found) + " networks found";
         UIManager::showMessage("WiFi", msg);
     }));
 
+    menu->addItem(MenuItem("RX Stats", []() {
+        WiFiRxStats stats = WiFiModule::getRxStats();
+        char msg[40];
+        snprintf(msg, sizeof(msg), "Rx %lu Drop %lu Peak %lu/%d",
+                 (unsigned long)stats.received, (unsigned long)stats.dropped,
+                 (unsigned long)stats.highWater, WIFI_RX_RING_SLOTS);
+        UIManager::showMessage("WiFi RX", msg);
+    }));
+
+    menu->addItem(MenuItem("Channel Hop", []() {
+        if (WiFiModule::isChannelHopping()) {
+            WiFiModule::stopChannelHop();
+            UIManager::showMessage("WiFi", "Channel hop off");
+        } else {
+            WiFiModule::startChannelHop();
+            UIManager::showMessage("WiFi", "Channel hop on");
+        }
+    }));
+
+    menu->addItem(MenuItem("Hop 1/6/11 Only", []() {
+        WiFiModule::getChannelScheduler().pin(CHANNELS_NON_OVERLAP);
+        UIManager::showMessage("WiFi", "Hopping 1/6/11");
+    }));
+
+    menu->addItem(MenuItem("Hop All Channels", []() {
+        WiFiModule::getChannelScheduler().reset();
+        UIManager::showMessage("WiFi", "Hopping 1-13");
+    }));
+
+    menu->addItem(MenuItem("Hop Stats", []() {
+        ChannelScheduler& scheduler = WiFiModule::getChannelScheduler();
+        uint8_t ch = scheduler.getBusiest();
+        if (!ch) {
+            UIManager::showMessage("WiFi", "No hop data yet");
+            return;
+        }
+        const ChannelActivity& a = scheduler.getActivity(ch);
+        char msg[40];
+        snprintf(msg, sizeof(msg), "Busiest ch%u %.0f/s %ums",
+                 ch, a.framesPerSec, a.dwellMs);
+        UIManager::showMessage("WiFi Hop", msg);
+    }));
+
     menu->addItem(MenuItem("Deauth Flood", []() {
         auto selected = WiFiModule::getSelectedAPs();
         if (selected.empty()) {
             UIManager::showMessage("Error", "Select a target first");
         } else {
-            WiFiModule::startDeauthFlood(selected[0]->bssid);
+            WiFiModule::startDeauthFlood(selected[0]);
             UIManager::showMessage("WiFi", "Deauth flood started");
         }
     }));
@@ -1017,6 +1099,118 @@ void WiFiModule::buildMenu(void* menuPtr) {
         WiFiModule::stopPcapCapture();
     }));
 
+    menu->addItem(MenuItem("PCAP Stats", []() {
+        if (!WiFiModule::isPcapCapturing()) {
+            UIManager::showMessage("PCAP", "Not capturing");
+            return;
+        }
+        PcapWriterStats stats = WiFiModule::getPcapStats();
+        char msg[40];
+        snprintf(msg, sizeof(msg), "%luKB/s Drop %lu Max %lums",
+                 (unsigned long)(stats.bytesPerSec / 1024), (unsigned long)stats.dropped,
+                 (unsigned long)(stats.maxWriteUs / 1000));
+        UIManager::showMessage("PCAP", msg);
+    }));
+
+    // Rebuilt on each visit: one row per event, open ones first
+    menu->addItem(MenuItem("WIDS Status", [menu]() {
+        static MenuScreen* widsScreen = new MenuScreen("WIDS", menu);
+        static WidsEvent events[WIDS_MAX_EVENTS];
+        size_t count = WiFiModule::getDeauthDetector().getEvents(events, WIDS_MAX_EVENTS);
+
+        widsScreen->items.clear();
+        if (count == 0) {
+            widsScreen->addItem(MenuItem(WiFiModule::isMonitoring() ? "No events" : "No events (monitor off)", nullptr));
+        }
+        for (size_t i = 0; i < count; i++) {
+            const WidsEvent& e = events[i];
+            const char* kind = e.type == WidsEventType::BSSID_FLOOD ? "AP" :
+                               e.type == WidsEventType::SOURCE_FLOOD ? "SRC" : "CH";
+            char addr[18] = "any";
+            if (e.type != WidsEventType::CHANNEL_FLOOD) e.addr.format(addr);
+
+            char label[48];
+            snprintf(label, sizeof(label), "%s %s %s ch%u", e.active ? "!" : "-", kind, addr, e.channel);
+            widsScreen->addItem(MenuItem(label, [e]() {
+                char msg[40];
+                snprintf(msg, sizeof(msg), "%lu fr pk %u/%us r%u %ddBm",
+                         (unsigned long)e.frames, e.peakRate, WIDS_WINDOW_SECS, e.reason, e.rssi);
+                UIManager::showMessage(e.subtype == WIFI_MGMT_DISASSOC ? "Disassoc" : "Deauth", msg);
+            }));
+        }
+
+        widsScreen->addItem(MenuItem("< Back", nullptr));
+        static_cast<MenuItem&>(widsScreen->items.back()).type = MenuItemType::BACK;
+        UIManager::showScreen(widsScreen);
+    }));
+
+    // Airtime per channel, with the quietest of 1/6/11 highlighted
+    menu->addItem(MenuItem("Channel Usage", []() {
+        if (!WiFiModule::isMonitoring()) {
+            UIManager::showMessage("Channel Usage", "Start a scan first");
+            return;
+        }
+        UIManager::showBarGraph("Channel Usage (% airtime)", [](BarGraphBar* bars, size_t max, String& footer) {
+            uint32_t now = millis();
+            ChannelUtilization usage[AirtimeMonitor::MAX_CHANNEL + 1];
+            WiFiModule::getAirtime().getUtilization(usage, now);
+            uint8_t best = WiFiModule::getAirtime().recommend(CHANNELS_NON_OVERLAP, now);
+
+            size_t count = 0;
+            for (uint8_t ch = 1; ch <= 13 && count < max; ch++, count++) {
+                snprintf(bars[count].label, sizeof(bars[count].label), "%u", ch);
+                bars[count].percent = (uint8_t)(usage[ch].airtimePct + 0.5f);
+                bars[count].highlight = (ch == best);
+            }
+
+            char line[48];
+            if (best) {
+                snprintf(line, sizeof(line), "Best: ch %u (%.0f%% air, %.0f fr/s)",
+                         best, usage[best].airtimePct, usage[best].framesPerSec);
+            } else {
+                snprintf(line, sizeof(line), "Measuring...");
+            }
+            footer = line;
+            return count;
+        });
+    }));
+
+    // Rebuilt on each visit: one row per alert, most recent first
+    menu->addItem(MenuItem("Rogue APs", [menu]() {
+        static MenuScreen* rogueScreen = new MenuScreen("Rogue APs", menu);
+        static RogueAlert alerts[ROGUE_MAX_ALERTS];
+        size_t count = WiFiModule::getRogueDetector().getAlerts(alerts, ROGUE_MAX_ALERTS);
+
+        rogueScreen->items.clear();
+        if (count == 0) {
+            rogueScreen->addItem(MenuItem(WiFiModule::isMonitoring() ? "No alerts" : "No alerts (monitor off)", nullptr));
+        }
+        for (size_t i = 0; i < count; i++) {
+            const RogueAlert& a = alerts[i];
+            char label[64];
+            snprintf(label, sizeof(label), "%s \"%s\" x%u", RogueDetector::typeName(a.type), a.ssid.c_str(), a.count);
+
+            char bssid[18];
+            char msg[40];
+            char before[14];
+            char after[14];
+            a.bssid.format(bssid);
+            RogueDetector::describe(a.type, a.before, before, sizeof(before));
+            RogueDetector::describe(a.type, a.after, after, sizeof(after));
+            snprintf(msg, sizeof(msg), "%s -> %s", before, after);
+
+            String title = bssid;
+            String text = msg;
+            rogueScreen->addItem(MenuItem(label, [title, text]() {
+                UIManager::showMessage(title, text);
+            }));
+        }
+
+        rogueScreen->addItem(MenuItem("< Back", nullptr));
+        static_cast<MenuItem&>(rogueScreen->items.back()).type = MenuItemType::BACK;
+        UIManager::showScreen(rogueScreen);
+    }));
+
     menu->addItem(MenuItem("< Back", nullptr));
     static_cast<MenuItem&>(menu->items.back()).type = MenuItemType::BACK;
 }
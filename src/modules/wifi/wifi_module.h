@@ -11,7 +11,20 @@
 #include <esp_wifi.h>
 #include <vector>
 #include <map>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 #include "config.h"
+#include "../../core/spsc_ring.h"
+#include "../../core/mac_table.h"
+#include "../../core/table_budget.h"
+#include "wifi_ie.h"
+#include "channel_scheduler.h"
+#include "ssid_pool.h"
+#include "association_graph.h"
+#include "deauth_detector.h"
+#include "rogue_detector.h"
+#include "airtime_monitor.h"
+#include "../../core/pcap_writer.h"
 
 // WiFi Attack Types
 enum class WiFiAttackType {
@@ -40,14 +53,15 @@ enum class WiFiOpMode {
 
 // Access Point Info
 struct APInfo {
-    String ssid;
-    String bssid;
+    Ssid ssid;  // Empty while hidden
+    MacAddr bssid;
     int32_t rssi;
     uint8_t channel;
     wifi_auth_mode_t encryption;
+    uint16_t beaconInterval;  // TU; 0 until a beacon is seen
     bool isHidden;
     uint32_t lastSeen;
-    uint16_t clientCount;
+    uint16_t clientCount;  // Distinct stations seen in its data traffic
     bool selected;  // For targeting
 
     // WPA info
@@ -55,6 +69,16 @@ struct APInfo {
     bool hasWPA2;
     bool hasWPA3;
     bool hasWPS;
+    bool wpsLocked;
+
+    // Decoded from beacon elements (see wifi_ie.h for the bit values)
+    uint16_t akms;
+    uint8_t pairwiseCiphers;
+    uint8_t groupCipher;
+    bool pmfRequired;
+    uint8_t phy;
+    uint8_t spatialStreams;
+    char country[3];
 
     // Captured data
     bool pmkidCaptured;
@@ -63,12 +87,12 @@ struct APInfo {
 
 // Client/Station Info
 struct ClientInfo {
-    String mac;
-    String apBssid;  // Associated AP
+    MacAddr mac;
+    MacAddr apBssid;  // AP of its latest data frame; zero until one is seen
     int32_t rssi;
     uint32_t lastSeen;
     uint16_t probeCount;
-    std::vector<String> probedSSIDs;
+    SsidSet probedSSIDs;
     bool selected;
 };
 
@@ -99,6 +123,28 @@ struct WiFiPacket {
     std::vector<uint8_t> data;
 };
 
+// Frame handed from the promiscuous callback to the parser task. rx_ctrl and
+// payload are laid out like wifi_promiscuous_pkt_t so the parsers take it as-is;
+// rx_ctrl.sig_len is the stored length, origLen what came off the air.
+struct WiFiRxFrame {
+    uint8_t type;  // wifi_promiscuous_pkt_type_t
+    uint16_t origLen;
+    wifi_pkt_rx_ctrl_t rx_ctrl;
+    uint8_t payload[WIFI_RX_SNAPLEN];
+
+    const wifi_promiscuous_pkt_t* pkt() const {
+        return reinterpret_cast<const wifi_promiscuous_pkt_t*>(&rx_ctrl);
+    }
+};
+
+// Monitor-mode receive counters
+struct WiFiRxStats {
+    uint32_t received;   // Frames delivered by the driver
+    uint32_t dropped;    // Lost because the ring was full
+    uint32_t truncated;  // Cut to WIFI_RX_SNAPLEN
+    uint32_t highWater;  // Most frames ever waiting in the ring
+};
+
 // Evil Portal Credential
 struct CapturedCredential {
     String ssid;
@@ -115,28 +161,48 @@ public:
     static void update();
     static void deinit();
 
-    // Scanning
-    static void startScan(bool passive = false);
+    // Scanning. Each sweep's results are merged as it completes; a
+    // continuous scan then starts the next one until stopScan().
+    static void startScan(bool passive = false, bool continuous = WIFI_SCAN_CONTINUOUS);
     static void stopScan();
     static bool isScanning();
-    static std::vector<APInfo>& getAccessPoints();
-    static std::vector<ClientInfo>& getClients();
+    static MacTable<APInfo>& getAccessPoints();
+    static MacTable<ClientInfo>& getClients();
+    static AssociationGraph& getAssociations();
+    static DeauthDetector& getDeauthDetector();
+    static RogueDetector& getRogueDetector();
+    static AirtimeMonitor& getAirtime();
     static void clearResults();
 
+    // Held while the AP, client and association tables change: the parser
+    // task, expiry and the scan merge all write them. Take it to walk them
+    // from another task.
+    static void lockTables();
+    static void unlockTables();
+
+    // Drops what's tracked and fixes the AP and client tables at what the
+    // byte budgets hold; 0 lets a table grow freely
+    static void setTableBudget(size_t apBytes, size_t clientBytes);
+    static TableStats getAPTableStats();
+    static TableStats getClientTableStats();
+
     // Channel hopping
     static void setChannel(uint8_t channel);
     static uint8_t getChannel();
     static void startChannelHop();
     static void stopChannelHop();
+    static bool isChannelHopping();
+    static ChannelScheduler& getChannelScheduler();
 
     // Monitor mode
     static void startMonitor();
     static void stopMonitor();
     static bool isMonitoring();
+    static WiFiRxStats getRxStats();
 
     // Deauth attacks
-    static void startDeauthFlood(const String& bssid);
-    static void startDeauthTargeted(const String& bssid, const String& clientMac);
+    static void startDeauthFlood(const MacAddr& bssid);
+    static void startDeauthTargeted(const MacAddr& bssid, const MacAddr& clientMac);
     static void startDeauthAll();  // All selected targets
     static void stopDeauth();
     static bool isDeauthing();
@@ -162,7 +228,7 @@ public:
     static std::vector<CapturedCredential>& getCapturedCredentials();
 
     // Handshake/PMKID capture
-    static void startHandshakeCapture(const String& bssid);
+    static void startHandshakeCapture(const MacAddr& bssid);
     static void stopHandshakeCapture();
     static bool isCapturing();
     static bool hasHandshake();
@@ -173,14 +239,15 @@ public:
     static void stopPcapCapture();
     static bool isPcapCapturing();
     static uint32_t getPcapPacketCount();
+    static PcapWriterStats getPcapStats();
 
     // Target selection
-    static void selectAP(int index, bool selected = true);
-    static void selectClient(int index, bool selected = true);
+    static void selectAP(MacHandle handle, bool selected = true);
+    static void selectClient(MacHandle handle, bool selected = true);
     static void selectAllAPs(bool selected = true);
     static void clearSelection();
-    static std::vector<APInfo*> getSelectedAPs();
-    static std::vector<ClientInfo*> getSelectedClients();
+    static std::vector<MacAddr> getSelectedAPs();       // BSSIDs
+    static std::vector<MacAddr> getSelectedClients();   // Client MACs
 
     // Utility
     static String macToString(const uint8_t* mac);
@@ -188,16 +255,31 @@ public:
     static String getEncryptionString(wifi_auth_mode_t auth);
     static String getVendor(const String& mac);
 
+    // Frame parsing (wifi_parser.cpp, also built by the native benchmark)
+    static void parseManagementFrame(const wifi_promiscuous_pkt_t* pkt);
+    static void parseDataFrame(const wifi_promiscuous_pkt_t* pkt);
+
     // Menu integration
     static void buildMenu(void* menuScreen);
 
 private:
     static bool initialized;
     static WiFiOpMode currentMode;
+    static wifi_scan_config_t scanConfig;
+    static bool scanContinuous;
+    static volatile bool scanDone;   // Set from the event task, merged in update()
+    static uint32_t scanSweeps;
     static WiFiAttackType currentAttack;
 
-    static std::vector<APInfo> accessPoints;
-    static std::vector<ClientInfo> clients;
+    static MacTable<APInfo> accessPoints;
+    static MacTable<ClientInfo> clients;
+    static TableStats apTable;
+    static TableStats clientTable;
+    static AssociationGraph associations;
+    static SemaphoreHandle_t tableLock;
+    static DeauthDetector deauthDetector;
+    static RogueDetector rogueDetector;
+    static AirtimeMonitor airtime;
     static std::vector<WiFiPacket> capturedPackets;
     static std::vector<CapturedCredential> credentials;
     static std::vector<String> beaconSSIDs;
@@ -214,37 +296,57 @@ private:
     static uint32_t beaconCount;
     static uint32_t packetCount;
 
-    static String targetBSSID;
-    static String targetClientMAC;
+    static MacAddr targetBSSID;
+    static MacAddr targetClientMAC;
     static String pcapFilename;
 
     static TaskHandle_t attackTaskHandle;
     static TaskHandle_t channelHopTaskHandle;
-    // pcapFile removed - use Storage class directly
+    static ChannelScheduler channelScheduler;
+    static TaskHandle_t parserTaskHandle;
+
+    // Promiscuous callback -> parser task
+    static SpscRing<WiFiRxFrame, WIFI_RX_RING_SLOTS> rxRing;
+    static volatile uint32_t rxReceived;
+    static volatile uint32_t rxDropped;
+    static volatile uint32_t rxTruncated;
+    static uint32_t rxHighWater;
 
     // Promiscuous mode callback
     static void promiscuousCallback(void* buf, wifi_promiscuous_pkt_type_t type);
 
+    static void mergeScanResults();
+
     // Attack tasks
     static void deauthTask(void* param);
     static void beaconTask(void* param);
     static void channelHopTask(void* param);
 
+    // Drains rxRing off the driver's context
+    static void parserTask(void* param);
+    static void processFrame(const WiFiRxFrame& frame);
+
     // Packet crafting
     static void sendDeauthPacket(const uint8_t* ap, const uint8_t* client, uint16_t reason);
     static void sendBeaconPacket(const BeaconInfo& beacon);
     static void sendProbeRequest(const String& ssid);
 
     // Packet parsing
-    static void parseManagementFrame(const wifi_promiscuous_pkt_t* pkt);
     static void parseBeacon(const uint8_t* payload, int len, int rssi, uint8_t channel);
-    static void parseProbeResponse(const uint8_t* payload, int len, int rssi);
+    static void parseProbeResponse(const uint8_t* payload, int len, int rssi, uint8_t channel);
     static void parseProbeRequest(const uint8_t* payload, int len, int rssi);
-    static void parseDeauth(const uint8_t* payload, int len);
+    static void parseDeauth(const uint8_t* payload, int len, int rssi, uint8_t channel);
     static void parseEAPOL(const uint8_t* payload, int len);
+    static void applySecurity(APInfo& ap, const WiFiIE::Summary& ies, bool privacy);
+    static void syncClientCount(const MacAddr& bssid);
+
+    // Make room in a full table by giving up its least valuable entry
+    static bool evictAP(uint32_t now);
+    static bool evictClient(uint32_t now);
 
     // PCAP writing
-    static void writePcapPacket(const wifi_promiscuous_pkt_t* pkt);
+    static PcapWriter pcapWriter;
+    static void writePcapPacket(const WiFiRxFrame& frame);
 };
 
 // ============================================================================
@@ -276,6 +378,10 @@ extern const int RICKROLL_COUNT;
 #define WIFI_MGMT_DEAUTH        0xC0
 #define WIFI_MGMT_ACTION        0xD0
 
+// Frame control flags (second byte)
+#define WIFI_FC_TO_DS           0x01
+#define WIFI_FC_FROM_DS         0x02
+
 // Deauth reason codes
 #define DEAUTH_REASON_UNSPECIFIED       1
 #define DEAUTH_REASON_PREV_AUTH_INVALID 2
@@ -0,0 +1,408 @@
+/**
+ * ShitBird Firmware - WiFi Frame Parsing
+ *
+ * Hardware-independent half of WiFiModule: 802.11 management and data frame
+ * parsing and the AP/client tables and association graph they populate.
+ * Kept free of driver, task and UI calls so the native environment can
+ * build it against the shims in bench/.
+ */
+
+#include "wifi_module.h"
+#include "wifi_ie.h"
+#include "../../core/system.h"
+#include "../../core/expiry_wheel.h"
+#include "../../core/oui_db.h"
+#include "../../core/wardrive_log.h"
+
+// Tracked network state (populated by the frame parsers)
+MacTable<APInfo> WiFiModule::accessPoints;
+MacTable<ClientInfo> WiFiModule::clients;
+TableStats WiFiModule::apTable = {"APs"};
+TableStats WiFiModule::clientTable = {"Clients"};
+AssociationGraph WiFiModule::associations(WIFI_MAX_ASSOCIATIONS);
+SemaphoreHandle_t WiFiModule::tableLock = nullptr;
+DeauthDetector WiFiModule::deauthDetector;
+RogueDetector WiFiModule::rogueDetector;
+AirtimeMonitor WiFiModule::airtime;
+
+MacTable<APInfo>& WiFiModule::getAccessPoints() {
+    return accessPoints;
+}
+
+MacTable<ClientInfo>& WiFiModule::getClients() {
+    return clients;
+}
+
+AssociationGraph& WiFiModule::getAssociations() {
+    return associations;
+}
+
+DeauthDetector& WiFiModule::getDeauthDetector() {
+    return deauthDetector;
+}
+
+RogueDetector& WiFiModule::getRogueDetector() {
+    return rogueDetector;
+}
+
+AirtimeMonitor& WiFiModule::getAirtime() {
+    return airtime;
+}
+
+// Created by init(); before that nothing else touches the tables
+void WiFiModule::lockTables() {
+    if (tableLock) xSemaphoreTake(tableLock, portMAX_DELAY);
+}
+
+void WiFiModule::unlockTables() {
+    if (tableLock) xSemaphoreGive(tableLock);
+}
+
+void WiFiModule::clearResults() {
+    lockTables();
+    accessPoints.clear();
+    clients.clear();
+    associations.clear();
+    rogueDetector.clear();
+    unlockTables();
+    ExpiryWheel::clear(ExpiryTable::WIFI_AP);
+    ExpiryWheel::clear(ExpiryTable::WIFI_CLIENT);
+    ExpiryWheel::clear(ExpiryTable::WIFI_ASSOC);
+}
+
+void WiFiModule::setTableBudget(size_t apBytes, size_t clientBytes) {
+    clearResults();
+    accessPoints.bound(apBytes / MacTable<APInfo>::entryBytes());
+    clients.bound(clientBytes / MacTable<ClientInfo>::entryBytes());
+    apTable.bytes = apBytes;
+    apTable.capacity = accessPoints.capacity();
+    clientTable.bytes = clientBytes;
+    clientTable.capacity = clients.capacity();
+}
+
+TableStats WiFiModule::getAPTableStats() {
+    TableStats s = apTable;
+    s.size = accessPoints.size();
+    return s;
+}
+
+TableStats WiFiModule::getClientTableStats() {
+    TableStats s = clientTable;
+    s.size = clients.size();
+    return s;
+}
+
+// Caller holds tableLock. Selected targets are never given up.
+bool WiFiModule::evictAP(uint32_t now) {
+    MacHandle victim = accessPoints.leastValuable([now](const APInfo& ap) {
+        return ap.selected ? 0 : evictionCost(ap.rssi, ap.lastSeen, now);
+    });
+    APInfo* ap = accessPoints.get(victim);
+    if (!ap) {
+        apTable.refused++;
+        return false;
+    }
+
+    rogueDetector.removeAP(*ap);
+    ExpiryWheel::cancel(ExpiryTable::WIFI_AP, victim);
+    accessPoints.erase(ap->bssid);
+    apTable.evicted++;
+    return true;
+}
+
+// Caller holds tableLock
+bool WiFiModule::evictClient(uint32_t now) {
+    MacHandle victim = clients.leastValuable([now](const ClientInfo& client) {
+        return client.selected ? 0 : evictionCost(client.rssi, client.lastSeen, now);
+    });
+    ClientInfo* client = clients.get(victim);
+    if (!client) {
+        clientTable.refused++;
+        return false;
+    }
+
+    ExpiryWheel::cancel(ExpiryTable::WIFI_CLIENT, victim);
+    clients.erase(client->mac);
+    clientTable.evicted++;
+    return true;
+}
+
+void WiFiModule::parseManagementFrame(const wifi_promiscuous_pkt_t* pkt) {
+    const uint8_t* payload = pkt->payload;
+    int len = pkt->rx_ctrl.sig_len;
+    int rssi = pkt->rx_ctrl.rssi;
+    uint8_t channel = pkt->rx_ctrl.channel;
+
+    if (len < 24) return;
+
+    uint8_t frameType = payload[0] & 0xFC;
+
+    switch (frameType) {
+        case WIFI_MGMT_BEACON:
+            parseBeacon(payload, len, rssi, channel);
+            break;
+        case WIFI_MGMT_PROBE_RESP:
+            parseProbeResponse(payload, len, rssi, channel);
+            break;
+        case WIFI_MGMT_PROBE_REQ:
+            parseProbeRequest(payload, len, rssi);
+            break;
+        case WIFI_MGMT_DEAUTH:
+        case WIFI_MGMT_DISASSOC:
+            parseDeauth(payload, len, rssi, channel);
+            break;
+    }
+}
+
+// Management frame body offsets; sig_len also counts the 4-byte FCS
+#define MGMT_FIXED_PARAMS_OFFSET    24
+#define BEACON_INTERVAL_OFFSET      32
+#define BEACON_CAPABILITY_OFFSET    34
+#define BEACON_IES_OFFSET           36
+#define FCS_LEN                     4
+
+static bool isHiddenSsid(const WiFiIE::Summary& ies) {
+    if (!ies.hasSsid || ies.ssidLen == 0) return true;
+    // Some APs hide by sending a run of NULs the length of the real SSID
+    for (uint8_t i = 0; i < ies.ssidLen; i++) {
+        if (ies.ssid[i] != 0) return false;
+    }
+    return true;
+}
+
+// Just the DS Parameter Set, for the per-beacon check on known APs; it's
+// normally the third element, so this stops early. 0 if absent (5 GHz).
+static uint8_t dsChannel(const uint8_t* ies, int len) {
+    WiFiIE::Iterator it(ies, len);
+    WiFiIE::Element ie;
+    while (it.next(ie)) {
+        if (ie.id == WiFiIE::ID_DS_PARAMS) return ie.len >= 1 ? ie.data[0] : 0;
+    }
+    return 0;
+}
+
+void WiFiModule::parseBeacon(const uint8_t* payload, int len, int rssi, uint8_t channel) {
+    if (len < BEACON_IES_OFFSET + FCS_LEN) return;
+
+    // Extract BSSID (bytes 16-21)
+    MacAddr bssid = MacAddr::fromBytes(&payload[16]);
+    uint16_t interval = payload[BEACON_INTERVAL_OFFSET] | (payload[BEACON_INTERVAL_OFFSET + 1] << 8);
+    uint16_t capability = payload[BEACON_CAPABILITY_OFFSET] | (payload[BEACON_CAPABILITY_OFFSET + 1] << 8);
+
+    // Check if we already have this AP; only the fields a rogue would
+    // change are re-read, not the whole element list
+    if (APInfo* known = accessPoints.find(bssid)) {
+        known->lastSeen = millis();
+        known->rssi = rssi;
+        rogueDetector.checkBeacon(*known, interval, capability & 0x0010,
+                                  dsChannel(&payload[BEACON_IES_OFFSET], len - BEACON_IES_OFFSET - FCS_LEN),
+                                  known->lastSeen);
+        WardriveLog::observeWiFi(*known);
+        return;
+    }
+
+    // New AP - decode everything it advertises
+    WiFiIE::Summary ies;
+    WiFiIE::decode(&payload[BEACON_IES_OFFSET], len - BEACON_IES_OFFSET - FCS_LEN, ies);
+
+    if (accessPoints.full() && !evictAP(millis())) return;
+    APInfo* ap = accessPoints.insert(bssid);
+    if (!ap) return;
+
+    ap->isHidden = isHiddenSsid(ies);
+    ap->ssid = ap->isHidden ? Ssid() : SsidPool::intern(ies.ssid, ies.ssidLen);
+    ap->bssid = bssid;
+    ap->rssi = rssi;
+    ap->channel = ies.channel(channel);
+    ap->beaconInterval = interval;
+    ap->lastSeen = millis();
+    ap->clientCount = associations.clientCount(bssid);  // Data frames may have come first
+    ap->selected = false;
+    applySecurity(*ap, ies, capability & 0x0010);
+    rogueDetector.addAP(*ap, ap->lastSeen);
+    WardriveLog::observeWiFi(*ap);
+
+    ExpiryWheel::schedule(ExpiryTable::WIFI_AP, accessPoints.findHandle(bssid), ap->lastSeen);
+}
+
+void WiFiModule::parseProbeResponse(const uint8_t* payload, int len, int rssi, uint8_t channel) {
+    if (len < BEACON_IES_OFFSET + FCS_LEN) return;
+
+    // A probe response carries the real SSID of an AP that beacons it hidden
+    APInfo* known = accessPoints.find(MacAddr::fromBytes(&payload[16]));
+    if (known && known->isHidden) {
+        WiFiIE::Summary ies;
+        WiFiIE::decode(&payload[BEACON_IES_OFFSET], len - BEACON_IES_OFFSET - FCS_LEN, ies);
+        if (!isHiddenSsid(ies)) {
+            known->ssid = SsidPool::intern(ies.ssid, ies.ssidLen);
+            known->isHidden = false;
+            rogueDetector.addAP(*known, millis());
+        }
+    }
+
+    // Otherwise same layout as a beacon
+    parseBeacon(payload, len, rssi, channel);
+}
+
+void WiFiModule::applySecurity(APInfo& ap, const WiFiIE::Summary& ies, bool privacy) {
+    ap.encryption = WiFiIE::authMode(ies, privacy);
+    ap.akms = ies.akms;
+    ap.pairwiseCiphers = ies.pairwiseCiphers;
+    ap.groupCipher = ies.groupCipher;
+    ap.pmfRequired = ies.pmfRequired;
+    ap.hasWPA = ies.hasWPA;
+    ap.hasWPA2 = ies.hasRSN && (ies.akms & ~(WiFiIE::AKM_SAE | WiFiIE::AKM_FT_SAE | WiFiIE::AKM_OWE));
+    ap.hasWPA3 = ies.akms & (WiFiIE::AKM_SAE | WiFiIE::AKM_FT_SAE);
+    ap.hasWPS = ies.hasWPS;
+    ap.wpsLocked = ies.wpsLocked;
+    ap.phy = ies.phy;
+    ap.spatialStreams = ies.spatialStreams;
+    memcpy(ap.country, ies.country, sizeof(ap.country));
+}
+
+void WiFiModule::parseProbeRequest(const uint8_t* payload, int len, int rssi) {
+    if (len < MGMT_FIXED_PARAMS_OFFSET + FCS_LEN) return;
+
+    // Source MAC (transmitter)
+    MacAddr clientMac = MacAddr::fromBytes(&payload[10]);
+
+    // Find or create client entry
+    if (clients.full() && !clients.find(clientMac) && !evictClient(millis())) return;
+    bool created;
+    ClientInfo* client = clients.insert(clientMac, &created);
+    if (!client) return;
+
+    if (created) {
+        client->mac = clientMac;
+        client->probeCount = 0;
+        client->selected = false;
+    }
+
+    client->rssi = rssi;
+    client->lastSeen = millis();
+    client->probeCount++;
+
+    if (created) {
+        ExpiryWheel::schedule(ExpiryTable::WIFI_CLIENT, clients.findHandle(clientMac), client->lastSeen);
+    }
+
+    // Extract probed SSID (the first element); wildcard probes have none
+    WiFiIE::Iterator it(&payload[MGMT_FIXED_PARAMS_OFFSET], len - MGMT_FIXED_PARAMS_OFFSET - FCS_LEN);
+    WiFiIE::Element ie;
+    while (it.next(ie)) {
+        if (ie.id != WiFiIE::ID_SSID) continue;
+        if (ie.len == 0 || ie.len > 32) break;
+
+        // Interning dedupes by hash; the set then compares 16-bit ids
+        client->probedSSIDs.add(SsidPool::intern(ie.data, ie.len));
+        break;
+    }
+}
+
+// Data frames name the AP and the station in addr1-3 according to ToDS and
+// FromDS. Only the two infrastructure directions are used: ad-hoc (neither)
+// and WDS (both) frames aren't a station talking to its AP.
+void WiFiModule::parseDataFrame(const wifi_promiscuous_pkt_t* pkt) {
+    const uint8_t* payload = pkt->payload;
+    if (pkt->rx_ctrl.sig_len < 24) return;
+    if ((payload[0] & 0x0C) != 0x08) return;
+
+    uint8_t ds = payload[1] & (WIFI_FC_TO_DS | WIFI_FC_FROM_DS);
+    MacAddr bssid;
+    MacAddr station;
+    if (ds == WIFI_FC_TO_DS) {
+        bssid = MacAddr::fromBytes(&payload[4]);     // addr1
+        station = MacAddr::fromBytes(&payload[10]);  // addr2, transmitter
+    } else if (ds == WIFI_FC_FROM_DS) {
+        station = MacAddr::fromBytes(&payload[4]);   // addr1, receiver
+        bssid = MacAddr::fromBytes(&payload[10]);    // addr2
+    } else {
+        return;
+    }
+
+    // Group-addressed downlink has no single station
+    if (station.isMulticast() || bssid.isMulticast() || station == bssid) return;
+
+    uint32_t now = millis();
+    bool created;
+    if (!associations.record(station, bssid, now, &created)) return;
+
+    if (created) {
+        ExpiryWheel::schedule(ExpiryTable::WIFI_ASSOC, associations.findHandle(station, bssid), now);
+        syncClientCount(bssid);
+    }
+
+    // Only frames the station sent say it's in range, and carry its RSSI
+    if (ds != WIFI_FC_TO_DS) {
+        if (ClientInfo* client = clients.find(station)) client->apBssid = bssid;
+        return;
+    }
+
+    if (clients.full() && !clients.find(station) && !evictClient(now)) return;
+    ClientInfo* client = clients.insert(station, &created);
+    if (!client) return;
+    if (created) {
+        client->mac = station;
+        client->probeCount = 0;
+        client->selected = false;
+    }
+    client->apBssid = bssid;
+    client->rssi = pkt->rx_ctrl.rssi;
+    client->lastSeen = now;
+
+    if (created) {
+        ExpiryWheel::schedule(ExpiryTable::WIFI_CLIENT, clients.findHandle(station), now);
+    }
+}
+
+// APInfo::clientCount mirrors the graph, for APs being tracked
+void WiFiModule::syncClientCount(const MacAddr& bssid) {
+    if (APInfo* ap = accessPoints.find(bssid)) {
+        ap->clientCount = associations.clientCount(bssid);
+    }
+}
+
+void WiFiModule::parseDeauth(const uint8_t* payload, int len, int rssi, uint8_t channel) {
+    if (len < MGMT_FIXED_PARAMS_OFFSET + 2 + FCS_LEN) return;
+
+    g_systemState.deauthsDetected++;
+
+    // Reason code is the whole body of both frames
+    uint16_t reason = payload[MGMT_FIXED_PARAMS_OFFSET] | (payload[MGMT_FIXED_PARAMS_OFFSET + 1] << 8);
+    deauthDetector.record(MacAddr::fromBytes(&payload[16]), MacAddr::fromBytes(&payload[10]),
+                          payload[0] & 0xFC, reason, channel, rssi, millis());
+}
+
+// ============================================================================
+// Utility Functions
+// ============================================================================
+
+String WiFiModule::macToString(const uint8_t* mac) {
+    char str[18];
+    snprintf(str, sizeof(str), "%02X:%02X:%02X:%02X:%02X:%02X",
+             mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+    return String(str);
+}
+
+void WiFiModule::stringToMac(const String& str, uint8_t* mac) {
+    sscanf(str.c_str(), "%hhX:%hhX:%hhX:%hhX:%hhX:%hhX",
+           &mac[0], &mac[1], &mac[2], &mac[3], &mac[4], &mac[5]);
+}
+
+String WiFiModule::getEncryptionString(wifi_auth_mode_t auth) {
+    switch (auth) {
+        case WIFI_AUTH_OPEN: return "Open";
+        case WIFI_AUTH_WEP: return "WEP";
+        case WIFI_AUTH_WPA_PSK: return "WPA";
+        case WIFI_AUTH_WPA2_PSK: return "WPA2";
+        case WIFI_AUTH_WPA_WPA2_PSK: return "WPA/WPA2";
+        case WIFI_AUTH_WPA2_ENTERPRISE: return "WPA2-ENT";
+        case WIFI_AUTH_WPA3_PSK: return "WPA3";
+        default: return "Unknown";
+    }
+}
+
+String WiFiModule::getVendor(const String& mac) {
+    const char* vendor = OuiDb::lookup(MacAddr::fromString(mac));
+    return vendor ? vendor : "Unknown";
+}
@@ -7,6 +7,9 @@
 #include "../core/keyboard.h"
 #include "../core/system.h"
 #include "../core/storage.h"
+#include "../core/capture_session.h"
+#include "../core/radio_scheduler.h"
+#include "../core/task_registry.h"
 #include "config.h"
 
 #if ENABLE_WIFI
@@ -39,6 +42,11 @@ lv_obj_t* UIManager::lvMessageBox = nullptr;
 unsigned long UIManager::lastInputTime = 0;
 bool UIManager::screenSleeping = false;
 
+String UIManager::graphTitle;
+BarGraphSource UIManager::graphSource = nullptr;
+uint16_t UIManager::graphRefreshMs = 1000;
+unsigned long UIManager::lastGraphDraw = 0;
+
 // ============================================================================
 // MenuItem Implementation
 // ============================================================================
@@ -237,6 +245,11 @@ void UIManager::update() {
     // Handle keyboard input
     handleKeyInput();
 
+    // Keep a live graph current
+    if (graphSource && !screenSleeping && millis() - lastGraphDraw >= graphRefreshMs) {
+        drawBarGraph();
+    }
+
     // Check for screen timeout
     checkScreenTimeout();
 }
@@ -260,12 +273,29 @@ void UIManager::handleKeyInput() {
             // TODO: Track key sequence for panic wipe
         }
 
+        // A graph takes the keys while it's up
+        if (graphSource) {
+            if (event.key == KEY_ESC || event.key == KEY_BACKSPACE || event.key == KEY_ENTER) {
+                closeBarGraph();
+            }
+            return;
+        }
+
         // Pass to current screen
         if (currentScreen) {
             currentScreen->handleInput(event.key);
         }
     }
 
+    if (graphSource) {
+        Keyboard::getTrackballY();  // Nothing to scroll
+        if (Keyboard::isTrackballClicked()) {
+            closeBarGraph();
+            lastInputTime = millis();
+        }
+        return;
+    }
+
     // Handle trackball
     int8_t tbY = Keyboard::getTrackballY();
     if (tbY != 0 && currentScreen) {
@@ -492,6 +522,74 @@ void UIManager::showProgress(const String& title, uint8_t percent) {
     tft->print(pctStr);
 }
 
+void UIManager::showBarGraph(const String& title, BarGraphSource source, uint16_t refreshMs) {
+    graphTitle = title;
+    graphSource = source;
+    graphRefreshMs = refreshMs;
+    drawBarGraph();
+}
+
+void UIManager::closeBarGraph() {
+    graphSource = nullptr;
+    if (currentScreen) {
+        currentScreen->draw();
+    }
+}
+
+void UIManager::drawBarGraph() {
+    TFT_eSPI* tft = Display::getTFT();
+    ThemeColors colors = g_systemState.getThemeColors();
+    lastGraphDraw = millis();
+
+    BarGraphBar bars[16];
+    String footer;
+    size_t count = graphSource(bars, 16, footer);
+
+    // Same frame as a menu screen
+    tft->fillRect(0, 22, SCREEN_WIDTH, SCREEN_HEIGHT - 22, colors.bgPrimary);
+    tft->fillRect(0, 22, SCREEN_WIDTH, 20, colors.bgSecondary);
+    tft->setTextColor(colors.accent);
+    tft->setTextSize(1);
+    tft->setCursor(5, 28);
+    tft->print(graphTitle);
+
+    // Bars grow up from the label row, with the value above each
+    int top = 58;
+    int labelY = SCREEN_HEIGHT - 32;
+    int maxH = labelY - 4 - top;
+    int slotW = count ? (SCREEN_WIDTH - 10) / count : 0;
+    int barW = slotW > 6 ? slotW - 4 : slotW;
+
+    for (size_t i = 0; i < count; i++) {
+        const BarGraphBar& bar = bars[i];
+        uint8_t percent = bar.percent > 100 ? 100 : bar.percent;
+        int x = 5 + i * slotW + (slotW - barW) / 2;
+        int h = percent * maxH / 100;
+        uint16_t color = bar.highlight ? colors.success : colors.accent;
+
+        tft->drawRect(x, top, barW, maxH, colors.bgSecondary);
+        if (h > 0) tft->fillRect(x, top + maxH - h, barW, h, color);
+
+        char value[5];
+        snprintf(value, sizeof(value), "%u", percent);
+        tft->setTextColor(colors.textSecondary);
+        tft->setCursor(x + (barW - (int)strlen(value) * 6) / 2, top - 10);
+        tft->print(value);
+
+        tft->setTextColor(bar.highlight ? colors.success : colors.textPrimary);
+        tft->setCursor(x + (barW - (int)strlen(bar.label) * 6) / 2, labelY);
+        tft->print(bar.label);
+    }
+
+    if (footer.length()) {
+        tft->setTextColor(colors.textPrimary);
+        tft->setCursor(5, SCREEN_HEIGHT - 15);
+        tft->print(footer);
+    }
+
+    Display::drawStatusBar();
+}
+
 void UIManager::hideProgress() {
     if (currentScreen) {
         currentScreen->draw();
@@ -644,6 +742,8 @@ void UIManager::buildMainMenu() {
     // RF Menu
     static MenuScreen* rfMenu = new MenuScreen("RF Tools", mainMenu);
     buildRFMenu();
+    RadioScheduler::buildMenu(rfMenu);
+    CaptureSession::buildMenu(rfMenu);
     mainMenu->addItem(MenuItem("RF Tools", rfMenu));
 
     // Settings
@@ -739,6 +839,77 @@ void UIManager::buildSettingsMenu() {
         UIManager::showMessage("System", info, 3000);
     }));
 
+    // Rebuilt on each visit: core, priority and stack headroom per task
+    settingsMenu->addItem(MenuItem("Tasks", []() {
+        static MenuScreen* tasksScreen = new MenuScreen("Tasks", settingsMenu);
+        static TaskInfo tasks[TASK_REGISTRY_SLOTS];
+        size_t count = TaskRegistry::snapshot(tasks, TASK_REGISTRY_SLOTS);
+
+        tasksScreen->items.clear();
+        for (size_t i = 0; i < count; i++) {
+            const TaskInfo& t = tasks[i];
+            char label[48];
+            snprintf(label, sizeof(label), "%s c%d p%u %luB free", t.name, t.core, t.priority,
+                     (unsigned long)t.stackFree);
+
+            char msg[40];
+            if (t.stackSize) {
+                snprintf(msg, sizeof(msg), "%s, %lu/%lu B used", TaskRegistry::roleName(t.role),
+                         (unsigned long)(t.stackSize - t.stackFree), (unsigned long)t.stackSize);
+            } else {
+                snprintf(msg, sizeof(msg), "%s, %lu B never used", TaskRegistry::roleName(t.role),
+                         (unsigned long)t.stackFree);
+            }
+            String title = t.name;
+            String text = msg;
+            tasksScreen->addItem(MenuItem(label, [title, text]() {
+                UIManager::showMessage(title, text);
+            }));
+        }
+
+        tasksScreen->addItem(MenuItem("< Back", nullptr));
+        static_cast<MenuItem&>(tasksScreen->items.back()).type = MenuItemType::BACK;
+        UIManager::showScreen(tasksScreen);
+    }));
+
+    // Rebuilt on each visit: fill and evictions per tracking table
+    settingsMenu->addItem(MenuItem("Tables", []() {
+        static MenuScreen* tablesScreen = new MenuScreen("Tables", settingsMenu);
+        TableStats tables[4];
+        size_t count = 0;
+#if ENABLE_WIFI
+        tables[count++] = WiFiModule::getAPTableStats();
+        tables[count++] = WiFiModule::getClientTableStats();
+#endif
+#if ENABLE_BLE
+        tables[count++] = BLEModule::getDeviceTableStats();
+#endif
+#if ENABLE_LORA
+        tables[count++] = LoRaModule::getNodeTableStats();
+#endif
+
+        tablesScreen->items.clear();
+        for (size_t i = 0; i < count; i++) {
+            const TableStats& t = tables[i];
+            char label[48];
+            snprintf(label, sizeof(label), "%s %lu/%lu", t.name,
+                     (unsigned long)t.size, (unsigned long)t.capacity);
+
+            char msg[40];
+            snprintf(msg, sizeof(msg), "%lu evicted, %lu refused, %luKB",
+                     (unsigned long)t.evicted, (unsigned long)t.refused, (unsigned long)(t.bytes / 1024));
+            String title = t.name;
+            String text = msg;
+            tablesScreen->addItem(MenuItem(label, [title, text]() {
+                UIManager::showMessage(title, text);
+            }));
+        }
+
+        tablesScreen->addItem(MenuItem("< Back", nullptr));
+        static_cast<MenuItem&>(tablesScreen->items.back()).type = MenuItemType::BACK;
+        UIManager::showScreen(tablesScreen);
+    }));
+
     // Reboot
     settingsMenu->addItem(MenuItem("Reboot", []() {
         if (UIManager::showConfirm("Reboot", "Restart device?")) {
@@ -31,6 +31,16 @@ typedef std::function<void()> MenuCallback;
 typedef std::function<bool()> ToggleGetter;
 typedef std::function<void(bool)> ToggleSetter;
 
+// One bar of a live graph
+struct BarGraphBar {
+    char label[4];
+    uint8_t percent;
+    bool highlight;
+};
+
+// Fills up to max bars and an optional footer line; returns the bar count
+typedef std::function<size_t(BarGraphBar* bars, size_t max, String& footer)> BarGraphSource;
+
 // Menu Item class
 class MenuItem {
 public:
@@ -90,6 +100,10 @@ public:
     static bool showConfirm(const String& title, const String& message);
     static String showTextInput(const String& title, const String& defaultValue = "");
 
+    // Live bar graph over the current screen, redrawn from source every
+    // refreshMs until ESC, ENTER or a trackball click. Doesn't block the loop.
+    static void showBarGraph(const String& title, BarGraphSource source, uint16_t refreshMs = 1000);
+
     // Status updates
     static void updateStatusBar();
 
@@ -110,6 +124,11 @@ private:
     static unsigned long lastInputTime;
     static bool screenSleeping;
 
+    static String graphTitle;
+    static BarGraphSource graphSource;  // Set while a graph is showing
+    static uint16_t graphRefreshMs;
+    static unsigned long lastGraphDraw;
+
     static void buildMainMenu();
     static void buildBLEMenu();
     static void buildWiFiMenu();
@@ -125,6 +144,8 @@ private:
 
     static void checkScreenTimeout();
     static void handleKeyInput();
+    static void drawBarGraph();
+    static void closeBarGraph();
 };
 
 #endif // SHITBIRD_UI_MANAGER_H
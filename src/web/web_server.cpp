@@ -5,6 +5,8 @@
 #include "web_server.h"
 #include "../core/system.h"
 #include "../core/storage.h"
+#include "../core/oui_db.h"
+#include "../core/task_registry.h"
 #include "../modules/wifi/wifi_module.h"
 #include "../modules/ble/ble_module.h"
 #include "../modules/lora/lora_module.h"
@@ -189,6 +191,9 @@ void WebServer::setupRoutes() {
     server->on("/api/status", HTTP_GET, handleStatus);
     server->on("/api/wifi/scan", HTTP_GET, handleWiFiScan);
     server->on("/api/wifi/action", HTTP_POST, handleWiFiAction);
+    server->on("/api/wifi/channels", HTTP_GET, handleWiFiChannels);
+    server->on("/api/system/tasks", HTTP_GET, handleTasks);
+    server->on("/api/system/tables", HTTP_GET, handleTables);
     server->on("/api/ble/scan", HTTP_GET, handleBLEScan);
     server->on("/api/ble/action", HTTP_POST, handleBLEAction);
     server->on("/api/lora/action", HTTP_POST, handleLoRaAction);
@@ -234,6 +239,7 @@ void WebServer::handleStatus(AsyncWebServerRequest* request) {
     doc["wifiPackets"] = g_systemState.packetsCapture;
     doc["bleDevices"] = g_systemState.bleDevicesFound;
     doc["deauths"] = g_systemState.deauthsSent;
+    doc["deauthsDetected"] = g_systemState.deauthsDetected;
     doc["beacons"] = g_systemState.beaconsSent;
 
     String response;
@@ -247,15 +253,92 @@ void WebServer::handleWiFiScan(AsyncWebServerRequest* request) {
     StaticJsonDocument<4096> doc;
     JsonArray array = doc.to<JsonArray>();
 
+    // Serialized under the lock too: the SSIDs are borrowed from the pool
+    WiFiModule::lockTables();
     for (const auto& ap : aps) {
         JsonObject obj = array.createNestedObject();
-        obj["ssid"] = ap.ssid;
-        obj["bssid"] = ap.bssid;
+        obj["ssid"] = ap.ssid.c_str();
+        obj["bssid"] = ap.bssid.toString();
+        const char* vendor = OuiDb::lookup(ap.bssid);
+        obj["vendor"] = vendor ? vendor : "Unknown";
         obj["rssi"] = ap.rssi;
         obj["channel"] = ap.channel;
+        obj["clients"] = ap.clientCount;
         obj["encryption"] = WiFiModule::getEncryptionString(ap.encryption);
     }
 
+    String response;
+    serializeJson(doc, response);
+    WiFiModule::unlockTables();
+    request->send(200, "application/json", response);
+}
+
+void WebServer::handleWiFiChannels(AsyncWebServerRequest* request) {
+    uint32_t now = millis();
+    ChannelUtilization usage[AirtimeMonitor::MAX_CHANNEL + 1];
+    WiFiModule::getAirtime().getUtilization(usage, now);
+
+    StaticJsonDocument<2048> doc;
+    doc["window"] = AIRTIME_WINDOW_SECS;
+    doc["monitoring"] = WiFiModule::isMonitoring();
+    doc["recommended"] = WiFiModule::getAirtime().recommend(CHANNELS_NON_OVERLAP, now);
+
+    JsonArray array = doc.createNestedArray("channels");
+    for (uint8_t ch = 1; ch <= AirtimeMonitor::MAX_CHANNEL; ch++) {
+        JsonObject obj = array.createNestedObject();
+        obj["channel"] = ch;
+        obj["listenMs"] = usage[ch].listenMs;
+        obj["framesPerSec"] = usage[ch].framesPerSec;
+        obj["bytesPerSec"] = usage[ch].bytesPerSec;
+        obj["airtime"] = usage[ch].airtimePct;
+    }
+
+    String response;
+    serializeJson(doc, response);
+    request->send(200, "application/json", response);
+}
+
+void WebServer::handleTasks(AsyncWebServerRequest* request) {
+    static TaskInfo tasks[TASK_REGISTRY_SLOTS];
+    size_t count = TaskRegistry::snapshot(tasks, TASK_REGISTRY_SLOTS);
+
+    StaticJsonDocument<2048> doc;
+    JsonArray array = doc.createNestedArray("tasks");
+    for (size_t i = 0; i < count; i++) {
+        JsonObject obj = array.createNestedObject();
+        obj["name"] = tasks[i].name;
+        obj["role"] = TaskRegistry::roleName(tasks[i].role);
+        obj["core"] = tasks[i].core;
+        obj["priority"] = tasks[i].priority;
+        obj["stackSize"] = tasks[i].stackSize;
+        obj["stackFree"] = tasks[i].stackFree;
+    }
+
+    String response;
+    serializeJson(doc, response);
+    request->send(200, "application/json", response);
+}
+
+void WebServer::handleTables(AsyncWebServerRequest* request) {
+    TableStats tables[] = {
+        WiFiModule::getAPTableStats(),
+        WiFiModule::getClientTableStats(),
+        BLEModule::getDeviceTableStats(),
+        LoRaModule::getNodeTableStats()
+    };
+
+    StaticJsonDocument<1024> doc;
+    JsonArray array = doc.createNestedArray("tables");
+    for (const TableStats& t : tables) {
+        JsonObject obj = array.createNestedObject();
+        obj["name"] = t.name;
+        obj["size"] = t.size;
+        obj["capacity"] = t.capacity;
+        obj["bytes"] = t.bytes;
+        obj["evicted"] = t.evicted;
+        obj["refused"] = t.refused;
+    }
+
     String response;
     serializeJson(doc, response);
     request->send(200, "application/json", response);
@@ -274,8 +357,9 @@ void WebServer::handleWiFiAction(AsyncWebServerRequest* request) {
     } else if (action == "deauth") {
         String bssid = request->hasParam("bssid", true) ?
                        request->getParam("bssid", true)->value() : "";
-        if (bssid.length() > 0) {
-            WiFiModule::startDeauthFlood(bssid);
+        MacAddr target = MacAddr::fromString(bssid);
+        if (!target.isZero()) {
+            WiFiModule::startDeauthFlood(target);
         }
     } else if (action == "beacon") {
         WiFiModule::startBeaconSpamRandom();
@@ -294,16 +378,21 @@ void WebServer::handleBLEScan(AsyncWebServerRequest* request) {
     StaticJsonDocument<4096> doc;
     JsonArray array = doc.to<JsonArray>();
 
+    // Serialized under the lock too: names and types are borrowed from the table
+    BLEModule::lockDevices();
     for (const auto& dev : devices) {
         JsonObject obj = array.createNestedObject();
-        obj["address"] = dev.address;
+        obj["address"] = dev.mac().toString();
         obj["name"] = dev.name;
+        const char* vendor = OuiDb::lookup(dev.mac());
+        obj["vendor"] = vendor ? vendor : "Unknown";
         obj["rssi"] = dev.rssi;
         obj["type"] = dev.deviceType;
     }
 
     String response;
     serializeJson(doc, response);
+    BLEModule::unlockDevices();
     request->send(200, "application/json", response);
 }
 
@@ -588,7 +677,7 @@ void WebServer::onWebSocketEvent(AsyncWebSocket* server, AsyncWebSocketClient* c
                 } else if (action == "wifi_deauth") {
                     auto selected = WiFiModule::getSelectedAPs();
                     if (!selected.empty()) {
-                        WiFiModule::startDeauthFlood(selected[0]->bssid);
+                        WiFiModule::startDeauthFlood(selected[0]);
                     }
                 } else if (action == "wifi_beacon") {
                     WiFiModule::startBeaconSpamRandom();
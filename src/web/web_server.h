@@ -67,6 +67,9 @@ private:
     static void handleStatus(AsyncWebServerRequest* request);
     static void handleWiFiScan(AsyncWebServerRequest* request);
     static void handleWiFiAction(AsyncWebServerRequest* request);
+    static void handleWiFiChannels(AsyncWebServerRequest* request);
+    static void handleTasks(AsyncWebServerRequest* request);
+    static void handleTables(AsyncWebServerRequest* request);
     static void handleBLEScan(AsyncWebServerRequest* request);
     static void handleBLEAction(AsyncWebServerRequest* request);
     static void handleLoRaAction(AsyncWebServerRequest* request);
@@ -0,0 +1,211 @@
+#!/usr/bin/env python3
+"""
+ShitBird Firmware - BLE Fingerprint Compiler
+Compiles tools/ble_fingerprints.csv into the sorted rule array and dispatch
+index that src/modules/ble/ble_fingerprint.cpp classifies devices with
+"""
+
+import os
+import sys
+
+RULES_CSV = "ble_fingerprints.csv"
+OUTPUT_NAME = "ble_fingerprint_rules.h"
+
+# Must match src/modules/ble/ble_fingerprint.h
+KEYS = {"company": 0, "service": 1, "appearance": 2, "name": 3}
+KEY_NAMES = ["BLE_FP_KEY_COMPANY", "BLE_FP_KEY_SERVICE", "BLE_FP_KEY_APPEARANCE", "BLE_FP_KEY_NAME"]
+FLAGS = {"apple": 0x01, "samsung": 0x02, "google": 0x04, "microsoft": 0x08, "tracker": 0x10}
+DATA_MAX = 8
+NAME_MAX = 16
+TYPE_MAX = 24
+
+
+class RuleError(Exception):
+    pass
+
+
+def score(key, mask, name):
+    """Same as BLEFingerprintDb::score(): data bits count double a name letter"""
+    bits = sum(bin(m).count("1") for m in mask)
+    return (0 if key == KEYS["name"] else 16) + 2 * bits + 4 * len(name)
+
+
+def parse_hex(text, what):
+    if len(text) % 2:
+        raise RuleError(f"odd number of hex digits in {what}")
+    try:
+        return bytes.fromhex(text)
+    except ValueError:
+        raise RuleError(f"bad hex in {what}")
+
+
+def parse_rule(line):
+    """One CSV line into a rule dict, None for blanks and comments"""
+    if not line.strip() or line.lstrip().startswith("#"):
+        return None
+    fields = line.split(",")
+    if len(fields) != 8:
+        raise RuleError(f"expected 8 fields, got {len(fields)}")
+    key_text, id_text, offset_text, data_text, mask_text, name, flags_text, type_name = fields
+
+    if key_text not in KEYS:
+        raise RuleError(f"unknown key '{key_text}'")
+    key = KEYS[key_text]
+
+    name = name.lower()
+    if len(name) >= NAME_MAX:
+        raise RuleError(f"name prefix longer than {NAME_MAX - 1}")
+    if key == KEYS["name"]:
+        if id_text or not name:
+            raise RuleError("name rules take a name and no id")
+        ident = ord(name[0])
+    else:
+        try:
+            ident = int(id_text, 16)
+        except ValueError:
+            ident = -1
+        if len(id_text) != 4 or ident < 0:
+            raise RuleError(f"id '{id_text}' is not 4 hex digits")
+
+    if offset_text and not offset_text.isdigit():
+        raise RuleError(f"bad offset '{offset_text}'")
+    offset = int(offset_text) if offset_text else 0
+    data = parse_hex(data_text, "data")
+    mask = parse_hex(mask_text, "mask") if mask_text else b"\xFF" * len(data)
+    if len(data) > DATA_MAX or len(mask) != len(data):
+        raise RuleError(f"data must be at most {DATA_MAX} bytes, mask the same length")
+    if data and key not in (KEYS["company"], KEYS["service"]):
+        raise RuleError("only company and service rules match data")
+    if not 0 <= offset + len(data) <= 255:
+        raise RuleError("offset out of range")
+
+    flags = 0
+    for flag in filter(None, flags_text.split("|")):
+        if flag not in FLAGS:
+            raise RuleError(f"unknown flag '{flag}'")
+        flags |= FLAGS[flag]
+
+    if not type_name or len(type_name) >= TYPE_MAX or not type_name.isascii():
+        raise RuleError(f"type must be 1-{TYPE_MAX - 1} ASCII characters")
+
+    return {
+        "key": key, "id": ident, "offset": offset,
+        "data": bytes(d & m for d, m in zip(data, mask)), "mask": mask,
+        "name": name, "flags": flags, "type": type_name,
+        "score": score(key, mask, name),
+    }
+
+
+def read_rules(csv_path):
+    """Rules in file order; raises RuleError naming the bad line"""
+    rules = []
+    with open(csv_path, encoding="ascii") as f:
+        for number, line in enumerate(f, 1):
+            try:
+                rule = parse_rule(line.rstrip("\r\n"))
+            except RuleError as e:
+                raise RuleError(f"{csv_path}:{number}: {e}")
+            if rule:
+                rules.append(rule)
+    return rules
+
+
+def sort_rules(rules):
+    """By key and id, most specific first; stable, as the SD loader sorts"""
+    return sorted(rules, key=lambda r: (r["key"], r["id"], -r["score"]))
+
+
+def build_index(rules):
+    """One (key << 16 | id, first, count) entry per distinct key and id"""
+    index = []
+    for i, rule in enumerate(rules):
+        match = (rule["key"] << 16) | rule["id"]
+        if index and index[-1][0] == match:
+            index[-1][2] += 1
+        else:
+            index.append([match, i, 1])
+    return index
+
+
+def c_bytes(data):
+    return "{" + ", ".join(f"0x{b:02X}" for b in data) + "}" if data else "{0}"
+
+
+def c_string(text):
+    return '"' + text.replace("\\", "\\\\").replace('"', '\\"') + '"'
+
+
+def render(rules, index, source):
+    lines = [
+        f"// Generated by tools/build_ble_fingerprints.py from {source}. Do not edit.",
+        "",
+        "static const BLEFingerprint BLE_FINGERPRINT_RULES[] = {",
+    ]
+    for r in rules:
+        lines.append(
+            f"    {{{KEY_NAMES[r['key']]}, 0x{r['flags']:02X}, 0x{r['id']:04X}, {r['offset']}, "
+            f"{len(r['data'])}, {r['score']}, {c_bytes(r['data'])}, {c_bytes(r['mask'])}, "
+            f"{c_string(r['name'])}, {c_string(r['type'])}}},"
+        )
+    lines += [
+        "};",
+        "",
+        "static const BLEFingerprintIndex BLE_FINGERPRINT_INDEX[] = {",
+    ]
+    for match, first, count in index:
+        lines.append(f"    {{0x{match:06X}, {first}, {count}}},")
+    lines += ["};", ""]
+    return "\n".join(lines)
+
+
+def build(csv_path, output_path):
+    """Compiles csv_path into output_path; False on a bad rule"""
+    try:
+        rules = sort_rules(read_rules(csv_path))
+    except (RuleError, UnicodeDecodeError) as e:
+        print(f"[BLE] Error: {e}")
+        return False
+    if len(rules) > 0xFFFF:
+        print("[BLE] Error: too many fingerprints")
+        return False
+
+    index = build_index(rules)
+    text = render(rules, index, os.path.basename(csv_path))
+
+    # Leave the header alone when nothing changed, so it isn't rebuilt
+    if os.path.exists(output_path):
+        with open(output_path) as f:
+            if f.read() == text:
+                return True
+    os.makedirs(os.path.dirname(output_path) or ".", exist_ok=True)
+    with open(output_path, "w") as f:
+        f.write(text)
+    print(f"[BLE] Compiled {len(rules)} fingerprints, {len(index)} index entries: {output_path}")
+    return True
+
+
+def main(env):
+    """PlatformIO pre-build script entry point"""
+
+    project_dir = env.subst("$PROJECT_DIR")
+    generated_dir = os.path.join(env.subst("$BUILD_DIR"), "generated")
+
+    csv_path = os.path.join(project_dir, "tools", RULES_CSV)
+    if not build(csv_path, os.path.join(generated_dir, OUTPUT_NAME)):
+        env.Exit(1)
+    env.Append(CPPPATH=[generated_dir])
+
+
+# For standalone execution
+if __name__ == "__main__":
+    if len(sys.argv) < 3:
+        print(f"Usage: build_ble_fingerprints.py <{RULES_CSV}> <{OUTPUT_NAME}>")
+        print("")
+        print("Compiles BLE fingerprint rules into the firmware's rule table")
+        sys.exit(1)
+
+    if not build(sys.argv[1], sys.argv[2]):
+        sys.exit(1)
+else:
+    Import("env")  # noqa: F821 - provided by PlatformIO
+    main(env)  # noqa: F821
@@ -0,0 +1,158 @@
+#!/usr/bin/env python3
+"""
+ShitBird Firmware - OUI Database Builder
+Packs the IEEE MA-L registry (oui.csv) into the sorted fixed-stride image
+that src/core/oui_db.cpp maps from the "oui" data partition
+"""
+
+import csv
+import os
+import re
+import struct
+import sys
+import unicodedata
+import urllib.request
+
+OUI_CSV_URL = "https://standards-oui.ieee.org/oui/oui.csv"
+PARTITION_LABEL = "oui"
+
+# Must match OUI_DB_MAGIC / OUI_DB_HEADER_SIZE in src/core/oui_db.h
+MAGIC = 0x3149554F  # "OUI1"
+HEADER_FORMAT = "<IIHHI"
+STRIDE = 24         # 3-byte OUI + 20-char name + NUL
+
+# Dropped from the end of names so more of the useful part fits
+NAME_SUFFIXES = re.compile(
+    r"[\s,.]+(inc|incorporated|corp|corporation|co|company|ltd|limited|llc|"
+    r"gmbh|ag|sa|s\.a|bv|b\.v|ab|oy|srl|s\.r\.l|spa|s\.p\.a|pte|pty|kg|plc|"
+    r"co\.?,?\s*ltd)\.?$",
+    re.IGNORECASE,
+)
+
+
+def clean_name(name):
+    """ASCII-only, whitespace-collapsed, corporate suffixes removed, truncated"""
+    name = unicodedata.normalize("NFKD", name).encode("ascii", "ignore").decode("ascii")
+    name = " ".join(name.split())
+    while True:
+        shorter = NAME_SUFFIXES.sub("", name)
+        if shorter == name or not shorter:
+            break
+        name = shorter
+    return name[:STRIDE - 4].rstrip(" ,.")
+
+
+def read_registry(csv_path):
+    """Returns {oui: name} from an IEEE registry CSV"""
+    vendors = {}
+    with open(csv_path, newline="", encoding="utf-8", errors="replace") as f:
+        for row in csv.DictReader(f):
+            assignment = row.get("Assignment", "").strip()
+            if len(assignment) != 6:
+                continue
+            try:
+                oui = int(assignment, 16)
+            except ValueError:
+                continue
+            name = clean_name(row.get("Organization Name", ""))
+            if name and oui not in vendors:
+                vendors[oui] = name
+    return vendors
+
+
+def pack(vendors):
+    """Header plus records sorted by OUI"""
+    out = bytearray(struct.pack(HEADER_FORMAT, MAGIC, len(vendors), STRIDE, 0, 0))
+    for oui in sorted(vendors):
+        name = vendors[oui].encode("ascii")
+        out += struct.pack(">I", oui)[1:]
+        out += name + b"\x00" * (STRIDE - 3 - len(name))
+    return bytes(out)
+
+
+def find_partition(partitions_csv, label):
+    """(offset, size) of a partition in a partitions.csv, or None"""
+    with open(partitions_csv) as f:
+        for line in f:
+            line = line.split("#", 1)[0].strip()
+            if not line:
+                continue
+            fields = [field.strip() for field in line.split(",")]
+            if len(fields) >= 5 and fields[0] == label:
+                return int(fields[3], 0), int(fields[4], 0)
+    return None
+
+
+def fetch_registry(cache_path):
+    """Downloads oui.csv once; later builds reuse the cached copy"""
+    if os.path.exists(cache_path):
+        return cache_path
+    print(f"[OUI] Downloading {OUI_CSV_URL}")
+    try:
+        os.makedirs(os.path.dirname(cache_path), exist_ok=True)
+        urllib.request.urlretrieve(OUI_CSV_URL, cache_path)
+    except Exception as e:
+        print(f"[OUI] Warning: download failed ({e})")
+        return None
+    return cache_path
+
+
+def build(csv_path, output_path, max_size=None):
+    """Packs csv_path into output_path; False if it would not fit max_size"""
+    image = pack(read_registry(csv_path))
+    if max_size is not None and len(image) > max_size:
+        print(f"[OUI] Error: image is {len(image)} bytes, partition holds {max_size}")
+        return False
+    with open(output_path, "wb") as f:
+        f.write(image)
+    count = (len(image) - struct.calcsize(HEADER_FORMAT)) // STRIDE
+    print(f"[OUI] Packed {count} vendors: {output_path} ({len(image)} bytes)")
+    return True
+
+
+def main(env):
+    """PlatformIO pre-build script entry point"""
+
+    project_dir = env.subst("$PROJECT_DIR")
+    build_dir = env.subst("$BUILD_DIR")
+    partitions_csv = os.path.join(project_dir, env.GetProjectOption("board_build.partitions"))
+
+    partition = find_partition(partitions_csv, PARTITION_LABEL)
+    if partition is None:
+        print(f"[OUI] No '{PARTITION_LABEL}' partition, skipping vendor database")
+        return
+    offset, size = partition
+
+    # A local tools/oui.csv wins over the download, for offline builds
+    csv_path = os.path.join(project_dir, "tools", "oui.csv")
+    if not os.path.exists(csv_path):
+        csv_path = fetch_registry(os.path.join(project_dir, ".pio", "oui.csv"))
+    if csv_path is None:
+        print("[OUI] Warning: no registry, vendor names will show as Unknown")
+        return
+
+    output_path = os.path.join(build_dir, "oui.bin")
+    os.makedirs(build_dir, exist_ok=True)
+    if build(csv_path, output_path, size):
+        # Flashed alongside the app on upload
+        env.Append(FLASH_EXTRA_IMAGES=[(f"0x{offset:X}", output_path)])
+
+
+# For standalone execution
+if __name__ == "__main__":
+    if len(sys.argv) < 3:
+        print("Usage: build_oui.py <oui.csv> <oui.bin>")
+        print("")
+        print("Packs the IEEE MA-L registry into a flashable vendor database")
+        print(f"Registry: {OUI_CSV_URL}")
+        sys.exit(1)
+
+    if not build(sys.argv[1], sys.argv[2]):
+        sys.exit(1)
+else:
+    try:
+        Import("env")  # noqa: F821 - provided by PlatformIO
+    except NameError:
+        pass  # Imported as a module, e.g. by merge_firmware.py
+    else:
+        main(env)  # noqa: F821
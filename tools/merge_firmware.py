@@ -13,7 +13,19 @@ BOOTLOADER_OFFSET = 0x0
 PARTITION_TABLE_OFFSET = 0x8000
 APP_OFFSET = 0x10000
 
-def merge_bin(output_path, bootloader_path, partition_path, app_path, flash_size=16*1024*1024):
+
+def find_oui_offset(tools_dir, partitions_csv):
+    """Offset of the vendor database partition, found the way build_oui.py finds it"""
+    if tools_dir not in sys.path:
+        sys.path.insert(0, tools_dir)
+    from build_oui import find_partition, PARTITION_LABEL
+
+    partition = find_partition(partitions_csv, PARTITION_LABEL)
+    return partition[0] if partition else None
+
+
+def merge_bin(output_path, bootloader_path, partition_path, app_path, flash_size=16*1024*1024,
+              oui_path=None, oui_offset=None):
     """
     Merge ESP32 binaries into a single flashable file
 
@@ -23,6 +35,8 @@ def merge_bin(output_path, bootloader_path, partition_path, app_path, flash_size
         partition_path: Path to partitions.bin
         app_path: Path to firmware.bin (application)
         flash_size: Total flash size in bytes (default 16MB)
+        oui_path: Optional vendor database from build_oui.py
+        oui_offset: Flash offset of its partition (find_oui_offset)
     """
 
     # Create output buffer filled with 0xFF (erased flash state)
@@ -56,6 +70,13 @@ def merge_bin(output_path, bootloader_path, partition_path, app_path, flash_size
         print(f"[Merge] Error: Application not found: {app_path}")
         return False
 
+    # Read and place vendor database
+    if oui_path and oui_offset is not None and os.path.exists(oui_path):
+        with open(oui_path, 'rb') as f:
+            oui = f.read()
+        merged[oui_offset:oui_offset + len(oui)] = oui
+        print(f"[Merge] OUI database: {len(oui)} bytes @ 0x{oui_offset:08X}")
+
     # Calculate actual size needed (trim trailing 0xFF)
     actual_size = len(merged)
     while actual_size > 0 and merged[actual_size - 1] == 0xFF:
@@ -83,6 +104,9 @@ def main(env, target):
     bootloader_path = os.path.join(build_dir, "bootloader.bin")
     partition_path = os.path.join(build_dir, "partitions.bin")
     app_path = os.path.join(build_dir, "firmware.bin")
+    oui_path = os.path.join(build_dir, "oui.bin")
+    partitions_csv = os.path.join(project_dir, env.GetProjectOption("board_build.partitions"))
+    oui_offset = find_oui_offset(os.path.join(project_dir, "tools"), partitions_csv)
     output_path = os.path.join(project_dir, "build", "shitbird_merged.bin")
 
     # Ensure output directory exists
@@ -95,7 +119,8 @@ def main(env, target):
             "tools", "sdk", "esp32s3", "bin", "bootloader_dio_80m.bin"
         )
 
-    if merge_bin(output_path, bootloader_path, partition_path, app_path):
+    if merge_bin(output_path, bootloader_path, partition_path, app_path,
+                 oui_path=oui_path, oui_offset=oui_offset):
         print(f"[ShitBird] Merged firmware created: {output_path}")
     else:
         print(f"[ShitBird] Failed to create merged firmware")